@@ -7,6 +7,14 @@
 #include "structsGenericas.h"
 #include "distancias.h"
 
+// Até onde o ficheiro de passagens já foi lido (é guardado no binário, para o acompanhamento continuar daí)
+typedef struct {
+    char *nome;
+    long posicao; // Byte a seguir à última linha já lida
+    int nLinhas; // Nº de linhas já lidas (para numerar as novas)
+    Dict *entradasAbertas; // Entradas à espera da saída, entre leituras
+} SeguimentoPassagens;
+
 typedef struct Bdados{
     Dict *donosNif;
     Dict *donosAlfabeticamente;
@@ -16,8 +24,12 @@ typedef struct Bdados{
     Lista *sensores;
     Distancias *distancias;
     Lista *viagens;
+    ArenaStrings *strings; // Texto imutável de donos, carros e sensores
+    SeguimentoPassagens *seguimento; // NULL se o ficheiro de passagens não foi lido nesta base de dados
 } Bdados;
 
+extern ArenaStrings *arenaLeituraBin;
+
 
 int inicializarBD(Bdados *bd);
 void freeTudo(Bdados *bd);
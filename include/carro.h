@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 
 #include "dono.h"
 #include "constantes.h"
@@ -13,10 +14,11 @@ struct Bdados;
 
 typedef struct {
     char matricula[MAX_MATRICULA + 1];
-    char *marca;
-    char *modelo;
+    uint16_t idMarca; // Marca internada, ver marcaCarro()
+    uint16_t idModelo; // Modelo internado, ver modeloCarro()
     short ano;
     int codVeiculo; //PRIMARY KEY
+    uint32_t codMatricula; // Matrícula codificada (codificarMatricula), chave de carrosMat
     Dono *ptrPessoa;
     Lista *viagens;
 } Carro;
@@ -29,29 +31,27 @@ void freeCarro(void *carro);
 void printCarro(void *carro, FILE *file);
 void guardarCarroBin(void *carro, FILE *file);
 void *readCarroBin(FILE *file);
-void guardarChaveCarroMarca(void *chaveMarca, FILE *file);
+const char *marcaCarro(const Carro *carro);
+const char *modeloCarro(const Carro *carro);
+void guardarMarcasModelosBin(FILE *file);
+int readMarcasModelosBin(FILE *file);
+void freeMarcasModelos();
+size_t memUsageMarcasModelos();
 void *criarChaveCarroMarca(void *carro);
 int hashChaveCarroMarca(void *chave);
-void freeChaveCarroMarca(void *chave);
 int compChaveCarroMarca(void *chave, void *chave2);
 int compCarroMarca (void *carro1, void *carro2);
 int compCarroMatricula(void *carro1, void *carro2);
+uint32_t chaveOrdenacaoCarroMatricula(void *carro);
 int compCarroModelo(void *carro1, void *carro2);
 void guardarChaveCarroCod(void *chave, FILE *file);
-void *readChaveCarroCod(FILE *file);
 void *criarChaveCarroCod(void *carro);
 int hashChaveCarroCod(void *carro);
-void freeChaveCarroCod(void *chave);
 int compChaveCarroCod(void *chave, void *chave2);
 void *criarChaveCarroMatricula(void *carro);
 int hashChaveCarroMatricula(void *chave);
-void freeChaveCarroMatricula(void *chave);
 int compChaveCarroMatricula(void *chave, void *chave2);
 int compMatCarro(void *carro, void *matricula);
-int compChaveCarroRankingInt(void *chave, void *chave2);
-int compChaveCarroRankingFloat(void *chave, void *chave2);
-void freeChaveCarroRankingInt(void *chave);
-void freeChaveCarroRankingFloat(void *chave);
 void printCarroXML(void *carro, int indentacao, FILE *file);
 void printHeaderCarrosCSV(FILE *file);
 void printCarroCSV(void *carro, FILE *file);
@@ -75,12 +75,9 @@ void printMaisKMS_CSV(void *compInfo, FILE *file);
 void printHeaderCarroMaisKMS_TXT(FILE *file);
 void printHeaderCarroMaisKMS_CSV(FILE *file);
 void printHeaderMarcaMaisKMS(FILE *file);
-char *obterMarcaMaisComum(Dict *carrosMarca);
-char *obterMarcaMaisVelocidadeMedia(struct Bdados *bd);
+const char *obterMarcaMaisComum(Dict *carrosMarca);
+const char *obterMarcaMaisVelocidadeMedia(struct Bdados *bd);
 size_t memUsageCarro(void *carro);
-size_t memUsageChaveCarroCod(void *chave);
-size_t memUsageChaveCarroMarca(void *chave);
-size_t memUsageChaveCarroMatricula(void *chave);
 int obterCodVeiculoNovo(Dict *carrosCod);
 void registarCarro(struct Bdados *bd);
 void mudarDonoCarro(struct Bdados *bd);
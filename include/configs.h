@@ -13,6 +13,8 @@ struct Bdados;
 extern int autosaveON;
 extern int backupsON;
 extern int pausaListagem;
+extern int limiteExemplosLogs;
+extern int timeoutPassagens;
 
 extern char *donosFilename;
 extern char *carrosFilename;
@@ -31,6 +33,9 @@ void colocarTerminalUTF8();
 int faseInstalacao(const char *flag, const char abrir);
 void reset(struct Bdados *bd);
 void setPausaListagem();
+void setNumThreads();
+void setLimiteExemplosLogs();
+void setTimeoutPassagens();
 void setFilenames();
 void setExportacaoFilenames();
 void freeFilenames();
@@ -10,6 +10,8 @@
 #define PAUSA_LISTAGEM 1000
 #define MAX_VELOCIDADE_AE 120
 #define MIN_VELOCIDADE_AE 50
+#define TIMEOUT_PASSAGENS 0 // Minutos que uma entrada espera pela saída do mesmo veículo (0 = sem limite, como antes da opção existir)
+#define INTERVALO_ACOMPANHAMENTO 1000 // Milissegundos entre verificações do ficheiro de passagens a acompanhar
 
 //Nomes default para os ficheiros
 #define LOGS_TXT "logs.txt"
@@ -41,6 +43,13 @@
 #define DOT_HTML ".html"
 #define DOT_BIN ".bin"
 
+//Cabeçalho dos ficheiros binários
+#define MAGICO_BIN "PTGB" // Identifica um ficheiro binário de dados deste programa (4 bytes, sem o '\0')
+#define TAMANHO_MAGICO_BIN 4
+#define VERSAO_BIN 2 // Sobe sempre que o formato do ficheiro binário muda
+#define MAX_NOME_FICHEIRO_BIN 4096 // Bytes de um nome de ficheiro guardado no binário
+#define MAX_LINHA_BIN 65536 // Bytes de uma linha de texto guardada no binário
+
 
 
 #endif
\ No newline at end of file
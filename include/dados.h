@@ -6,13 +6,19 @@
 #include <string.h>
 
 #include "bdados.h"
+#include "leituraTxt.h"
+#include "registoLogs.h"
 
 int carregarDadosTxt(Bdados *bd, char *fDonos, char *fCarros, char *fSensores, char *fDistancias, char *fPassagem, char *fLogs);
-int carregarDonosTxt(Bdados *bd, char *donosFilename, FILE *logs);
-int carregarCarrosTxt(Bdados *bd, char *carrosFilename, FILE *logs);
-int carregarSensoresTxt(Bdados *bd, char *sensoresFilename, FILE *logs);
-int carregarDistanciasTxt(Bdados *bd, char *distanciasFilename, FILE *logs);
-int carregarPassagensTxt(Bdados *bd, char *passagensFilename, FILE *logs);
+int carregarDonosTxt(Bdados *bd, char *donosFilename, RegistoLogs *logs);
+int carregarCarrosTxt(Bdados *bd, char *carrosFilename, RegistoLogs *logs);
+int carregarSensoresTxt(Bdados *bd, char *sensoresFilename, RegistoLogs *logs);
+int carregarDistanciasTxt(Bdados *bd, char *distanciasFilename, RegistoLogs *logs);
+int carregarPassagensTxt(Bdados *bd, char *passagensFilename, RegistoLogs *logs);
+SeguimentoPassagens *iniciarSeguimentoPassagens(Bdados *bd, const char *nome);
+int lerNovasPassagens(SeguimentoPassagens *s, Bdados *bd, RegistoLogs *logs);
+void terminarSeguimentoPassagens(SeguimentoPassagens *s, RegistoLogs *logs);
+void acompanharPassagensTxt(Bdados *bd);
 
 void removerEspacos(char * str);
 void separarParametros(char *linha, char **parametros, int *numParametros, const int paramEsperados);
@@ -5,6 +5,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdint.h>
 
 #include "structsGenericas.h"
 
@@ -18,12 +19,14 @@ typedef struct {
 typedef struct {
     int nif; //PRIMARY KEY
     char *nome;
+    char *nomeNorm; // Nome normalizado (sem acentos e em minúsculas), usado como chave de ordenação
     CodPostal codigoPostal;
     Lista *carros;
 } Dono, Pessoa, *ptDono, *ptPessoa;
 
 int inserirDonoLido(struct Bdados *bd, char *nome, int nif, CodPostal codigoPostal);
 int compDonosNif(void *dono1, void *dono2);
+uint32_t chaveOrdenacaoDonoNif(void *dono);
 int compDonosNome(void *dono1, void *dono2);
 int compCodDono(void *dono, void *codigo);
 int compararCodPostal(const CodPostal cod1, const CodPostal cod2);
@@ -32,7 +35,6 @@ void printDono(void *dono, FILE *file);
 void guardarDonoBin(void *obj, FILE *file);
 void *readDonoBin(FILE *file);
 void *criarChaveDonoNif(void *dono);
-void freeChaveDonoNif(void *chave);
 int compChaveDonoNif(void *chave, void *chave2);
 int hashChaveDonoNif(void *chave);
 void *criarChaveDonoAlfabeticamente(void *dono);
@@ -51,7 +53,6 @@ void printDonoHTML(void *dono, FILE *file);
 void printDonoVelocidadesTXT(Dono *dono, float velocidadeMedia, FILE *file);
 void printDonoVelocidadesTXT(Dono *dono, float velocidadeMedia, FILE *file);
 size_t memUsageDono(void *dono);
-size_t memUsageChaveDonoCod(void *chave);
 size_t memUsageChaveDonoAlfabeticamente(void *chave);
 void registarDono(struct Bdados *bd);
 void listarDonosNIF(struct Bdados *bd);
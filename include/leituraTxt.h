@@ -0,0 +1,65 @@
+#ifndef LEITURA_TXT_HEADERS
+#define LEITURA_TXT_HEADERS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#if defined(__AVX2__) || defined(__SSE2__)
+    #include <immintrin.h>
+#endif
+#if !defined(_WIN32) && !defined(_WIN64)
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+#include "constantes.h"
+#include "structsGenericas.h"
+#include "perfilCarregamento.h"
+
+#define TAMANHO_BLOCO_TXT (1 << 21) // Bytes analisados por cada thread de cada vez no carregamento paralelo
+#define CAPACIDADE_ANEL_PIPELINE 2 // Blocos em espera entre cada par de etapas do carregamento, por analisador
+#define TAMANHO_PAGINA_TXT 4096 // Passo com que a leitura toca nos blocos para os trazer para memória
+#if defined(__AVX2__)
+    #define LARGURA_SIMD 32 // Bytes comparados de cada vez ao separar campos
+#else
+    #define LARGURA_SIMD 16
+#endif
+
+// Pedaço de um ficheiro: não é terminado em '\0' e não pode ser libertado
+typedef struct {
+    const char *inicio;
+    size_t tamanho;
+} Fatia;
+
+typedef struct {
+    char *dados; // Conteúdo do ficheiro (mapeado em memória ou lido de uma vez)
+    size_t tamanho;
+    size_t pos; // Início da próxima linha
+    int mapeado; // 1 se dados vem de mmap, 0 se foi alocado
+} FicheiroTxt;
+
+// Buffer reutilizado de linha para linha onde os campos são copiados como strings
+typedef struct {
+    char *dados;
+    size_t capacidade;
+} BufferCampos;
+
+FicheiroTxt *abrirFicheiroTxt(const char *nome);
+int proximaLinhaFatia(Fatia *resto, Fatia *linha);
+int proximaLinhaTxt(FicheiroTxt *f, Fatia *linha);
+int contarLinhasTxt(const FicheiroTxt *f);
+size_t fimLinhasCompletasTxt(const FicheiroTxt *f);
+int separarCampos(Fatia linha, Fatia *campos, int maxCampos);
+void copiarCampos(const Fatia *campos, int n, char **strings, char **destino);
+int camposParaStrings(const Fatia *campos, int n, char **strings, BufferCampos *buf);
+void freeBufferCampos(BufferCampos *buf);
+void fecharFicheiroTxt(FicheiroTxt *f);
+int carregarFicheiroTxtParalelo(FicheiroTxt *f, void *(*analisar)(Fatia bloco, void *contexto), int (*aplicar)(void *resultado, void *contexto), void (*freeResultado)(void *resultado), void *contexto, EtapaPerfil *perfil);
+
+
+#endif
\ No newline at end of file
@@ -19,6 +19,7 @@ void menuInfracoes();
 void menuAnaliseDados();
 void menuExportacao();
 void menuOpcoes();
+void menuCarregamento();
 void menuFormatosListagem();
 void menuNomeFicheirosDados();
 void menuNomeFicheirosExportacao();
@@ -35,6 +36,7 @@ void processarMenuInfracoes(Bdados *bd);
 void processarMenuAnaliseDados(Bdados *bd);
 void processarMenuExportacao(Bdados *bd);
 void processarMenuOpcoes(Bdados *bd);
+void processarMenuCarregamento();
 
 
 
@@ -0,0 +1,57 @@
+#ifndef PERFIL_CARREGAMENTO_HEADERS
+#define PERFIL_CARREGAMENTO_HEADERS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#if defined(_WIN32) || defined(_WIN64)
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+#define MAX_ETAPAS_PERFIL 8 // Ficheiros/etapas registados por carregamento
+#define TAMANHO_RELATORIO_PERFIL 4096 // Bytes do texto do relatório
+
+typedef enum {
+    FASE_LEITURA, // Trazer o ficheiro para memória
+    FASE_ANALISE, // Separar campos, converter e validar
+    FASE_INSERCAO, // Inserir nas estruturas e índices
+    FASE_ORDENACAO,
+    FASE_CHECKSUM,
+    NUM_FASES
+} FaseCarregamento;
+
+typedef struct {
+    const char *nome;
+    double tempo; // Tempo real da etapa, em segundos
+    double fases[NUM_FASES]; // Tempo de cada fase, somado entre threads (pode passar o tempo real)
+    long nLinhas; // Linhas (txt) ou registos (bin)
+    size_t nBytes;
+} EtapaPerfil;
+
+typedef struct {
+    const char *origem; // "txt" ou "bin"
+    int numThreads;
+    EtapaPerfil etapas[MAX_ETAPAS_PERFIL];
+    int nEtapas;
+    double inicio;
+    double tempoTotal;
+    long picoMemoria; // Pico do RSS do processo, em KiB (0 se não estiver disponível)
+} PerfilCarregamento;
+
+extern PerfilCarregamento perfilCarregamento; // Último carregamento feito
+
+double tempoAtual();
+long picoMemoriaProcesso();
+void iniciarPerfil(PerfilCarregamento *p, const char *origem);
+EtapaPerfil *novaEtapaPerfil(PerfilCarregamento *p, const char *nome);
+void adicionarTemposPerfil(EtapaPerfil *e, const double *tempos);
+void terminarPerfil(PerfilCarregamento *p);
+int formatarPerfil(const PerfilCarregamento *p, char *texto, size_t tamanho);
+
+
+#endif
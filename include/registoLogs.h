@@ -0,0 +1,60 @@
+#ifndef REGISTO_LOGS_HEADERS
+#define REGISTO_LOGS_HEADERS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "leituraTxt.h"
+
+#define TAMANHO_BLOCO_LOG (1 << 18) // Bytes de cada bloco do buffer dos logs
+#define NUM_BLOCOS_LOG 8 // Capacidade inicial do anel de blocos à espera de serem escritos
+
+typedef struct {
+    char *dados;
+    size_t usado;
+    size_t capacidade;
+} BlocoLog;
+
+// Nº de vezes que uma razão de linha inválida apareceu (no ficheiro atual)
+typedef struct {
+    const char *razao; // Formato da mensagem, serve de chave
+    int total;
+} ContagemRazao;
+
+typedef struct {
+    FILE *ficheiro;
+    BlocoLog atual; // Bloco a ser preenchido
+    // Anel dos blocos cheios à espera do escritor
+    BlocoLog *anel;
+    int capacidadeAnel;
+    int inicioAnel;
+    int nPendentes;
+    // Buffers de blocos já escritos, para reutilizar
+    char **livres;
+    int nLivres;
+    // Escritor em segundo plano (opcional)
+    int comEscritor;
+    int aEscrever; // O escritor tem um bloco já retirado do anel por escrever
+    int terminar;
+    pthread_t escritor;
+    pthread_mutex_t mutex;
+    pthread_cond_t temBlocos;
+    // Contagens por razão
+    ContagemRazao *razoes;
+    int nRazoes;
+    int capacidadeRazoes;
+    int limiteExemplos; // 0 = sem limite
+} RegistoLogs;
+
+RegistoLogs *criarRegistoLogs(FILE *ficheiro, int comEscritor, int limiteExemplos);
+void escreverLog(RegistoLogs *r, const char *formato, ...);
+void registarLinhaInvalida(RegistoLogs *r, Fatia linha, int nLinha, const char *razao, ...);
+void escreverResumoLogs(RegistoLogs *r);
+void fecharRegistoLogs(RegistoLogs *r);
+
+
+#endif
@@ -4,14 +4,38 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-
-#define TAMANHO_TABELA_HASH 16007 // load factor 0,62; Nºprimo para não haver tantas colisões
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#define CAPACIDADE_INICIAL_DICT 16 // Tem de ser potência de 2
+#define CARGA_MAXIMA_DICT 70 // Percentagem de ocupação a partir da qual a tabela duplica
+#define CAPACIDADE_MAXIMA_DICT (1 << 30) // A tabela não cresce para lá disto (a capacidade é um int)
+#define RESERVA_MAXIMA_DICT_BIN (1 << 22) // Chaves para as quais a tabela é logo dimensionada ao ler um binário
+#define DICT_MULTIPLO 0 // Cada chave guarda uma lista de elementos
+#define DICT_CHAVE_UNICA 1 // Cada chave guarda diretamente um único elemento
+#define CHAVE_ALOCADA 0 // A chave é alocada por criarChave e libertada por freeChave
+#define TAMANHO_MAX_CHAVE_INLINE 12 // Bytes disponíveis para chaves guardadas no próprio nó (int, matrícula)
+#define NOS_POR_SLAB 1024 // Nós de lista/ranking alocados de cada vez pelo pool
+#define LIMITE_MINIMO_NOS_LIVRES (4 * NOS_POR_SLAB) // Nós livres a partir dos quais o pool procura slabs para libertar
+#define TAMANHO_BLOCO_ARENA 65536 // Bytes alocados de cada vez pela arena de strings
+#define LIMITE_INSERCAO_ARRAY 16 // Intervalos até este tamanho são ordenados por inserção
+#define CAPACIDADE_INICIAL_INTERNAMENTO 64 // Tem de ser potência de 2
+#define MAX_INTERNADOS UINT16_MAX // Os ids internados são guardados em uint16_t
+#define RANKING_INT 0 // Pontuações inteiras
+#define RANKING_FLOAT 1 // Pontuações em vírgula flutuante
+#define CAPACIDADE_INICIAL_RANKING 64
+#define NUM_THREADS 4 // Nº de threads por omissão nas ordenações grandes e no carregamento dos .txt (1 = sequencial)
+#define MAX_THREADS 64
+#define LIMIAR_ORDENACAO_PARALELA 16384 // Abaixo deste nº de elementos a ordenação é sempre sequencial
 
 extern int listagemFlag;
 extern int printingDict;
+extern int numThreads;
 
 extern void pressEnter();
 extern int enter_espaco_esc();
+extern int hashString(const char *str);
 
 typedef struct no {
    void *info;
@@ -24,15 +48,24 @@ typedef struct {
 } Lista;
 
 typedef struct noHash {
-    void *chave;
-    Lista *dados;
-    struct noHash *prox; // Necessário caso chaves diferentes gerem o mesmo índice
+    union {
+        void *chave; // CHAVE_ALOCADA
+        char chaveInline[TAMANHO_MAX_CHAVE_INLINE]; // Chave de tamanho fixo copiada para o nó
+    };
+    unsigned int hash; // Hash (já misturado) da chave, evita comparações e recálculos
+    union {
+        Lista *dados; // DICT_MULTIPLO
+        void *obj; // DICT_CHAVE_UNICA
+    }; // NULL caso a posição esteja livre
 } NoHashing;
 
 typedef struct {
-    NoHashing *tabela[TAMANHO_TABELA_HASH];
+    NoHashing *tabela; // Endereçamento aberto com sondagem linear
+    int capacidade; // Potência de 2, cresce automaticamente
     int nelDict;
-} Dict; // Cada Dict ocupa cerca de 125KB em memória (sem elementos ou chaves)
+    int chaveUnica; // DICT_MULTIPLO ou DICT_CHAVE_UNICA
+    int tamanhoChave; // CHAVE_ALOCADA ou nº de bytes da chave inline
+} Dict;
 
 typedef struct noRankings {
     void *mainInfo;
@@ -45,18 +78,94 @@ typedef struct {
     int nel;
 } Ranking;
 
+typedef struct {
+    void *mainInfo;
+    union {
+        int i;
+        float f;
+    } valor; // Pontuação guardada junto do objeto (sem alocação própria)
+    int ordem; // Ordem de inserção, desempata o Top-K como a ordenação estável completa
+} EntradaRanking;
+
+typedef struct rankingNumerico {
+    EntradaRanking *entradas;
+    int nel;
+    int capacidade;
+    int tipo; // RANKING_INT ou RANKING_FLOAT
+    int limite; // Top-K: nº máximo de entradas guardadas (0 = sem limite)
+    int total; // Nº de entradas oferecidas ao ranking, incluindo as descartadas pelo Top-K
+    int (*preencher)(struct rankingNumerico *r, void *contexto); // Volta a percorrer os dados (expansão do Top-K)
+    void *contexto;
+} RankingNumerico;
+
+typedef struct blocoArena {
+    struct blocoArena *prox;
+    size_t usado;
+    size_t capacidade;
+    char dados[];
+} BlocoArena;
+
+typedef struct {
+    BlocoArena *blocos; // O bloco atual é o primeiro
+    size_t memReservada;
+} ArenaStrings;
+
+typedef struct {
+    char **textos; // id -> texto original
+    char **chaves; // id -> chave de pesquisa (pode ser o próprio texto)
+    uint16_t *tabela; // Endereçamento aberto sobre as chaves: id + 1, 0 se livre
+    int capacidade; // Potência de 2, ocupação máxima de 50%
+    int nel;
+    ArenaStrings *strings;
+} Internamento;
+
+// Fila circular sem locks entre uma thread que coloca e uma thread que retira
+typedef struct {
+    void **itens;
+    size_t mascara; // Capacidade - 1 (a capacidade é potência de 2)
+    _Atomic size_t cabeca; // Próximo item a retirar (só o consumidor altera)
+    char separador[64]; // cabeca e cauda em linhas de cache diferentes
+    _Atomic size_t cauda; // Próxima posição a preencher (só o produtor altera)
+} AnelSPSC;
+
+
+// Pool de nós
+// Os pools são globais e não têm locks: listas e rankings só podem ser criados, alterados ou libertados na thread
+// principal (as threads de leitura só analisam texto, ver carregarFicheiroTxtParalelo)
+
+int reservarNosLista(int n);
+void libertarPoolsNos();
+
+// Threads
+
+void executarEmParalelo(void *(*tarefa)(void *arg), void *args, size_t tamanhoArg, int n);
+AnelSPSC *criarAnelSPSC(size_t capacidade);
+int colocarAnelSPSC(AnelSPSC *a, void *item);
+int retirarAnelSPSC(AnelSPSC *a, void **item);
+void colocarAnelSPSCEspera(AnelSPSC *a, void *item);
+void *retirarAnelSPSCEspera(AnelSPSC *a);
+void freeAnelSPSC(AnelSPSC *a);
+
+// Arena de strings
+
+ArenaStrings *criarArena();
+char *reservarArena(ArenaStrings *arena, size_t tamanho);
+int reservarEspacoArena(ArenaStrings *arena, size_t tamanho);
+char *guardarStringArena(ArenaStrings *arena, const char *str);
+void freeArena(ArenaStrings *arena);
+size_t arenaMemUsage(ArenaStrings *arena);
 
 // Listas
 
 Lista *criarLista();
 int addInicioLista(Lista *li, void *elemento);
+int removerDaLista(Lista *li, void *elemento);
 void printLista(Lista *li, void (*printObj)(void *obj, FILE *file), FILE *file, int pausa);
 void exportarListaXML(Lista *li, char *nomeLista, void (*printObj)(void *obj, int indentacao, FILE *file), int indentacao, FILE *file);
 void exportarListaCSV(Lista *li, void (*printHeader)(FILE *file), void (*printObj)(void *obj, FILE *file), FILE *file);
 void exportarListaHTML(Lista *li, char *pagename, void (*printTableHead)(FILE *file), void  (*printObj)(void *obj, FILE *file), FILE *file);
 void freeLista(Lista *li, void (*freeObj)(void *obj));
 void mergeSortLista(Lista* li, int (*compObjs)(void *obj1, void *obj2));
-void ordenarLista(Lista *li, int (*compObjs)(void *obj1, void *obj2));
 void *searchLista(Lista *li, int (*compCod)(void *codObj, void *chave), void *chave);
 void guardarListaBin(Lista *li, void (*saveInfo)(void *obj, FILE *fileObj), FILE *file);
 Lista *readListaBin(void *(*readInfo)(FILE *fileObj), FILE *file);
@@ -64,10 +173,12 @@ size_t listaMemUsage(Lista *li, size_t (*objMemUsage)(void *obj));
 
 // Hashing
 
-Dict *criarDict();
-NoHashing *posicaoInsercao(Dict *has, int indice, void *chave, int (*compChave)(void *chave, void *chave2));
+Dict *criarDict(int chaveUnica, int tamanhoChave);
+int reservarDict(Dict *has, int nel);
+NoHashing *posicaoInsercao(Dict *has, unsigned int hash, void *chave, int (*compChave)(void *chave, void *chave2));
 Lista *obterListaDoDict(Dict *has, void *chave, int (*compChave)(void *chave, void *chave2), int (*hashChave)(void *obj));
 int appendToDict(Dict *has, void *obj, int (*compChave)(void *chave, void *obj), void *(*criarChave)(void *obj), int (*hashChave)(void *obj), void (*freeObj)(void *obj), void (*freeChave)(void *chave));
+int removeFromDict(Dict *has, void *obj, int (*compChave)(void *chave, void *obj), void *(*criarChave)(void *obj), int (*hashChave)(void *obj), void (*freeChave)(void *chave));
 void printDict(Dict *has, void (*printObj)(void *obj, FILE *file),FILE *file, int pausa);
 void exportarDictXML(Dict *has, char *nomeDict, void (*printObj)(void *obj, int indentacao, FILE *file), int indentacao, FILE *file);
 void exportarDictCSV(Dict *has, void (*printHeader)(FILE *file), void (*printObj)(void *obj, FILE *file), FILE *file);
@@ -75,9 +186,27 @@ void exportarDictHTML(Dict *has, char *pagename, void (*printTableHead)(FILE *fi
 void freeDict(Dict *has, void (*freeChave)(void *chave), void (*freeObj)(void *obj));
 void *searchDict(Dict *has, void *chave, int (*compChave)(void *chave, void *obj), int (*compCod)(void *codObj, void *chave), int (*hashChave)(void *chave));
 void guardarDadosDictBin(Dict *has, void (*saveInfo)(void *obj, FILE *fileObj), FILE *file);
-Dict *readToDictBin(void *(*criarChave)(void *obj), int (*hashChave)(void *obj), void (*freeObj)(void *obj), void (*freeChave)(void *chave), void *(*readInfo)(FILE *fileObj), FILE *file);
+Dict *readToDictBin(int chaveUnica, int tamanhoChave, void *(*criarChave)(void *obj), int (*hashChave)(void *obj), void (*freeObj)(void *obj), void (*freeChave)(void *chave), void *(*readInfo)(FILE *fileObj), FILE *file);
 size_t dictMemUsage(Dict *has, size_t (*objMemUsage)(void *obj), size_t (*chaveMemUsage)(void *chave));
 Lista *dictToLista(Dict *has);
+void **dictToArray(Dict *has, int *nel);
+
+// Arrays
+
+void printArray(void **arr, int nel, void (*printObj)(void *obj, FILE *file), FILE *file, int pausa);
+void ordenarArray(void **arr, int nel, int (*compObjs)(void *obj1, void *obj2));
+int ordenarArrayPorChave(void **arr, int nel, uint32_t (*chaveObj)(void *obj));
+
+// Internamento de strings
+
+Internamento *criarInternamento();
+int internarTexto(Internamento *in, const char *texto, const char *chave);
+const char *textoInternado(Internamento *in, int id);
+const char *chaveInternada(Internamento *in, int id);
+void guardarInternamentoBin(Internamento *in, FILE *file);
+Internamento *readInternamentoBin(FILE *file);
+void freeInternamento(Internamento *in);
+size_t internamentoMemUsage(Internamento *in);
 
 // Listas Rankings
 
@@ -87,5 +216,17 @@ void printRanking(Ranking *r, void printCarroRanking(NoRankings *no, void (*prin
 void freeRanking(Ranking *r, void (*freeMainObj)(void *obj), void (*freeCompObj)(void *obj));
 void mergeSortRanking(Ranking *r, int (*compObjs)(void *obj1, void *obj2));
 
+// Rankings numéricos
+
+RankingNumerico *criarRankingNumerico(int tipo);
+RankingNumerico *criarRankingTopK(int tipo, int k, int (*preencher)(RankingNumerico *r, void *contexto), void *contexto);
+int preencherRankingNumerico(RankingNumerico *r);
+int expandirRankingNumerico(RankingNumerico *r);
+int addToRankingInt(RankingNumerico *r, void *mainInfo, int valor);
+int addToRankingFloat(RankingNumerico *r, void *mainInfo, float valor);
+int ordenarRankingNumerico(RankingNumerico *r);
+void printRankingNumerico(RankingNumerico *r, void printCarroRanking(NoRankings *no, void (*printCompObj)(void *compInfo, FILE *file), FILE *file), void (*printHeaderCompObj)(FILE *file), void (*printCompObj)(void *compInfo, FILE *file), FILE *file, int pausa);
+void freeRankingNumerico(RankingNumerico *r);
+
 
 #endif
\ No newline at end of file
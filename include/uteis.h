@@ -9,6 +9,8 @@
     #include <psapi.h>
 #else 
     #include <sys/resource.h>
+    #include <sys/select.h>
+    #include <unistd.h>
 #endif
 #include <locale.h>
 #include <time.h>
@@ -34,9 +36,11 @@ void limpar_terminal();
 int getKeyStroked();
 void pressEnter();
 int enter_espaco_esc();
+int esperarEnter(int milissegundos);
 int randomInt(int min, int max);
 void data_atual();
 int sim_nao(char *mensagem);
+size_t normalizarString(const char *str, char *destino, size_t tamanho);
 char *normString(const char *str);
 char *strlwrSafe(const char *str);
 int stricmpSafe(const char *s1, const char *s2);
@@ -53,7 +57,9 @@ void pedirPeriodoTempo(Data *inicio, Data *fim, char *mensagemInicial, char *men
 int converterCodPostal(const char *codPostal, short *zona, short *local);
 int compararDatas(Data data1, Data data2);
 char *converterParaData(const char *strData, Data *data);
+int converterDataFixa(const char *strData, Data *data);
 float calcularIntervaloTempo(Data *data1, Data *data2);
+double minutosDesdeEpoca(const Data *data);
 int hashString(const char *str);
 int deleteFile(const char *nome, const char modo);
 void indent(int indentacao, FILE *file);
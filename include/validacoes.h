@@ -5,6 +5,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <wctype.h>
+#include <stdint.h>
 
 #include "uteis.h"
 
@@ -13,6 +14,7 @@ char *validarNome(char *nome);
 int validarCodPostal(const short zona, const short local);
 int validarAnoCarro(const short ano);
 int validarMatricula(const char *matricula);
+uint32_t codificarMatricula(const char *matricula);
 char *validarMarca(char *marca);
 char *validarModelo(char *modelo);
 int validarCodVeiculo(const int codigo);
@@ -6,6 +6,9 @@
 #include "sensores.h"
 #include "configs.h"
 #include "uteis.h"
+#include "dados.h"
+
+ArenaStrings *arenaLeituraBin = NULL; // Arena usada pelas funções readXBin, que não recebem a base de dados
 
 /**
  * @brief Inicializa a base de dados criando as estruturas necessárias
@@ -14,19 +17,21 @@
  * @return int 1 se sucesso, 0 se erro
  */
 int inicializarBD(Bdados *bd) {
-    bd->carrosMarca = criarDict();
-    bd->carrosCod = criarDict();
-    bd->carrosMat = criarDict();
+    bd->carrosMarca = criarDict(DICT_MULTIPLO, sizeof(uint16_t));
+    bd->carrosCod = criarDict(DICT_CHAVE_UNICA, sizeof(int));
+    bd->carrosMat = criarDict(DICT_CHAVE_UNICA, sizeof(uint32_t));
 
-    bd->donosNif = criarDict();
-    bd->donosAlfabeticamente = criarDict();
+    bd->donosNif = criarDict(DICT_CHAVE_UNICA, sizeof(int));
+    bd->donosAlfabeticamente = criarDict(DICT_MULTIPLO, CHAVE_ALOCADA);
 
     bd->viagens = criarLista();
     bd->sensores = criarLista();
+    bd->strings = criarArena();
+    bd->seguimento = NULL;
     inicializarMatrizDistancias(bd);
 
     if (!bd->carrosMarca || !bd->carrosCod|| !bd->distancias || !bd->distancias->matriz || !bd->donosNif ||
-         !bd->donosAlfabeticamente	|| !bd->viagens || !bd->sensores) return 0;
+         !bd->donosAlfabeticamente	|| !bd->viagens || !bd->sensores || !bd->strings) return 0;
     return 1;
 }
 
@@ -41,12 +46,12 @@ void freeTudo(Bdados *bd) {
     freeFilenames(); // só serão válidos na primeira execução (mas para evitar saídas inesperadas)
     freeExportacaoFilenames();
 
-    freeDict(bd->carrosMarca, freeChaveCarroMarca, NULL);
-    freeDict(bd->carrosMat, freeChaveCarroMatricula, NULL);
-    freeDict(bd->carrosCod, freeChaveCarroCod, freeCarro);
+    freeDict(bd->carrosMarca, NULL, NULL);
+    freeDict(bd->carrosMat, NULL, NULL);
+    freeDict(bd->carrosCod, NULL, freeCarro);
 
     freeDict(bd->donosAlfabeticamente, freeChaveDonoAlfabeticamente, NULL);
-    freeDict(bd->donosNif, freeChaveDonoNif, freeDono);
+    freeDict(bd->donosNif, NULL, freeDono);
 
     freeMatrizDistancias(bd->distancias);
 
@@ -54,7 +59,14 @@ void freeTudo(Bdados *bd) {
 
     freeLista(bd->sensores, freeSensor);
 
+    terminarSeguimentoPassagens(bd->seguimento, NULL);
+
+    freeArena(bd->strings); // Todas as strings de uma só vez
+    freeMarcasModelos();
+
     free(bd);
+
+    libertarPoolsNos(); // Só liberta se já não houver listas/rankings em uso
 }
 
 
@@ -238,12 +250,13 @@ size_t memUsageTudo(Bdados *bd) {
 
     memTotal += memUsageVarGlobais();
 
-    memTotal += dictMemUsage(bd->donosNif, memUsageDono, memUsageChaveDonoCod);
+    memTotal += dictMemUsage(bd->donosNif, memUsageDono, NULL);
     memTotal += dictMemUsage(bd->donosAlfabeticamente, NULL, memUsageChaveDonoAlfabeticamente);
 
-    memTotal += dictMemUsage(bd->carrosCod, memUsageCarro, memUsageChaveCarroCod);
-    memTotal += dictMemUsage(bd->carrosMarca, NULL, memUsageChaveCarroMarca);
-    memTotal += dictMemUsage(bd->carrosMat, NULL, memUsageChaveCarroMatricula);
+    memTotal += dictMemUsage(bd->carrosCod, memUsageCarro, NULL);
+    memTotal += dictMemUsage(bd->carrosMarca, NULL, NULL);
+    memTotal += memUsageMarcasModelos();
+    memTotal += dictMemUsage(bd->carrosMat, NULL, NULL);
 
     memTotal += listaMemUsage(bd->sensores, memUsageSensor);
 
@@ -251,6 +264,8 @@ size_t memUsageTudo(Bdados *bd) {
 
     memTotal += memUsageDistancias(bd->distancias);
 
+    memTotal += arenaMemUsage(bd->strings);
+
     return memTotal;
 }
 
@@ -5,6 +5,56 @@
 #include "structsGenericas.h"
 #include "configs.h"
 
+// Marcas e modelos distintos, partilhados por todos os carros (criados ao internar o primeiro)
+static Internamento *marcasCarros = NULL;
+static Internamento *modelosCarros = NULL;
+
+/**
+ * @brief Interna a marca e o modelo de um carro, guardando os respetivos ids
+ * 
+ * @param carro Carro
+ * @param marca Marca
+ * @param modelo Modelo
+ * @return int 1 se sucesso, 0 se erro
+ * 
+ * @note As marcas são agrupadas pela forma normalizada (sem acentos e em minúsculas)
+ */
+static int internarMarcaModelo(Carro *carro, const char *marca, const char *modelo) {
+    if (!marcasCarros) marcasCarros = criarInternamento();
+    if (!modelosCarros) modelosCarros = criarInternamento();
+    if (!marcasCarros || !modelosCarros) return 0;
+
+    char buffer[TAMANHO_INICIAL_BUFFER];
+    size_t tamanho = strlen(marca) + 1;
+    char *marcaNorm = tamanho <= sizeof(buffer) ? buffer : (char *)malloc(tamanho);
+    if (!marcaNorm) return 0;
+    normalizarString(marca, marcaNorm, tamanho);
+
+    int idMarca = internarTexto(marcasCarros, marca, marcaNorm);
+    if (marcaNorm != buffer) free(marcaNorm);
+    int idModelo = internarTexto(modelosCarros, modelo, NULL);
+    if (idMarca < 0 || idModelo < 0) return 0;
+
+    carro->idMarca = (uint16_t)idMarca;
+    carro->idModelo = (uint16_t)idModelo;
+    return 1;
+}
+
+/**
+ * @brief Retira um carro que não chegou a ser inserido dos dicionários onde já estava e liberta-o
+ * 
+ * @param bd Base de dados
+ * @param aut Carro
+ * 
+ * @note removeFromDict compara pelo endereço, pelo que um carro diferente com a mesma chave não é afetado
+ */
+static void removerCarroDicts(Bdados *bd, Carro *aut) {
+    (void)removeFromDict(bd->carrosMat, (void *)aut, compChaveCarroMatricula, criarChaveCarroMatricula, hashChaveCarroMatricula, NULL);
+    (void)removeFromDict(bd->carrosMarca, (void *)aut, compChaveCarroMarca, criarChaveCarroMarca, hashChaveCarroMarca, NULL);
+    (void)removeFromDict(bd->carrosCod, (void *)aut, compChaveCarroCod, criarChaveCarroCod, hashChaveCarroCod, NULL);
+    free(aut);
+}
+
 /**
  * @brief Inserir um carro na base de dados
  * 
@@ -28,21 +78,12 @@ int inserirCarroLido(Bdados *bd, char *matricula, char *marca, char *modelo, sho
     
     //Matrícula
     strcpy(aut->matricula, matricula);
-    //Marca
-    aut->marca = (char *)malloc(strlen(marca) * sizeof(char) + 1);
-    if (!aut->marca) {
+    aut->codMatricula = codificarMatricula(matricula);
+    //Marca e modelo
+    if (!internarMarcaModelo(aut, marca, modelo)) {
         free(aut);
         return 0;
     }
-    strcpy(aut->marca, marca);
-    //Modelo
-    aut->modelo = (char *)malloc(strlen(modelo) * sizeof(char) + 1);
-    if (!aut->modelo) {
-        free(aut->marca);
-        free(aut);
-        return 0;
-    }
-    strcpy(aut->modelo, modelo);
     //Ano
     aut->ano = ano;
     //NIF (ptrPessoa)
@@ -57,37 +98,32 @@ int inserirCarroLido(Bdados *bd, char *matricula, char *marca, char *modelo, sho
     aut->codVeiculo = codVeiculo;
     aut->viagens = NULL;
     
-    //Associar o carro ao dono
-    if (aut->ptrPessoa) {
-		if (!aut->ptrPessoa->carros) {
-            aut->ptrPessoa->carros = criarLista();
-            if (!aut->ptrPessoa->carros) {
-                free(aut->modelo);
-                free(aut->marca);
-                free(aut);
-                return 0;
-            }
-        }
-        if (!addInicioLista(aut->ptrPessoa->carros, (void *)aut)) {
-            free(aut->modelo);
-            free(aut->marca);
-            free(aut);
-            return 0;
-        }
-	}
-
-    // Em caso de falha, os dados são libertados em appendToDict
-    if (!appendToDict(bd->carrosCod, (void *)aut, compChaveCarroCod, criarChaveCarroCod, hashChaveCarroCod, freeCarro, freeChaveCarroCod)) {
+    // Os dicionários rejeitam um código ou matrícula repetidos: só depois o carro é associado ao dono
+    if (!appendToDict(bd->carrosCod, (void *)aut, compChaveCarroCod, criarChaveCarroCod, hashChaveCarroCod, NULL, NULL)) {
+        free(aut);
         return 0;
     }
 
-    if (!appendToDict(bd->carrosMarca, (void *)aut, compChaveCarroMarca, criarChaveCarroMarca, hashChaveCarroMarca, freeCarro, freeChaveCarroMarca)) {
+    if (!appendToDict(bd->carrosMarca, (void *)aut, compChaveCarroMarca, criarChaveCarroMarca, hashChaveCarroMarca, NULL, NULL)) {
+        removerCarroDicts(bd, aut);
         return 0;
     }
 
-    if (!appendToDict(bd->carrosMat, (void *)aut, compChaveCarroMatricula, criarChaveCarroMatricula, hashChaveCarroMatricula, freeCarro, freeChaveCarroMatricula)) {
+    if (!appendToDict(bd->carrosMat, (void *)aut, compChaveCarroMatricula, criarChaveCarroMatricula, hashChaveCarroMatricula, NULL, NULL)) {
+        removerCarroDicts(bd, aut);
         return 0;
     }
+
+    //Associar o carro ao dono
+    if (aut->ptrPessoa) {
+        if (!aut->ptrPessoa->carros) {
+            aut->ptrPessoa->carros = criarLista();
+        }
+        if (!addInicioLista(aut->ptrPessoa->carros, (void *)aut)) {
+            removerCarroDicts(bd, aut);
+            return 0;
+        }
+    }
     
     return 1;
 }
@@ -135,8 +171,6 @@ int compCodCarro(void *carro, void *codigo) {
  */
 void freeCarro(void *carro) {
     Carro *obj = (Carro *)carro;
-    if (obj->marca) free(obj->marca);
-    if (obj->modelo) free(obj->modelo);
     if (obj->viagens) {
         freeLista(obj->viagens, NULL);
     }
@@ -156,8 +190,8 @@ void printCarro(void *carro, FILE *file) {
     
     fprintf(file, "Código do Veículo: %d\n", c->codVeiculo);
     fprintf(file, "Matrícula: %s\n", c->matricula);
-    fprintf(file, "Marca: %s\n", c->marca ? c->marca : "n/a");
-    fprintf(file, "Modelo: %s\n", c->modelo ? c->modelo : "n/a");
+    fprintf(file, "Marca: %s\n", marcaCarro(c));
+    fprintf(file, "Modelo: %s\n", modeloCarro(c));
     fprintf(file, "Ano do Veículo: %d\n", c->ano);
     if (c->ptrPessoa) {
         fprintf(file, "NIF do Dono: %d\n", c->ptrPessoa->nif);
@@ -183,13 +217,9 @@ void guardarCarroBin(void *carro, FILE *file) {
     fwrite(&x->codVeiculo, sizeof(int), 1, file);
     fwrite(x->matricula, sizeof(x->matricula), 1, file);
 
-    size_t tamanhoMarca = strlen(x->marca) + 1;
-    fwrite(&tamanhoMarca, sizeof(size_t), 1, file);
-    fwrite(x->marca, tamanhoMarca, 1, file);
-
-    size_t tamanhoModelo = strlen(x->modelo) + 1;
-    fwrite(&tamanhoModelo, sizeof(size_t), 1, file);
-    fwrite(x->modelo, tamanhoModelo, 1, file);
+    // Os textos das marcas e modelos são guardados uma única vez (guardarMarcasModelosBin)
+    fwrite(&x->idMarca, sizeof(uint16_t), 1, file);
+    fwrite(&x->idModelo, sizeof(uint16_t), 1, file);
     if (x->ptrPessoa) {
         fwrite(&x->ptrPessoa->nif, sizeof(int), 1, file);
     }
@@ -218,25 +248,14 @@ void *readCarroBin(FILE *file) {
     fread(&x->ano, sizeof(short), 1, file);
     fread(&x->codVeiculo, sizeof(int), 1, file);
     fread(x->matricula, sizeof(x->matricula), 1, file);
+    x->codMatricula = codificarMatricula(x->matricula);
 
-    size_t tamanhoMarca;
-    fread(&tamanhoMarca, sizeof(size_t), 1, file);
-    x->marca = (char *)malloc(tamanhoMarca);
-    if (!x->marca) {
-        free(x);
-        return NULL;
-    }
-    fread(x->marca, tamanhoMarca, 1, file);
-
-    size_t tamanhoModelo;
-    fread(&tamanhoModelo, sizeof(size_t), 1, file);
-    x->modelo = (char *)malloc(tamanhoModelo);
-    if (!x->modelo) {
-        free(x->marca);
+    fread(&x->idMarca, sizeof(uint16_t), 1, file);
+    fread(&x->idModelo, sizeof(uint16_t), 1, file);
+    if (!textoInternado(marcasCarros, x->idMarca) || !textoInternado(modelosCarros, x->idModelo)) {
         free(x);
         return NULL;
     }
-    fread(x->modelo, tamanhoModelo, 1, file);
 
     int nif = 0;
     fread(&nif, sizeof(int), 1, file);
@@ -246,8 +265,6 @@ void *readCarroBin(FILE *file) {
     else {
         Dono *d = (Dono *)malloc(sizeof(Dono));
         if (!d) {
-            free(x->marca);
-            free(x->modelo);
             free(x);
             return NULL;
         }
@@ -258,84 +275,125 @@ void *readCarroBin(FILE *file) {
     return (void *)x;
 }
 
-// Chave por Marca
+// Marcas e modelos
+
+/**
+ * @brief Obtém a marca de um carro
+ * 
+ * @param carro Carro
+ * @return const char* Marca ou "n/a" se desconhecida
+ */
+const char *marcaCarro(const Carro *carro) {
+    if (!carro) return "n/a";
+
+    const char *marca = textoInternado(marcasCarros, carro->idMarca);
+    return marca ? marca : "n/a";
+}
+
+/**
+ * @brief Obtém o modelo de um carro
+ * 
+ * @param carro Carro
+ * @return const char* Modelo ou "n/a" se desconhecido
+ */
+const char *modeloCarro(const Carro *carro) {
+    if (!carro) return "n/a";
+
+    const char *modelo = textoInternado(modelosCarros, carro->idModelo);
+    return modelo ? modelo : "n/a";
+}
 
 /**
- * @brief Guarda a chave do carro por marca em ficheiro binário
+ * @brief Guarda as marcas e modelos internados em ficheiro binário
  * 
- * @param chaveMarca Chave
  * @param file Ficheiro binário, aberto
+ * 
+ * @note Tem de ser guardado antes dos carros, que só guardam os ids
  */
-void guardarChaveCarroMarca(void *chaveMarca, FILE *file) {
-    if (!chaveMarca || !file) return;
+void guardarMarcasModelosBin(FILE *file) {
+    if (!file) return;
 
-    char *chave = (char *)chaveMarca;
+    guardarInternamentoBin(marcasCarros, file);
+    guardarInternamentoBin(modelosCarros, file);
+}
 
-    size_t comp = strlen(chave) + 1;
-    fwrite(&comp, sizeof(size_t), 1, file);
-    fwrite(chave, comp, 1, file);
+/**
+ * @brief Lê as marcas e modelos de ficheiro binário, substituindo os atuais
+ * 
+ * @param file Ficheiro binário, aberto
+ * @return int 1 se sucesso, 0 se erro
+ */
+int readMarcasModelosBin(FILE *file) {
+    if (!file) return 0;
+
+    freeMarcasModelos();
+    marcasCarros = readInternamentoBin(file);
+    modelosCarros = readInternamentoBin(file);
+    if (!marcasCarros || !modelosCarros) return 0;
+    return 1;
 }
 
+/**
+ * @brief Liberta as marcas e modelos internados
+ * 
+ * @note Os ids guardados nos carros deixam de ser válidos
+ */
+void freeMarcasModelos() {
+    freeInternamento(marcasCarros);
+    freeInternamento(modelosCarros);
+    marcasCarros = NULL;
+    modelosCarros = NULL;
+}
+
+/**
+ * @brief Memória ocupada pelas marcas e modelos internados
+ * 
+ * @return size_t Memória ocupada
+ */
+size_t memUsageMarcasModelos() {
+    return internamentoMemUsage(marcasCarros) + internamentoMemUsage(modelosCarros);
+}
+
+// Chave por Marca
+
 /**
  * @brief Cria uma chave para o carro consoante a marca
  * 
  * @param carro Carro
  * @return void* Chave(tipo void) ou NULL se erro
  * 
- * @note Coloca a chave em minúscula
+ * @note Chave inline (sizeof(uint16_t)): devolve o endereço do id da marca no próprio carro, não aloca memória
  */
 void *criarChaveCarroMarca(void *carro) {
     if (!carro) return NULL;
 
     Carro *x = (Carro *)carro;
-
-    return (void *)strlwrSafe(x->marca);
+    return (void *)&x->idMarca;
 }
 
 /**
  * @brief Função de hash para o carro por marca
  * 
- * @param chave Chave (marca)
+ * @param chave Chave (id da marca)
  * @return int hash ou -1 se erro
  */
 int hashChaveCarroMarca(void *chave) {
     if (!chave) return -1;
 
-    char *key = (char *)chave;
-    char *marcaNorm = normString(key);
-    int hash = hashString(marcaNorm);
-    free(marcaNorm); // Liberta a cópia criada por normString
-    return hash;
-}
-
-/**
- * @brief Liberta a memória da chave dos carros por marca
- * 
- * @param chave Chave
- */
-void freeChaveCarroMarca(void *chave) {
-    if (!chave) return;
-
-    char *key = (char *)chave;
-    free(key);
+    return *(uint16_t *)chave;
 }
 
 /**
  * @brief Compara as chaves dos carros pela marca
  * 
  * @param chave Chave
- * @param carro Carro
+ * @param chave2 Chave 2
  * @return int -1 se erro, 0 se iguais, 1 se diferente
  */
 int compChaveCarroMarca(void *chave, void *chave2) {
     if (!chave || !chave2) return -1;
 
-    char *key = (char *)chave;
-    char *key2 = (char *)chave2;
-
-    if (stricmpSafe(key, key2) == 0) {
-        return 0;
-    }
+    if (*(uint16_t *)chave == *(uint16_t *)chave2) return 0;
     return 1;
 } 
 
@@ -356,35 +414,18 @@ void guardarChaveCarroCod(void *chave, FILE *file) {
 }
 
 /**
- * @brief Lê a chave do carro por código
- * 
- * @param file Ficheiro binário, aberto
- * @return void* chave ou NULL se erro
- */
-void *readChaveCarroCod(FILE *file) {
-    if (!file) return NULL;
-
-    int *chave = (int *)malloc(sizeof(int));
-    if (!chave) return NULL;
-    fread(chave, sizeof(int), 1, file);
-    
-    return (void *)chave;
-}
-
-/**
- * @brief Cria uma chave para um carro pelo código
+ * @brief Obtém a chave de um carro pelo código
  * 
  * @param carro Carro
  * @return void* chave ou NULL se erro
+ * 
+ * @note Chave inline (sizeof(int)): devolve o endereço do código no próprio carro, não aloca memória
  */
 void *criarChaveCarroCod(void *carro) {
     if (!carro) return NULL;
 
     Carro *x = (Carro *)carro;
-    int *chave = (int *)malloc(sizeof(int));
-    *chave = x->codVeiculo;
-
-    return (void *)chave;
+    return (void *)&x->codVeiculo;
 }
 
 /**
@@ -400,18 +441,6 @@ int hashChaveCarroCod(void *chave) {
     return *key;
 }
 
-/**
- * @brief Liberta a memória alocada para a chave dos carros por código
- * 
- * @param chave Chave
- */
-void freeChaveCarroCod(void *chave) {
-    if (!chave) return;
-
-    int *key = (int *)chave;
-    free(key);
-}
-
 /**
  * @brief Compara as chaves dos carros pelo código
  * 
@@ -430,47 +459,32 @@ int compChaveCarroCod(void *chave, void *chave2) {
 }
 
 /**
- * @brief Cria uma chave para o carro por matrícula
+ * @brief Obtém a chave de um carro por matrícula
  * 
  * @param carro Carro
  * @return void* Chave(tipo void) ou NULL se erro
  * 
- * @note Coloca a chave em minúscula
+ * @note Chave inline (sizeof(uint32_t)): devolve o endereço da matrícula codificada no próprio carro, não aloca memória
+ * @note Para pesquisar, a matrícula deve ser codificada com codificarMatricula
  */
-void *criarChaveCarroMatricula(void *matricula) {
-    if (!matricula) return NULL;
+void *criarChaveCarroMatricula(void *carro) {
+    if (!carro) return NULL;
 
-    Carro *x = (Carro *)matricula;
+    Carro *x = (Carro *)carro;
 
-    return (void *)strlwrSafe(x->matricula);
+    return (void *)&x->codMatricula;
 }
 
 /**
  * @brief Função de hash para o carro por matricula
  * 
- * @param chave Chave (matrícula)
+ * @param chave Chave (matrícula codificada)
  * @return int hash ou -1 se erro
  */
 int hashChaveCarroMatricula(void *chave) {
     if (!chave) return -1;
 
-    char *key = (char *)chave;
-    char *matNorm = normString(key);
-    int hash = hashString(matNorm);
-    free(matNorm); // Liberta a cópia criada por normString
-    return hash;
-}
-
-/**
- * @brief Liberta a memória da chave dos carros por matrícula
- * 
- * @param chave Chave
- */
-void freeChaveCarroMatricula(void *chave) {
-    if (!chave) return;
-
-    char *key = (char *)chave;
-    free(key);
+    return (int)(*(uint32_t *)chave & INT_MAX);
 }
 
 /**
@@ -483,12 +497,7 @@ void freeChaveCarroMatricula(void *chave) {
 int compChaveCarroMatricula(void *chave, void *chave2) {
     if (!chave || !chave2) return -1;
 
-    char *key = (char *)chave;
-    char *key2 = (char *)chave2;
-
-    if (stricmpSafe(key, key2) == 0) {
-        return 0;
-    }
+    if (*(uint32_t *)chave == *(uint32_t *)chave2) return 0;
     return 1;
 } 
 
@@ -508,74 +517,6 @@ int compMatCarro(void *carro, void *matricula) {
     return strcmp(x->matricula, mat);
 }
 
-/**
- * @brief Compara as chaves dos carros pelos rankings (ints)
- * 
- * @param chave Chave
- * @param carro Carro
- * @return int -1 se erro, 0 se igual, 1 se diferente
- * 
- * @note Ordena por ordem descrescente (mais primeiro)
- */
-int compChaveCarroRankingInt(void *chave, void *chave2) {
-    if (chave == NULL && chave2 == NULL) return 0;
-    if (chave == NULL) return -1; //NULL < qualquer coisa
-    if (chave2 == NULL) return 1;
-
-    int *key = (int *)chave;
-    int *key2 = (int *)chave2;
-
-    if (*key < *key2) return 1;
-    else if (*key > *key2) return -1;
-    return 0;
-}
-
-/**
- * @brief Compara as chaves dos carros pelos rankings (floats)
- * 
- * @param chave Chave
- * @param carro Carro
- * @return int -1 se erro, 0 se igual, 1 se diferente
- * 
- * @note Ordena por ordem descrescente (mais primeiro)
- */
-int compChaveCarroRankingFloat(void *chave, void *chave2) {
-    if (chave == NULL && chave2 == NULL) return 0;
-    if (chave == NULL) return -1; //NULL < qualquer coisa
-    if (chave2 == NULL) return 1;
-
-    float *key = (float *)chave;
-    float *key2 = (float *)chave2;
-
-    if (*key < *key2) return 1;
-    else if (*key > *key2) return -1;
-    return 0;
-}
-
-/**
- * @brief Liberta a memória alocada para uma chave de carro por ranking (ints)
- * 
- * @param chave Chave
- */
-void freeChaveCarroRankingInt(void *chave) {
-    if (!chave) return;
-
-    int *key = (int *)chave;
-    free(key);
-}
-
-/**
- * @brief Liberta a memória alocada para uma chave de carro por ranking
- * 
- * @param chave Chave
- */
-void freeChaveCarroRankingFloat(void *chave) {
-    if (!chave) return;
-
-    float *key = (float *)chave;
-    free(key);
-}
-
 /**
  * @brief Compara os carros pela marca
  * 
@@ -590,15 +531,10 @@ int compCarroMarca (void *carro1, void *carro2) {
 
     Carro *x = (Carro *)carro1;
     Carro *y = (Carro *)carro2;
-    char *xNorm = normString(x->marca);
-    char *yNorm = normString(y->marca);
 
-    int res = strcmp(xNorm, yNorm);
+    if (x->idMarca == y->idMarca) return 0;
 
-    free(xNorm);
-    free(yNorm);
-
-    return res;
+    return strcmp(chaveInternada(marcasCarros, x->idMarca), chaveInternada(marcasCarros, y->idMarca));
 }
 
 /**
@@ -616,7 +552,21 @@ int compCarroMatricula(void *carro1, void *carro2) {
     Carro *x = (Carro *)carro1;
     Carro *y = (Carro *)carro2;
 
-    return stricmpSafe(x->matricula, y->matricula);
+    if (x->codMatricula < y->codMatricula) return -1;
+    if (x->codMatricula > y->codMatricula) return 1;
+    return 0;
+}
+
+/**
+ * @brief Chave de ordenação dos carros pela matrícula
+ * 
+ * @param carro Carro
+ * @return uint32_t Matrícula codificada (ver codificarMatricula)
+ */
+uint32_t chaveOrdenacaoCarroMatricula(void *carro) {
+    if (!carro) return 0;
+
+    return ((Carro *)carro)->codMatricula;
 }
 
 /**
@@ -634,7 +584,9 @@ int compCarroModelo(void *carro1, void *carro2) {
     Carro *x = (Carro *)carro1;
     Carro *y = (Carro *)carro2;
 
-    return stricmpSafe(x->modelo, y->modelo);
+    if (x->idModelo == y->idModelo) return 0;
+
+    return stricmpSafe(modeloCarro(x), modeloCarro(y));
 }
 
 /**
@@ -659,9 +611,9 @@ void printCarroXML(void *carro, int indentacao, FILE *file) {
     indent(indentacao + 1, file);
     fprintf(file, "<ano>%d</ano>\n", c->ano);
     indent(indentacao + 1, file);
-    fprintf(file, "<marca>%s</marca>\n", c->marca ? c->marca : "n/a");
+    fprintf(file, "<marca>%s</marca>\n", marcaCarro(c));
     indent(indentacao + 1, file);
-    fprintf(file, "<modelo>%s</modelo>\n", c->modelo ? c->modelo : "n/a");
+    fprintf(file, "<modelo>%s</modelo>\n", modeloCarro(c));
     indent(indentacao + 1, file);
     if (c->ptrPessoa) fprintf(file, "<nifDono>%d</nifDono>\n", c->ptrPessoa->nif);
     else fprintf(file, "<nifDono>%s</nifDono>\n", "n/a");
@@ -692,8 +644,8 @@ void printCarroCSV(void *carro, FILE *file) {
 
     Carro *c = (Carro *)carro;
 
-    fprintf(file, "%d, %hd, %s, %s, %s, %d\n", c->codVeiculo, c->ano, c->matricula, c->marca ? c->marca : "n/a", 
-        c->modelo ? c->modelo : "n/a", c->ptrPessoa ? c->ptrPessoa->nif : -1);
+    fprintf(file, "%d, %hd, %s, %s, %s, %d\n", c->codVeiculo, c->ano, c->matricula, marcaCarro(c), 
+        modeloCarro(c), c->ptrPessoa ? c->ptrPessoa->nif : -1);
 }
 
 /**
@@ -718,8 +670,8 @@ void printCarroTXT(void *carro, FILE *file) {
 
     Carro *c = (Carro *)carro;
 
-    fprintf(file, "%d\t%hd\t%s\t%s\t%s\t%d\n", c->codVeiculo, c->ano, c->matricula, c->marca ? c->marca : "n/a", 
-        c->modelo ? c->modelo : "n/a", c->ptrPessoa ? c->ptrPessoa->nif : -1);
+    fprintf(file, "%d\t%hd\t%s\t%s\t%s\t%d\n", c->codVeiculo, c->ano, c->matricula, marcaCarro(c), 
+        modeloCarro(c), c->ptrPessoa ? c->ptrPessoa->nif : -1);
 }
 
 /**
@@ -760,7 +712,7 @@ void printCarroHTML(void *carro, FILE *file) {
         "\t\t\t\t\t\t<th>%s</th>\n"
         "\t\t\t\t\t\t<th>%s</th>\n"
         "\t\t\t\t\t\t<th>%d</th>\n"
-        "\t\t\t\t\t</tr>\n", c->codVeiculo, c->ano, c->matricula, c->marca ? c->marca : "n/a", c->modelo ? c->modelo : "n/a", c->ptrPessoa ? c->ptrPessoa->nif : -1);
+        "\t\t\t\t\t</tr>\n", c->codVeiculo, c->ano, c->matricula, marcaCarro(c), modeloCarro(c), c->ptrPessoa ? c->ptrPessoa->nif : -1);
 }
 
 /**
@@ -796,14 +748,14 @@ void printCarroRanking(NoRankings *no, void (*printCompObj)(void *compInfo, FILE
     }
 
     // Processa marca
-    if (strlen(c->marca) > (size_t) WIDTH_MARCA - 3) {
-        strncpy(marcaStr, c->marca, WIDTH_MARCA - 3);
+    if (strlen(marcaCarro(c)) > (size_t) WIDTH_MARCA - 3) {
+        strncpy(marcaStr, marcaCarro(c), WIDTH_MARCA - 3);
         marcaStr[WIDTH_MARCA - 3] = '.';
         marcaStr[WIDTH_MARCA - 2] = '.';
         marcaStr[WIDTH_MARCA - 1] = '.';
         marcaStr[WIDTH_MARCA] = '\0';
     } else {
-        strcpy(marcaStr, c->marca);
+        strcpy(marcaStr, marcaCarro(c));
     }
     
     // Dados alinhados com as mesmas larguras
@@ -828,7 +780,7 @@ void printCarroRankingTXT(NoRankings *no, void (*printCompObj)(void *compInfo, F
 
     Carro *c = (Carro *)no->mainInfo;
     
-    fprintf(file, "\t%s\t%s\t%s", c->matricula, c->ptrPessoa ? c->ptrPessoa->nome : "n/a", c->marca);
+    fprintf(file, "\t%s\t%s\t%s", c->matricula, c->ptrPessoa ? c->ptrPessoa->nome : "n/a", marcaCarro(c));
             
     if (printCompObj) {
         fprintf(file, "\t");
@@ -850,7 +802,7 @@ void printCarroRankingCSV(NoRankings *no, void (*printCompObj)(void *compInfo, F
 
     Carro *c = (Carro *)no->mainInfo;
     
-    fprintf(file, ", %s, %s, %s", c->matricula, c->ptrPessoa ? c->ptrPessoa->nome : "n/a", c->marca);
+    fprintf(file, ", %s, %s, %s", c->matricula, c->ptrPessoa ? c->ptrPessoa->nome : "n/a", marcaCarro(c));
             
     if (printCompObj) {
         fprintf(file, ", ");
@@ -876,14 +828,14 @@ void printMarcaRanking(NoRankings *no, void (*printCompObj)(void *compInfo, FILE
     
     // Processa marca
     char marcaStr[WIDTH_MARCA + 1];
-    if (strlen(c->marca) > (size_t) WIDTH_MARCA - 3) {
-        strncpy(marcaStr, c->marca, WIDTH_MARCA - 3);
+    if (strlen(marcaCarro(c)) > (size_t) WIDTH_MARCA - 3) {
+        strncpy(marcaStr, marcaCarro(c), WIDTH_MARCA - 3);
         marcaStr[WIDTH_MARCA - 3] = '.';
         marcaStr[WIDTH_MARCA - 2] = '.';
         marcaStr[WIDTH_MARCA - 1] = '.';
         marcaStr[WIDTH_MARCA] = '\0';
     } else {
-        strcpy(marcaStr, c->marca);
+        strcpy(marcaStr, marcaCarro(c));
     }
     
     // Mostra apenas a marca
@@ -908,7 +860,7 @@ void printMarcaRankingTXT(NoRankings *no, void (*printCompObj)(void *compInfo, F
 
     Carro *c = (Carro *)no->mainInfo;
     
-    fprintf(file, "\t%s", c->marca ? c->marca : "n/a");
+    fprintf(file, "\t%s", marcaCarro(c));
             
     if (printCompObj) {
         fprintf(file, "\t");
@@ -930,7 +882,7 @@ void printMarcaRankingCSV(NoRankings *no, void (*printCompObj)(void *compInfo, F
 
     Carro *c = (Carro *)no->mainInfo;
     
-    fprintf(file, ", %s", c->marca ? c->marca : "n/a");
+    fprintf(file, ", %s", marcaCarro(c));
             
     if (printCompObj) {
         fprintf(file, ", ");
@@ -1091,13 +1043,13 @@ if (!file) return;
  * @param carrosMarca Dicionário
  * @return char* Marca mais comum ou NULL se erro
  */
-char *obterMarcaMaisComum(Dict *carrosMarca) {
+const char *obterMarcaMaisComum(Dict *carrosMarca) {
     if (!carrosMarca) return NULL;
 
     Lista *maisElementos = NULL;
-    for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-        NoHashing *p = carrosMarca->tabela[i];
-        if (p && p->dados) {
+    for (int i = 0; i < carrosMarca->capacidade; i++) {
+        NoHashing *p = &carrosMarca->tabela[i];
+        if (p->dados) {
             if (!maisElementos) {
                 maisElementos = p->dados;
             }
@@ -1112,7 +1064,7 @@ char *obterMarcaMaisComum(Dict *carrosMarca) {
     Carro *c = (Carro *)maisElementos->inicio->info;
     if (!c) return NULL;
 
-    return c->marca;
+    return marcaCarro(c);
 }
 
 /**
@@ -1121,10 +1073,10 @@ char *obterMarcaMaisComum(Dict *carrosMarca) {
  * @param bd Base de dados 
  * @return char* Marca cuja velocidade média é  maior
  */
-char *obterMarcaMaisVelocidadeMedia(Bdados *bd) {
+const char *obterMarcaMaisVelocidadeMedia(Bdados *bd) {
     if (!bd) return NULL;
 
-    char *marcaMaisRapida = NULL;
+    const char *marcaMaisRapida = NULL;
     float velocidadeMax = 0.0f;
     int contadorViagens = 0;
 
@@ -1133,45 +1085,42 @@ char *obterMarcaMaisVelocidadeMedia(Bdados *bd) {
     float velocidadeMedia = 0.0f;
 
     // Iterar por todas as marcas
-    for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-        NoHashing *p = bd->carrosMarca->tabela[i];
+    for (int i = 0; i < bd->carrosMarca->capacidade; i++) {
+        NoHashing *p = &bd->carrosMarca->tabela[i];
+        if (!p->dados) continue;
+
         // Para cada marca
         tempoTotal = 0.0f;
         distanciaTotal = 0.0f;
         velocidadeMedia = 0.0f;
-        while(p) {
-            if (p->dados) {
-                // Para cada carro na marca
-                No *m = p->dados->inicio;
-                while (m) {
-                    Carro *c = (Carro *)m->info;
+
+        // Para cada carro na marca
+        No *m = p->dados->inicio;
+        while (m) {
+            Carro *c = (Carro *)m->info;
+            
+            No *x = c->viagens->inicio;
+            // Para cada viagem
+            while(x) {
+                if (x->info) {
+                    Viagem *v = (Viagem *)x->info;
                     
-                    No *x = c->viagens->inicio;
-                    // Para cada viagem
-                    while(x) {
-                        if (x->info) {
-                            Viagem *v = (Viagem *)x->info;
-                            
-                            tempoTotal += v->tempo;
-                            distanciaTotal += v->kms;
-                            contadorViagens++;
-                        }
-                        x = x->prox;
-                    }
-                    m = m->prox;
+                    tempoTotal += v->tempo;
+                    distanciaTotal += v->kms;
+                    contadorViagens++;
                 }
+                x = x->prox;
             }
-            p = p->prox;
+            m = m->prox;
         }
 
         // Ver velocidade média e comparar
         if (tempoTotal > 0) {
             velocidadeMedia = distanciaTotal / (tempoTotal / 60.0f);
             if (velocidadeMedia > velocidadeMax) {
-                p = bd->carrosMarca->tabela[i];
                 velocidadeMax = velocidadeMedia;
                 Carro *primeiroCarro = (Carro *)p->dados->inicio->info;
-                marcaMaisRapida = primeiroCarro->marca;
+                marcaMaisRapida = marcaCarro(primeiroCarro);
             }
         }
     }
@@ -1188,52 +1137,8 @@ char *obterMarcaMaisVelocidadeMedia(Bdados *bd) {
 size_t memUsageCarro(void *carro) {
     if (!carro) return 0;
 
-    Carro *c = (Carro *)carro;
-
-    size_t mem = sizeof(Carro);
-    mem += strlen(c->marca) + 1;
-    mem += strlen(c->modelo) + 1;
-
-    return mem;
-}
-
-/**
- * @brief Memória ocupada pela chave dos carros por código
- * 
- * @param chave Chave
- * @return size_t Memória ocupada ou 0 se erro
- */
-size_t memUsageChaveCarroCod(void *chave) {
-    if (!chave) return 0;
-
-    int *key = (int *)chave;
-    return sizeof(*key);
-}
-
-/**
- * @brief Memória ocupada pela chave dos carros por marca
- * 
- * @param chave Chave
- * @return size_t Memória ocupada ou 0 se erro
- */
-size_t memUsageChaveCarroMarca(void *chave) {
-    if (!chave) return 0;
-
-    return sizeof(char);
-}
-
-/**
- * @brief Memória ocupada pela chave dos carros por matrícula
- * 
- * @param chave Chave
- * @return size_t Memória ocupada ou 0 se erro
- */
-size_t memUsageChaveCarroMatricula(void *chave) {
-    if (!chave) return 0;
-
-    char *key = (char *)chave;
+    size_t mem = sizeof(Carro); // As strings são contabilizadas na arena
 
-    size_t mem = strlen(key) + 1;
     return mem;
 }
 
@@ -1296,8 +1201,8 @@ void registarCarro(Bdados *bd) {
                 pressEnter();
                 continue;
             }
-            void *matTemp = (void *)matricula;
-            if (searchDict(bd->carrosMat, matTemp, compChaveCarroMatricula, compCarroMatricula, hashChaveCarroMatricula)) {
+            uint32_t codMatricula = codificarMatricula(matricula);
+            if (searchDict(bd->carrosMat, &codMatricula, compChaveCarroMatricula, compCarroMatricula, hashChaveCarroMatricula)) {
                 printf("Já existe um veículo com a matrícula \"%s\"!\n\n", matricula);
                 free(matricula);
                 pressEnter();
@@ -1414,8 +1319,8 @@ void mudarDonoCarro(Bdados *bd) {
                 pressEnter();
                 continue;
             }
-            void *matTemp = (void *)matricula;
-            c = (Carro *)searchDict(bd->carrosMat, matTemp, compChaveCarroMatricula, compCarroMatricula, hashChaveCarroMatricula);
+            uint32_t codMatricula = codificarMatricula(matricula);
+            c = (Carro *)searchDict(bd->carrosMat, &codMatricula, compChaveCarroMatricula, compCarroMatricula, hashChaveCarroMatricula);
             if (!c) {
                 free(matricula);
                 printf("Não foi encontrado nenhum carro com esta matrícula!\n\n");
@@ -1504,24 +1409,30 @@ void listarCarrosPorMatricula(Bdados *bd) {
     FILE *file = NULL;
     
     char formato[TAMANHO_FORMATO_LISTAGEM];
-    Lista *carrosMat = dictToLista(bd->carrosCod);
-    mergeSortLista(carrosMat, compCarroMatricula);
-    printLista(carrosMat, printCarro, stdout, pausaListagem);
+    int nel = 0;
+    void **carrosMat = dictToArray(bd->carrosCod, &nel);
+    if (!carrosMat) {
+        printf("Ocorreu um erro inesperado! Por favor tente novamente mais tarde!\n");
+        pressEnter();
+        return;
+    }
+    (void)ordenarArrayPorChave(carrosMat, nel, chaveOrdenacaoCarroMatricula);
+    printArray(carrosMat, nel, printCarro, stdout, pausaListagem);
     printf("\n----FIM DE LISTAGEM----\n\n"); 
     
     file = pedirListagemFicheiro(formato);
     if (file) {
         if (strcmp(formato, ".txt") == 0) {
             printHeaderCarrosTXT(file);
-            printLista(carrosMat, printCarroTXT, file, 0);
+            printArray(carrosMat, nel, printCarroTXT, file, 0);
         }
         else if (strcmp(formato, ".csv") == 0) {
             printHeaderCarrosCSV(file);
-            printLista(carrosMat, printCarroCSV, file, 0);
+            printArray(carrosMat, nel, printCarroCSV, file, 0);
         }
         fclose(file);
     }
-    freeLista(carrosMat, NULL);
+    free(carrosMat);
     pressEnter();
 }
 
@@ -1565,24 +1476,30 @@ void listarCarrosPorModelo(Bdados *bd) {
     FILE *file = NULL;
     char formato[TAMANHO_FORMATO_LISTAGEM] = {0};
     
-    Lista *carrosMod = dictToLista(bd->carrosCod);
-    mergeSortLista(carrosMod, compCarroModelo);
-    printLista(carrosMod, printCarro, stdout, pausaListagem);
+    int nel = 0;
+    void **carrosMod = dictToArray(bd->carrosCod, &nel);
+    if (!carrosMod) {
+        printf("Ocorreu um erro inesperado! Por favor tente novamente mais tarde!\n");
+        pressEnter();
+        return;
+    }
+    ordenarArray(carrosMod, nel, compCarroModelo);
+    printArray(carrosMod, nel, printCarro, stdout, pausaListagem);
     printf("\n----FIM DE LISTAGEM----\n");
     
     file = pedirListagemFicheiro(formato);
     if (file) {
         if (strcmp(formato, ".txt") == 0) {
             printHeaderCarrosTXT(file);
-            printLista(carrosMod, printCarroTXT, file, 0);
+            printArray(carrosMod, nel, printCarroTXT, file, 0);
         }
         else if (strcmp(formato, ".csv") == 0) {
             printHeaderCarrosCSV(file);
-            printLista(carrosMod, printCarroCSV, file, 0);
+            printArray(carrosMod, nel, printCarroCSV, file, 0);
         }
         fclose(file);
     }
-    freeLista(carrosMod, NULL);
+    free(carrosMod);
     pressEnter();
 }
 
@@ -1665,10 +1582,139 @@ void listarCarrosPorPeriodoTempo(Bdados *bd) {
     pressEnter();
 }
 
+/**
+ * @brief Contexto passado às funções que preenchem os rankings (permite voltar a percorrer os dados ao expandir o Top-K)
+ */
+typedef struct {
+    Bdados *bd;
+    Data inicio;
+    Data fim;
+    int porPeriodo; // 1 se apenas contam as viagens dentro de [inicio, fim]
+} ContextoRanking;
+
+/**
+ * @brief Adiciona ao ranking cada carro com o seu nº de infrações
+ * 
+ * @param r Ranking (RANKING_INT)
+ * @param contexto ContextoRanking
+ * @return int 1 se sucesso, 0 se erro
+ */
+static int preencherRankingInfracoes(RankingNumerico *r, void *contexto) {
+    ContextoRanking *ctx = (ContextoRanking *)contexto;
+    if (!r || !ctx || !ctx->bd) return 0;
+
+    Dict *carros = ctx->bd->carrosCod;
+    for (int i = 0; i < carros->capacidade; i++) {
+        NoHashing *p = &carros->tabela[i];
+        if (!p->obj) continue;
+
+        Carro *c = (Carro *)p->obj;
+
+        int infracoes = 0;
+
+        if (c->viagens) {
+            No *l = c->viagens->inicio;
+            while(l) {
+                Viagem *v = (Viagem *)l->info;
+                
+                if (!ctx->porPeriodo || (compararDatas(ctx->fim, v->entrada->data) >= 0 && compararDatas(ctx->inicio, v->saida->data) <= 0)) {
+                    if (v->velocidadeMedia > MAX_VELOCIDADE_AE || v->velocidadeMedia < MIN_VELOCIDADE_AE) {
+                        infracoes++;
+                    }
+                }
+                l = l->prox;
+            }
+        }
+        if (infracoes > 0) {
+            if (!addToRankingInt(r, (void *)c, infracoes)) return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Adiciona ao ranking cada carro com os quilómetros percorridos no período
+ * 
+ * @param r Ranking (RANKING_FLOAT)
+ * @param contexto ContextoRanking
+ * @return int 1 se sucesso, 0 se erro
+ */
+static int preencherRankingKMSPeriodo(RankingNumerico *r, void *contexto) {
+    ContextoRanking *ctx = (ContextoRanking *)contexto;
+    if (!r || !ctx || !ctx->bd) return 0;
+
+    Dict *carros = ctx->bd->carrosCod;
+    for (int i = 0; i < carros->capacidade; i++) {
+        NoHashing *p = &carros->tabela[i];
+        if (!p->obj) continue;
+
+        Carro *c = (Carro *)p->obj;
+
+        float kmsPercorridos = 0;
+
+        if (c->viagens) {
+            No *l = c->viagens->inicio;
+            while(l) {
+                Viagem *v = (Viagem *)l->info;
+                
+                if (compararDatas(ctx->fim, v->entrada->data) >= 0 && compararDatas(ctx->inicio, v->saida->data) <= 0) {
+                    kmsPercorridos += v->kms;
+                }
+                l = l->prox;
+            }
+        }
+        if (kmsPercorridos > 0) {
+            if (!addToRankingFloat(r, (void *)c, kmsPercorridos)) return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Adiciona ao ranking cada marca (representada por um dos seus carros) com o total de quilómetros percorridos
+ * 
+ * @param r Ranking (RANKING_FLOAT)
+ * @param contexto ContextoRanking
+ * @return int 1 se sucesso, 0 se erro
+ */
+static int preencherRankingKMSMarca(RankingNumerico *r, void *contexto) {
+    ContextoRanking *ctx = (ContextoRanking *)contexto;
+    if (!r || !ctx || !ctx->bd) return 0;
+
+    Dict *marcas = ctx->bd->carrosMarca;
+    for (int i = 0; i < marcas->capacidade; i++) {
+        NoHashing *p = &marcas->tabela[i];
+        if (!p->dados) continue;
+
+        No *m = p->dados->inicio;
+        float kmsPercorridos = 0;
+        while(m) {
+            Carro *c = (Carro *)m->info;
+
+            if (c->viagens) {
+                No *l = c->viagens->inicio;
+                while(l) {
+                    Viagem *v = (Viagem *)l->info;
+                    
+                    kmsPercorridos += v->kms;
+                    l = l->prox;
+                }
+            }
+            m = m->prox;
+        }
+        if (kmsPercorridos > 0) {
+            if (!addToRankingFloat(r, p->dados->inicio->info, kmsPercorridos)) return 0; // colocamos um dos carros (obtemos a marca por ele)
+        }
+    }
+    return 1;
+}
+
 /**
  * @brief Lista as infrações de um dado período de tempo
  * 
  * @param bd Base de dados
+ * 
+ * @note Só as pausaListagem primeiras posições são calculadas à partida (Top-K); o resto apenas se o utilizador avançar
  */
 void listarInfracoesPorPeriodoTempo(Bdados *bd) {
     if (!bd) return;
@@ -1677,70 +1723,32 @@ void listarInfracoesPorPeriodoTempo(Bdados *bd) {
     FILE *file = NULL;
     char formato[TAMANHO_FORMATO_LISTAGEM] = {0};
     
-    Data inicio = {0,0,0,0,0,0.0f};
-    Data fim = {0,0,0,0,0,0.0f};
-    pedirPeriodoTempo(&inicio, &fim, "Insira a data inicial: ", "Insira a data final: ");
+    ContextoRanking ctx = {bd, {0,0,0,0,0,0.0f}, {0,0,0,0,0,0.0f}, 1};
+    pedirPeriodoTempo(&ctx.inicio, &ctx.fim, "Insira a data inicial: ", "Insira a data final: ");
 
-    Ranking *r = criarRanking();
-    if (!r) {
+    RankingNumerico *r = criarRankingTopK(RANKING_INT, pausaListagem, preencherRankingInfracoes, &ctx);
+    if (!r || !preencherRankingNumerico(r)) {
+        freeRankingNumerico(r);
         printf("Ocorreu um erro inesperado! Por favor tente novamente mais tarde!\n");
         pressEnter();
+        return;
     }
 
-    for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-        NoHashing *p = bd->carrosCod->tabela[i];
-        while(p) {
-            if (p->dados) {
-                No *m = p->dados->inicio;
-                while(m) {
-                    Carro *c = (Carro *)m->info;
-
-                    int infracoes = 0;
-
-                    if (c->viagens) {
-                        No *l = c->viagens->inicio;
-                        while(l) {
-                            Viagem *v = (Viagem *)l->info;
-                            
-                            if (compararDatas(fim, v->entrada->data) >= 0 && compararDatas(inicio, v->saida->data) <= 0) {
-                                if (v->velocidadeMedia > MAX_VELOCIDADE_AE || v->velocidadeMedia < MIN_VELOCIDADE_AE) {
-                                    infracoes++;
-                                }
-                            }
-                            l = l->prox;
-                        }
-                    }
-                    if (infracoes > 0) {
-                        int *infr = (int *)malloc(sizeof(int));
-                        *infr = infracoes;
-
-                        void *temp = (void *)infr;
-                        addToRanking(r, (void *)c, temp);
-                    }
-                    m = m->prox;
-                }
-            }
-            p = p->prox;
-        }
-    }
-
-    mergeSortRanking(r, compChaveCarroRankingInt);
-
-    printRanking(r, printCarroRanking, printHeaderCarroMaisInfracoes, printMaisInfracoes, stdout, pausaListagem);
+    printRankingNumerico(r, printCarroRanking, printHeaderCarroMaisInfracoes, printMaisInfracoes, stdout, pausaListagem);
 
     printf("\n----FIM DE LISTAGEM----\n");
 
     file = pedirListagemFicheiro(formato);
     if (file) {
         if (strcmp(formato, ".txt") == 0) {
-            printRanking(r, printCarroRankingTXT, printHeaderCarroMaisInfracoesTXT, printMaisInfracoes, file, pausaListagem);
+            printRankingNumerico(r, printCarroRankingTXT, printHeaderCarroMaisInfracoesTXT, printMaisInfracoes, file, pausaListagem);
         }
         else if (strcmp(formato, ".csv") == 0) {
-            printRanking(r, printCarroRankingCSV, printHeaderCarroMaisInfracoesCSV, printMaisInfracoes, file, pausaListagem);
+            printRankingNumerico(r, printCarroRankingCSV, printHeaderCarroMaisInfracoesCSV, printMaisInfracoes, file, pausaListagem);
         }
         fclose(file);
     }
-    freeRanking(r, NULL, freeChaveCarroRankingInt);
+    freeRankingNumerico(r);
     pressEnter();
 }
 
@@ -1748,6 +1756,8 @@ void listarInfracoesPorPeriodoTempo(Bdados *bd) {
  * @brief Ranking das infrações
  * 
  * @param bd Base de dados
+ * 
+ * @note Top-K de pausaListagem posições, expandido apenas se o utilizador avançar
  */
 void rankingInfracoes(Bdados *bd) {
     if (!bd) return;
@@ -1756,64 +1766,31 @@ void rankingInfracoes(Bdados *bd) {
     FILE *file = NULL;
     char formato[TAMANHO_FORMATO_LISTAGEM] = {0};
 
-    Ranking *r = criarRanking();
-    if (!r) {
+    ContextoRanking ctx = {bd, {0,0,0,0,0,0.0f}, {0,0,0,0,0,0.0f}, 0};
+
+    RankingNumerico *r = criarRankingTopK(RANKING_INT, pausaListagem, preencherRankingInfracoes, &ctx);
+    if (!r || !preencherRankingNumerico(r)) {
+        freeRankingNumerico(r);
         printf("Ocorreu um erro inesperado! Por favor tente novamente mais tarde!\n");
         pressEnter();
+        return;
     }
 
-    for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-        NoHashing *p = bd->carrosCod->tabela[i];
-        while(p) {
-            if (p->dados) {
-                No *m = p->dados->inicio;
-                while(m) {
-                    Carro *c = (Carro *)m->info;
-
-                    int infracoes = 0;
-
-                    if (c->viagens) {
-                        No *l = c->viagens->inicio;
-                        while(l) {
-                            Viagem *v = (Viagem *)l->info;
-                            
-                            if (v->velocidadeMedia > MAX_VELOCIDADE_AE || v->velocidadeMedia < MIN_VELOCIDADE_AE) {
-                                infracoes++;
-                            }
-                            l = l->prox;
-                        }
-                    }
-                    if (infracoes > 0) {
-                        int *infr = (int *)malloc(sizeof(int));
-                        *infr = infracoes;
-
-                        void *temp = (void *)infr;
-                        addToRanking(r, (void *)c, temp);
-                    }
-                    m = m->prox;
-                }
-            }
-            p = p->prox;
-        }
-    }
-
-    mergeSortRanking(r, compChaveCarroRankingInt);
-
-    printRanking(r, printCarroRanking, printHeaderCarroMaisInfracoes, printMaisInfracoes, stdout, pausaListagem);
+    printRankingNumerico(r, printCarroRanking, printHeaderCarroMaisInfracoes, printMaisInfracoes, stdout, pausaListagem);
 
     printf("\n----FIM DE LISTAGEM----\n");
 
     file = pedirListagemFicheiro(formato);
     if (file) {
         if (strcmp(formato, ".txt") == 0) {
-            printRanking(r, printCarroRankingTXT, printHeaderCarroMaisInfracoesTXT, printMaisInfracoes, file, pausaListagem);
+            printRankingNumerico(r, printCarroRankingTXT, printHeaderCarroMaisInfracoesTXT, printMaisInfracoes, file, pausaListagem);
         }
         else if (strcmp(formato, ".csv") == 0) {
-            printRanking(r, printCarroRankingCSV, printHeaderCarroMaisInfracoesCSV, printMaisInfracoes, file, pausaListagem);
+            printRankingNumerico(r, printCarroRankingCSV, printHeaderCarroMaisInfracoesCSV, printMaisInfracoes, file, pausaListagem);
         }
         fclose(file);
     }
-    freeRanking(r, NULL, freeChaveCarroRankingInt);
+    freeRankingNumerico(r);
     pressEnter();
 }
 
@@ -1821,6 +1798,8 @@ void rankingInfracoes(Bdados *bd) {
  * @brief Ranking do total de quilómetros percorridos por cada veículo num dado período de tempo
  * 
  * @param bd Base de dados
+ * 
+ * @note Top-K de pausaListagem posições, expandido apenas se o utilizador avançar
  */
 void rankingKMSPeriodoTempo(Bdados *bd) {
     if (!bd) return;
@@ -1829,68 +1808,32 @@ void rankingKMSPeriodoTempo(Bdados *bd) {
     FILE *file = NULL;
     char formato[TAMANHO_FORMATO_LISTAGEM] = {0};
     
-    Data inicio = {0,0,0,0,0,0.0f};
-    Data fim = {0,0,0,0,0,0.0f};
-    pedirPeriodoTempo(&inicio, &fim, "Insira a data inicial: ", "Insira a data final: ");
+    ContextoRanking ctx = {bd, {0,0,0,0,0,0.0f}, {0,0,0,0,0,0.0f}, 1};
+    pedirPeriodoTempo(&ctx.inicio, &ctx.fim, "Insira a data inicial: ", "Insira a data final: ");
 
-    Ranking *r = criarRanking();
-    if (!r) {
+    RankingNumerico *r = criarRankingTopK(RANKING_FLOAT, pausaListagem, preencherRankingKMSPeriodo, &ctx);
+    if (!r || !preencherRankingNumerico(r)) {
+        freeRankingNumerico(r);
         printf("Ocorreu um erro inesperado! Por favor tente novamente mais tarde!\n");
         pressEnter();
+        return;
     }
 
-    for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-        NoHashing *p = bd->carrosCod->tabela[i];
-        while(p) {
-            if (p->dados) {
-                No *m = p->dados->inicio;
-                while(m) {
-                    Carro *c = (Carro *)m->info;
-
-                    float kmsPercorridos = 0;
-
-                    if (c->viagens) {
-                        No *l = c->viagens->inicio;
-                        while(l) {
-                            Viagem *v = (Viagem *)l->info;
-                            
-                            if (compararDatas(fim, v->entrada->data) >= 0 && compararDatas(inicio, v->saida->data) <= 0) {
-                                kmsPercorridos += v->kms;
-                            }
-                            l = l->prox;
-                        }
-                    }
-                    if (kmsPercorridos > 0) {
-                        float *kms = (float *)malloc(sizeof(float));
-                        *kms = kmsPercorridos;
-
-                        void *temp = (void *)kms;
-                        addToRanking(r, (void *)c, temp);
-                    }
-                    m = m->prox;
-                }
-            }
-            p = p->prox;
-        }
-    }
-
-    mergeSortRanking(r, compChaveCarroRankingFloat);
-
-    printRanking(r, printCarroRanking, printHeaderCarroMaisKMS, printMaisKMS, stdout, pausaListagem);
+    printRankingNumerico(r, printCarroRanking, printHeaderCarroMaisKMS, printMaisKMS, stdout, pausaListagem);
 
     printf("\n----FIM DE LISTAGEM----\n");
 
     file = pedirListagemFicheiro(formato);
     if (file) {
         if (strcmp(formato, ".txt") == 0) {
-            printRanking(r, printCarroRankingTXT, printHeaderCarroMaisKMS_TXT, printMaisKMS, file, pausaListagem);
+            printRankingNumerico(r, printCarroRankingTXT, printHeaderCarroMaisKMS_TXT, printMaisKMS, file, pausaListagem);
         }
         else if (strcmp(formato, ".csv") == 0) {
-            printRanking(r, printCarroRankingCSV, printHeaderCarroMaisKMS_CSV, printMaisKMS_CSV, file, pausaListagem);
+            printRankingNumerico(r, printCarroRankingCSV, printHeaderCarroMaisKMS_CSV, printMaisKMS_CSV, file, pausaListagem);
         }
         fclose(file);
     }
-    freeRanking(r, NULL, freeChaveCarroRankingFloat);
+    freeRankingNumerico(r);
     pressEnter();
 }
 
@@ -1906,62 +1849,31 @@ void rankingKMSMarca(Bdados *bd) {
     FILE *file = NULL;
     char formato[TAMANHO_FORMATO_LISTAGEM] = {0};
 
-    Ranking *r = criarRanking();
-    if (!r) {
+    ContextoRanking ctx = {bd, {0,0,0,0,0,0.0f}, {0,0,0,0,0,0.0f}, 0};
+
+    RankingNumerico *r = criarRankingTopK(RANKING_FLOAT, pausaListagem, preencherRankingKMSMarca, &ctx);
+    if (!r || !preencherRankingNumerico(r)) {
+        freeRankingNumerico(r);
         printf("Ocorreu um erro inesperado! Por favor tente novamente mais tarde!\n");
         pressEnter();
+        return;
     }
 
-    for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-        NoHashing *p = bd->carrosMarca->tabela[i];
-        while(p) {
-            if (p->dados) {
-                No *m = p->dados->inicio;
-                float kmsPercorridos = 0;
-                while(m) {
-                    Carro *c = (Carro *)m->info;
-
-                    if (c->viagens) {
-                        No *l = c->viagens->inicio;
-                        while(l) {
-                            Viagem *v = (Viagem *)l->info;
-                            
-                            kmsPercorridos += v->kms;
-                            l = l->prox;
-                        }
-                    }
-                    m = m->prox;
-                }
-                if (kmsPercorridos > 0) {
-                    m = p->dados->inicio;
-                    float *kms = (float *)malloc(sizeof(float));
-                    *kms = kmsPercorridos;
-
-                    void *temp = (void *)kms;
-                    addToRanking(r, m->info, temp); // colocamos um dos carros (obtemos a marca por ele)
-                }
-            }
-            p = p->prox;
-        }
-    }
-
-    mergeSortRanking(r, compChaveCarroRankingFloat);
-
-    printRanking(r, printMarcaRanking, printHeaderMarcaMaisKMS, printMaisKMS, stdout, pausaListagem);
+    printRankingNumerico(r, printMarcaRanking, printHeaderMarcaMaisKMS, printMaisKMS, stdout, pausaListagem);
 
     printf("\n----FIM DE LISTAGEM----\n");
 
     file = pedirListagemFicheiro(formato);
     if (file) {
         if (strcmp(formato, ".txt") == 0) {
-            printRanking(r, printMarcaRankingTXT, printHeaderMarcaMaisKMS_TXT, printMaisKMS, file, pausaListagem);
+            printRankingNumerico(r, printMarcaRankingTXT, printHeaderMarcaMaisKMS_TXT, printMaisKMS, file, pausaListagem);
         }
         else if (strcmp(formato, ".csv") == 0) {
-            printRanking(r, printMarcaRankingCSV, printHeaderMarcaMaisKMS_CSV, printMaisKMS_CSV, file, pausaListagem);
+            printRankingNumerico(r, printMarcaRankingCSV, printHeaderMarcaMaisKMS_CSV, printMaisKMS_CSV, file, pausaListagem);
         }
         fclose(file);
     }
-    freeRanking(r, NULL, freeChaveCarroRankingFloat);
+    freeRankingNumerico(r);
     pressEnter();
 }
 
@@ -1978,53 +1890,43 @@ void listarCarrosComInfracoes(Bdados *bd) {
 
     int count = 0;
 
-    for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-        NoHashing *p = bd->carrosCod->tabela[i];
-        while(p && listagemFlag == 0) {
-            if (p->dados) {
-                No *l = p->dados->inicio;
-                while(l && listagemFlag == 0) {
-                    Carro *c = (Carro *)l->info;
-                    if (c->viagens) {
-                        No *m = c->viagens->inicio;
-                        while(m && listagemFlag == 0) {
-                            Viagem *v = (Viagem *)m->info;
-                            if (v->velocidadeMedia > MAX_VELOCIDADE_AE || v->velocidadeMedia < MIN_VELOCIDADE_AE) {
-                                printf("Matrícula: %s\n\n", c->matricula);
-                                count++;
-                                if (count % pausaListagem == 0) {
-                                    printf("\n");
-                                    int opcao = enter_espaco_esc();
-                                    switch (opcao) {
-                                        case 0:
-                                            break;
-                                        case 1:
-                                            while(count < bd->carrosCod->nelDict - pausaListagem || !p) {
-                                                if (!p) {
-                                                    p = bd->carrosCod->tabela[++i];
-                                                }
-                                                else {
-                                                    p = p->prox;
-                                                    count++;
-                                                }
-                                            }
-                                            break;
-                                        case 2:
-                                            listagemFlag = 1;
-                                            break;
-                                        default:
-                                            break;
+    for (int i = 0; i < bd->carrosCod->capacidade && listagemFlag == 0; i++) {
+        NoHashing *p = &bd->carrosCod->tabela[i];
+        if (!p->obj) continue;
+
+        Carro *c = (Carro *)p->obj;
+        if (c->viagens) {
+            No *m = c->viagens->inicio;
+            while(m && listagemFlag == 0) {
+                Viagem *v = (Viagem *)m->info;
+                if (v->velocidadeMedia > MAX_VELOCIDADE_AE || v->velocidadeMedia < MIN_VELOCIDADE_AE) {
+                    printf("Matrícula: %s\n\n", c->matricula);
+                    count++;
+                    if (count % pausaListagem == 0) {
+                        printf("\n");
+                        int opcao = enter_espaco_esc();
+                        switch (opcao) {
+                            case 0:
+                                break;
+                            case 1:
+                                // Avançar posições até restarem menos de pausaListagem carros
+                                while(count < bd->carrosCod->nelDict - pausaListagem && i < bd->carrosCod->capacidade - 1) {
+                                    if (bd->carrosCod->tabela[++i].obj) {
+                                        count++;
                                     }
                                 }
                                 break;
-                            }
-                            m = m->prox;
+                            case 2:
+                                listagemFlag = 1;
+                                break;
+                            default:
+                                break;
                         }
                     }
-                    l = l->prox;
+                    break;
                 }
+                m = m->prox;
             }
-            p = p->prox;
         }
     }
     printf("\n----FIM DE LISTAGEM----\n");
@@ -2036,28 +1938,21 @@ void listarCarrosComInfracoes(Bdados *bd) {
     file = pedirListagemFicheiro(formato);
     if (file) {
         fprintf(file, "Matrícula\n");
-        for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-            NoHashing *p = bd->carrosCod->tabela[i];
-            while(p && listagemFlag == 0) {
-                if (p->dados) {
-                    No *l = p->dados->inicio;
-                    while(l && listagemFlag == 0) {
-                        Carro *c = (Carro *)l->info;
-                        if (c->viagens) {
-                            No *m = c->viagens->inicio;
-                            while(m && listagemFlag == 0) {
-                                Viagem *v = (Viagem *)m->info;
-                                if (v->velocidadeMedia > MAX_VELOCIDADE_AE || v->velocidadeMedia < MIN_VELOCIDADE_AE) {
-                                    fprintf(file, "%s\n", c->matricula);
-                                    break;
-                                }
-                                m = m->prox;
-                            }
-                        }
-                        l = l->prox;
+        for (int i = 0; i < bd->carrosCod->capacidade && listagemFlag == 0; i++) {
+            NoHashing *p = &bd->carrosCod->tabela[i];
+            if (!p->obj) continue;
+
+            Carro *c = (Carro *)p->obj;
+            if (c->viagens) {
+                No *m = c->viagens->inicio;
+                while(m && listagemFlag == 0) {
+                    Viagem *v = (Viagem *)m->info;
+                    if (v->velocidadeMedia > MAX_VELOCIDADE_AE || v->velocidadeMedia < MIN_VELOCIDADE_AE) {
+                        fprintf(file, "%s\n", c->matricula);
+                        break;
                     }
+                    m = m->prox;
                 }
-                p = p->prox;
             }
         }
         fclose(file);
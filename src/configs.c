@@ -8,6 +8,8 @@
 int autosaveON = 0;
 int backupsON = 1;
 int pausaListagem = PAUSA_LISTAGEM;
+int limiteExemplosLogs = 0; // Linhas inválidas escritas nos logs por razão (0 = todas)
+int timeoutPassagens = TIMEOUT_PASSAGENS; // Minutos que uma entrada espera pela saída (0 = sem limite)
 
 char *donosFilename = DONOS_TXT;
 char *carrosFilename = CARROS_TXT;
@@ -131,6 +133,66 @@ void setPausaListagem() {
     pausaListagem = num;
 }
 
+/**
+ * @brief Define o nº de threads usadas nas ordenações grandes e no carregamento dos ficheiros .txt
+ * 
+ */
+void setNumThreads() {
+    limpar_terminal();
+    int num = 0;
+    printf("Atualmente: %d thread(s). Com 1 thread as ordenações e o carregamento são sequenciais.\n", numThreads);
+    do {
+        pedirInt(&num, "Insira o número de threads a usar nas ordenações e no carregamento: ", NULL);
+        if (num < 1 || num > MAX_THREADS) {
+            printf("Entrada inválida! (1 a %d)\n\n", MAX_THREADS);
+            pressEnter();
+            continue;
+        }
+        break;
+    } while(1);
+    numThreads = num;
+}
+
+/**
+ * @brief Define quantas linhas inválidas de cada razão são escritas nos logs (as restantes só são contadas)
+ * 
+ */
+void setLimiteExemplosLogs() {
+    limpar_terminal();
+    int num = 0;
+    printf("Atualmente: %d (0 = escrever todas as linhas inválidas).\n", limiteExemplosLogs);
+    do {
+        pedirInt(&num, "Insira o nº máximo de linhas inválidas a escrever nos logs por razão (0 para todas): ", NULL);
+        if (num < 0) {
+            printf("Entrada inválida!\n\n");
+            pressEnter();
+            continue;
+        }
+        break;
+    } while(1);
+    limiteExemplosLogs = num;
+}
+
+/**
+ * @brief Define quanto tempo uma passagem de entrada espera pela saída do mesmo veículo no carregamento
+ * 
+ */
+void setTimeoutPassagens() {
+    limpar_terminal();
+    int num = 0;
+    printf("Atualmente: %d minutos (0 = sem limite).\n", timeoutPassagens);
+    do {
+        pedirInt(&num, "Insira o nº máximo de minutos entre a entrada e a saída de uma viagem (0 para sem limite): ", NULL);
+        if (num < 0) {
+            printf("Entrada inválida!\n\n");
+            pressEnter();
+            continue;
+        }
+        break;
+    } while(1);
+    timeoutPassagens = num;
+}
+
 /**
  * @brief Pergunta ao utilizador quais são os nomes dos ficheiros a utilizar
  * 
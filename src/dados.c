@@ -10,6 +10,9 @@
 #include "passagens.h"
 #include "constantes.h"
 #include "configs.h"
+#include "leituraTxt.h"
+#include "registoLogs.h"
+#include "perfilCarregamento.h"
 
 
 /**
@@ -37,18 +40,26 @@ int carregarDadosTxt(Bdados *bd, char *fDonos, char *fCarros, char *fSensores, c
         logsExiste = '1';
         fclose(logsCheck);
     }
-    FILE *logs = fopen(logFile, "a");
-    if (!logs) {
+    FILE *ficheiroLogs = fopen(logFile, "a");
+    if (!ficheiroLogs) {
         printf("Ocorreu um erro grave ao abrir o ficheiro de logs '%s'.\n\n", logFile);
         return 0;
     }
+    // Com mais de uma thread os logs são escritos em segundo plano
+    RegistoLogs *logs = criarRegistoLogs(ficheiroLogs, numThreads > 1, limiteExemplosLogs);
+    if (!logs) {
+        printf("Ocorreu um erro grave ao preparar o ficheiro de logs '%s'.\n\n", logFile);
+        fclose(ficheiroLogs);
+        return 0;
+    }
 
     char erro = '0';
     if (logsExiste == '1') {
-        fprintf(logs, "\n\n\n");
+        escreverLog(logs, "\n\n\n");
     }
     time_t inicio = time(NULL);
-    fprintf(logs, "#ÍNICIO DA LEITURA DOS DADOS#\t\t%s\n\n", ctime(&inicio));
+    escreverLog(logs, "#ÍNICIO DA LEITURA DOS DADOS#\t\t%s\n\n", ctime(&inicio));
+    iniciarPerfil(&perfilCarregamento, "txt");
     while (erro == '0') {
         if (!carregarDonosTxt(bd, fDonos, logs)) {
             erro = '1';
@@ -57,25 +68,25 @@ int carregarDadosTxt(Bdados *bd, char *fDonos, char *fCarros, char *fSensores, c
     
         if (!carregarCarrosTxt(bd, fCarros, logs)) {
             freeDict(bd->donosAlfabeticamente, freeChaveDonoAlfabeticamente, NULL);
-            freeDict(bd->donosNif, freeChaveDonoNif, freeDono);
+            freeDict(bd->donosNif, NULL, freeDono);
             erro = '1';
             break;
         }
     
         if (!carregarSensoresTxt(bd, fSensores, logs)) {
             freeDict(bd->donosAlfabeticamente, freeChaveDonoAlfabeticamente, NULL);
-            freeDict(bd->donosNif, freeChaveDonoNif, freeDono);
-            freeDict(bd->carrosMarca, freeChaveCarroMarca, NULL);
-            freeDict(bd->carrosCod, freeChaveCarroCod, freeCarro);
+            freeDict(bd->donosNif, NULL, freeDono);
+            freeDict(bd->carrosMarca, NULL, NULL);
+            freeDict(bd->carrosCod, NULL, freeCarro);
             erro = '1';
             break;
         }   
     
         if (!carregarDistanciasTxt(bd, fDistancias, logs)) {
             freeDict(bd->donosAlfabeticamente, freeChaveDonoAlfabeticamente, NULL);
-            freeDict(bd->donosNif, freeChaveDonoNif, freeDono);
-            freeDict(bd->carrosMarca, freeChaveCarroMarca, NULL);
-            freeDict(bd->carrosCod, freeChaveCarroCod, freeCarro);
+            freeDict(bd->donosNif, NULL, freeDono);
+            freeDict(bd->carrosMarca, NULL, NULL);
+            freeDict(bd->carrosCod, NULL, freeCarro);
             freeLista(bd->sensores, freeSensor);
             erro = '1';
             break;
@@ -83,9 +94,9 @@ int carregarDadosTxt(Bdados *bd, char *fDonos, char *fCarros, char *fSensores, c
     
         if (!carregarPassagensTxt(bd, fPassagem, logs)) {
             freeDict(bd->donosAlfabeticamente, freeChaveDonoAlfabeticamente, NULL);
-            freeDict(bd->donosNif, freeChaveDonoNif, freeDono);
-            freeDict(bd->carrosMarca, freeChaveCarroMarca, NULL);
-            freeDict(bd->carrosCod, freeChaveCarroCod, freeCarro);
+            freeDict(bd->donosNif, NULL, freeDono);
+            freeDict(bd->carrosMarca, NULL, NULL);
+            freeDict(bd->carrosCod, NULL, freeCarro);
             freeLista(bd->sensores, freeSensor);
             freeMatrizDistancias(bd->distancias);
             erro = '1';
@@ -94,6 +105,8 @@ int carregarDadosTxt(Bdados *bd, char *fDonos, char *fCarros, char *fSensores, c
         break;
     }
     if (erro == '0') {
+        EtapaPerfil *perfil = novaEtapaPerfil(&perfilCarregamento, "Índices");
+        double inicioOrdenacao = tempoAtual();
         for (char i = 'a'; i <= 'z'; i++) {
             void *letra = (void *)&i;
             Lista *p = obterListaDoDict(bd->donosAlfabeticamente, letra, compChaveDonoAlfabeticamente, hashChaveDonoAlfabeticamente);
@@ -101,13 +114,20 @@ int carregarDadosTxt(Bdados *bd, char *fDonos, char *fCarros, char *fSensores, c
                 mergeSortLista(p, compDonosNome);
             }
         }
+        perfil->tempo = perfil->fases[FASE_ORDENACAO] = tempoAtual() - inicioOrdenacao;
     }
 
+    terminarPerfil(&perfilCarregamento);
     time_t fim = time(NULL);
     char *tempoFinal = ctime(&fim); // Não precisa de free
     tempoFinal[strcspn(tempoFinal, "\n")] = '\0';
-    fprintf(logs, "\n#FIM DA LEITURA DOS DADOS#\t\t%s\t\tTEMPO DE CARREGAMENTO:%.0fsegundos\n\n", tempoFinal, difftime(fim, inicio));
-    fclose(logs);
+    escreverLog(logs, "\n#FIM DA LEITURA DOS DADOS#\t\t%s\t\tTEMPO DE CARREGAMENTO:%.3fsegundos\n\n", tempoFinal, perfilCarregamento.tempoTotal);
+    char relatorio[TAMANHO_RELATORIO_PERFIL];
+    if (formatarPerfil(&perfilCarregamento, relatorio, sizeof(relatorio))) {
+        escreverLog(logs, "%s\n", relatorio);
+    }
+    fecharRegistoLogs(logs);
+    fclose(ficheiroLogs);
 
     if (erro == '1') {
         return 0; //Erro grave
@@ -116,87 +136,397 @@ int carregarDadosTxt(Bdados *bd, char *fDonos, char *fCarros, char *fSensores, c
     return 1;
 }
 
+// Carregamento paralelo dos .txt: os blocos são validados em várias threads (analisarBloco*) e inseridos por ordem (aplicarBloco*)
+
+typedef struct {
+    Bdados *bd;
+    RegistoLogs *logs;
+    int nLinhas; // Nº da última linha aplicada
+    Dict *entradasAbertas; // EntradaAberta por código do veículo (só nas passagens)
+} ContextoCarregamento;
+
+// Passagem de entrada de um veículo à espera da sua saída; o registo fica no dicionário depois de fechado, para ser reutilizado
+typedef struct {
+    int codVeiculo; // Chave
+    Passagem *entrada; // NULL se o veículo não tiver nenhuma entrada em aberto
+    int nLinha;
+    Fatia linha;
+    char *copiaLinha; // Texto da linha, quando o original deixa de existir (acompanhamento do ficheiro)
+} EntradaAberta;
+
+// Resultado da análise de um bloco: um registo por linha, pela ordem do ficheiro
+typedef struct {
+    void *linhas;
+    int nel;
+    int capacidade;
+    char *strings; // Campos copiados do bloco; tem o tamanho do bloco + 1, pelo que nunca é realocado
+    char *cursor; // Próxima posição livre em strings
+    size_t tamanhoArena; // Bytes que as linhas válidas vão ocupar na arena da base de dados
+} BlocoLido;
+
+typedef struct {
+    Fatia linha;
+    int numParam;
+    int nifValido;
+    int nif;
+    char *erroNome;
+    int codPostalValido;
+    CodPostal postal;
+    char *nome;
+} LinhaDonoLida;
+
+typedef struct {
+    Fatia linha;
+    int numParam;
+    int matriculaValida;
+    uint32_t codMatricula;
+    char *erroMarca;
+    char *erroModelo;
+    int anoValido;
+    short ano;
+    int nifValido;
+    int nif;
+    int codVeiculoValido;
+    int codVeiculo;
+    char *matricula;
+    char *marca;
+    char *modelo;
+} LinhaCarroLida;
+
+typedef struct {
+    Fatia linha;
+    int numParam;
+    int idSensorValido;
+    int idSensor;
+    int codVeiculoValido;
+    int codVeiculo;
+    char *mensagemData;
+    int dataValida;
+    Data data;
+    char tipoRegisto;
+} LinhaPassagemLida;
+
+/**
+ * @brief Cria o resultado (vazio) da análise de um bloco
+ * 
+ * @param bloco Bloco a analisar
+ * @return BlocoLido* NULL se erro
+ */
+static BlocoLido *criarBlocoLido(Fatia bloco) {
+    BlocoLido *b = (BlocoLido *)malloc(sizeof(BlocoLido));
+    if (!b) return NULL;
+
+    b->strings = (char *)malloc(bloco.tamanho + 1);
+    if (!b->strings) {
+        free(b);
+        return NULL;
+    }
+    b->cursor = b->strings;
+    b->linhas = NULL;
+    b->nel = 0;
+    b->capacidade = 0;
+    b->tamanhoArena = 0;
+    return b;
+}
+
+/**
+ * @brief Reserva o registo da próxima linha de um bloco
+ * 
+ * @param b Bloco
+ * @param tamanho Tamanho do registo
+ * @return void* Registo a zeros, NULL se erro
+ */
+static void *novaLinhaBloco(BlocoLido *b, size_t tamanho) {
+    if (b->nel == b->capacidade) {
+        int capacidade = b->capacidade ? b->capacidade * 2 : TAMANHO_INICIAL_BUFFER;
+        void *temp = realloc(b->linhas, tamanho * capacidade);
+        if (!temp) return NULL;
+        b->linhas = temp;
+        b->capacidade = capacidade;
+    }
+    void *linha = (char *)b->linhas + tamanho * b->nel++;
+    memset(linha, 0, tamanho);
+    return linha;
+}
+
+/**
+ * @brief Liberta o resultado da análise de um bloco
+ * 
+ * @param bloco BlocoLido
+ */
+static void freeBlocoLido(void *bloco) {
+    if (!bloco) return;
+
+    BlocoLido *b = (BlocoLido *)bloco;
+    free(b->linhas);
+    free(b->strings);
+    free(b);
+}
+
+/**
+ * @brief Valida as linhas de um bloco do ficheiro dos donos
+ * 
+ * @param bloco Bloco de linhas completas
+ * @param contexto Não usado
+ * @return void* BlocoLido com LinhaDonoLida, NULL se erro
+ * 
+ * @note Corre em paralelo: apenas as verificações que não dependem das estruturas (os NIFs repetidos são vistos em aplicarBlocoDonos)
+ */
+static void *analisarBlocoDonos(Fatia bloco, void *contexto) {
+    (void)contexto;
+    BlocoLido *b = criarBlocoLido(bloco);
+    if (!b) return NULL;
+
+    Fatia linha;
+    Fatia campos[PARAM_DONOS];
+    char *parametros[PARAM_DONOS];
+    while (proximaLinhaFatia(&bloco, &linha)) {
+        LinhaDonoLida *l = (LinhaDonoLida *)novaLinhaBloco(b, sizeof(LinhaDonoLida));
+        if (!l) {
+            freeBlocoLido(b);
+            return NULL;
+        }
+        l->linha = linha;
+        l->numParam = separarCampos(linha, campos, PARAM_DONOS);
+        copiarCampos(campos, l->numParam, parametros, &b->cursor);
+        if (l->numParam != PARAM_DONOS) continue;
+
+        //nif
+        l->nifValido = stringToInt(parametros[0], &l->nif) && validarNif(l->nif);
+        //Nome
+        l->erroNome = validarNome(parametros[1]);
+        l->nome = parametros[1];
+        //codPostal
+        short zona = 0, local = 0;
+        l->codPostalValido = converterCodPostal(parametros[2], &zona, &local) && validarCodPostal(zona, local);
+        l->postal.zona = zona;
+        l->postal.local = local;
+        // Nome e nome normalizado
+        if (l->nifValido && !l->erroNome && l->codPostalValido) {
+            b->tamanhoArena += 2 * (strlen(l->nome) + 1);
+        }
+    }
+    return b;
+}
+
+/**
+ * @brief Insere os donos de um bloco já validado e escreve os logs, pela ordem do ficheiro
+ * 
+ * @param resultado BlocoLido devolvido por analisarBlocoDonos
+ * @param contexto ContextoCarregamento
+ * @return int 1 se sucesso
+ */
+static int aplicarBlocoDonos(void *resultado, void *contexto) {
+    BlocoLido *b = (BlocoLido *)resultado;
+    ContextoCarregamento *ctx = (ContextoCarregamento *)contexto;
+    RegistoLogs *logs = ctx->logs;
+    LinhaDonoLida *linhas = (LinhaDonoLida *)b->linhas;
+    // Os nomes do bloco ficam todos no mesmo bloco da arena
+    (void)reservarEspacoArena(ctx->bd->strings, b->tamanhoArena);
+
+    for (int i = 0; i < b->nel; i++) {
+        LinhaDonoLida *l = &linhas[i];
+        int nLinhas = ++ctx->nLinhas;
+        char erro = '0';
+
+        if (l->numParam == PARAM_DONOS) {
+            if (!l->nifValido) {
+                registarLinhaInvalida(logs, l->linha, nLinhas, "Número de contribuinte inválido");
+                erro = '1';
+            }
+            else if (searchDict(ctx->bd->donosNif, (void *)&l->nif, compChaveDonoNif, compCodDono, hashChaveDonoNif)) {
+                registarLinhaInvalida(logs, l->linha, nLinhas, "Número de contribuinte repetido");
+                erro = '1';
+            }
+            if (l->erroNome) {
+                registarLinhaInvalida(logs, l->linha, nLinhas, l->erroNome);
+                erro = '1';
+            }
+            if (!l->codPostalValido) {
+                registarLinhaInvalida(logs, l->linha, nLinhas, "O código postal é inválido");
+                erro = '1';
+            }
+            //Caso não haja erro passar os dados para as estruturas
+            if (erro == '0') {
+                if(!inserirDonoLido(ctx->bd, l->nome, l->nif, l->postal)) {
+                    registarLinhaInvalida(logs, l->linha, nLinhas, "Ocorreu um erro fatal a carregar a linha para a memória");
+                }
+            }
+        }
+        else if (l->numParam < PARAM_DONOS) {
+            registarLinhaInvalida(logs, l->linha, nLinhas, "Parametros insuficientes (%d NECESSÁRIOS, %d LIDOS)", PARAM_DONOS, l->numParam);
+        }
+        else {
+            registarLinhaInvalida(logs, l->linha, nLinhas, "Demasiados parametros (%d NECESSÁRIOS, %d LIDOS)", PARAM_DONOS, l->numParam);
+        }
+    }
+    return 1;
+}
+
 /**
  * @brief Carrega os dados relativos aos Donos para memória
  * 
  * @param bd Base de Dados
  * @param donosFilename Nome do ficheiro dos Donos
- * @param logs Ficheiro de logs
+ * @param logs Registo dos logs
  * @return int 1 se sucesso, 0 se erro
+ * 
+ * @note As linhas são validadas em paralelo (numThreads) e inseridas por ordem, pelo que os logs não mudam
  */
-int carregarDonosTxt(Bdados *bd, char *donosFilename, FILE *logs) {
+int carregarDonosTxt(Bdados *bd, char *donosFilename, RegistoLogs *logs) {
     const char *donosFile = (donosFilename) ? donosFilename : DONOS_TXT;
 
     time_t inicio = time(NULL);   
-    fprintf(logs, "#FICHEIRO DONOS#\t\t%s\n", ctime(&inicio));
+    escreverLog(logs, "#FICHEIRO DONOS#\t\t%s\n", ctime(&inicio));
+    EtapaPerfil *perfil = novaEtapaPerfil(&perfilCarregamento, "Donos");
+    double inicioPerfil = tempoAtual();
 
-    FILE *donos = fopen(donosFile, "r");
+    FicheiroTxt *donos = abrirFicheiroTxt(donosFile);
     if (donos) {
-        int nLinhas = 0;
-        char *linha = NULL;
-        while((linha = lerLinhaTxt(donos, &nLinhas)) != NULL) {
-            char *parametros[PARAM_DONOS];
-            int numParam = 0; //Nº real de param lidos
-            char *copiaLinha = strdup(linha); //Cópia da linha para passar para separarParam e evitar alterações à original
-            separarParametros(copiaLinha, parametros, &numParam, PARAM_DONOS);
-            char erro = '0';
-
-            if (numParam == PARAM_DONOS) {
-                //nif
-                int nif = 0;
-                if (!stringToInt(parametros[0], &nif) || !validarNif(nif)) {
-                    linhaInvalida(linha, nLinhas, logs);
-                    fprintf(logs, "Razão: Número de contribuinte inválido\n\n");
-                    erro = '1';
-                }
-                //Nome
-                char *nomeInvalido = NULL;
-                nomeInvalido = validarNome(parametros[1]);
-                if (nomeInvalido) {
-                    linhaInvalida(linha, nLinhas, logs);
-                    fprintf(logs, "Razão: %s\n\n", nomeInvalido);
-                    erro = '1';
-                }
-                //codPostal
-                short zona = 0, local = 0;
-                if (!converterCodPostal(parametros[2], &zona, &local) || !validarCodPostal(zona, local)) {
-                    linhaInvalida(linha, nLinhas, logs);
-                    fprintf(logs, "Razão: O código postal é inválido\n\n");
-                    erro = '1';
-                }
-                //Converter codigo Postal
-                CodPostal postal;
-                postal.local = local;
-                postal.zona = zona;
-                //Caso não haja erro passar os dados para as estruturas
-                if (erro == '0') {
-                    if(!inserirDonoLido(bd, parametros[1], nif, postal)) {
-                        linhaInvalida(linha, nLinhas, logs);
-                        fprintf(logs, "Razão: Ocorreu um erro fatal a carregar a linha para a memória\n\n");
-                    }
-                }
-            }
-            else if (numParam < PARAM_DONOS) {
-                linhaInvalida(linha, nLinhas, logs);
-                fprintf(logs, "Razão: Parametros insuficientes (%d NECESSÁRIOS, %d LIDOS)\n\n", PARAM_DONOS, numParam);
-            }
-            else {
-                linhaInvalida(linha, nLinhas, logs);
-                fprintf(logs, "Razão: Demasiados parametros (%d NECESSÁRIOS, %d LIDOS)\n\n", PARAM_DONOS, numParam);
-            }
-            free(copiaLinha);
-            free(linha); 
+        // Pré-dimensionar as estruturas para as inserções não realocarem (se falhar, crescem como antes)
+        int n = contarLinhasTxt(donos);
+        perfil->nBytes = donos->tamanho;
+        (void)reservarDict(bd->donosNif, bd->donosNif->nelDict + n);
+        (void)reservarNosLista(n); // donosAlfabeticamente
+        perfil->fases[FASE_LEITURA] += tempoAtual() - inicioPerfil;
+        ContextoCarregamento ctx = {bd, logs, 0, NULL};
+        if (!carregarFicheiroTxtParalelo(donos, analisarBlocoDonos, aplicarBlocoDonos, freeBlocoLido, &ctx, perfil)) {
+            escreverLog(logs, "Ocorreu um erro fatal a carregar o ficheiro de Donos para a memória (depois da linha %d)\n\n", ctx.nLinhas);
         }
-        fclose(donos);
+        perfil->nLinhas = ctx.nLinhas;
+        fecharFicheiroTxt(donos);
     }
     else {
-        fprintf(logs, "Ocorreu um erro ao abrir o ficheiro de Donos: '%s'\n\n", donosFile);
+        escreverLog(logs, "Ocorreu um erro ao abrir o ficheiro de Donos: '%s'\n\n", donosFile);
         return 0;
     }
+    escreverResumoLogs(logs);
+    perfil->tempo = tempoAtual() - inicioPerfil;
     time_t fim = time(NULL);
     char *tempoFinal = ctime(&fim); // Não precisa de free
     tempoFinal[strcspn(tempoFinal, "\n")] = '\0';
-    fprintf(logs, "\n#FIM FICHEIRO DONOS#\t\t%s\t\tTEMPO DE CARREGAMENTO:%.0fsegundos\n\n", tempoFinal, difftime(fim, inicio));
+    escreverLog(logs, "\n#FIM FICHEIRO DONOS#\t\t%s\t\tTEMPO DE CARREGAMENTO:%.3fsegundos\n\n", tempoFinal, perfil->tempo);
+    return 1;
+}
+
+/**
+ * @brief Valida as linhas de um bloco do ficheiro dos carros
+ * 
+ * @param bloco Bloco de linhas completas
+ * @param contexto Não usado
+ * @return void* BlocoLido com LinhaCarroLida, NULL se erro
+ * 
+ * @note Corre em paralelo: as matrículas e códigos repetidos são vistos em aplicarBlocoCarros
+ */
+static void *analisarBlocoCarros(Fatia bloco, void *contexto) {
+    (void)contexto;
+    BlocoLido *b = criarBlocoLido(bloco);
+    if (!b) return NULL;
+
+    Fatia linha;
+    Fatia campos[PARAM_CARROS];
+    char *parametros[PARAM_CARROS];
+    while (proximaLinhaFatia(&bloco, &linha)) {
+        LinhaCarroLida *l = (LinhaCarroLida *)novaLinhaBloco(b, sizeof(LinhaCarroLida));
+        if (!l) {
+            freeBlocoLido(b);
+            return NULL;
+        }
+        l->linha = linha;
+        l->numParam = separarCampos(linha, campos, PARAM_CARROS);
+        copiarCampos(campos, l->numParam, parametros, &b->cursor);
+        if (l->numParam != PARAM_CARROS) continue;
+
+        //Matrícula
+        l->codMatricula = codificarMatricula(parametros[0]);
+        l->matriculaValida = validarMatricula(parametros[0]);
+        l->matricula = parametros[0];
+        //Marca e modelo
+        l->erroMarca = validarMarca(parametros[1]);
+        l->erroModelo = validarModelo(parametros[2]);
+        l->marca = parametros[1];
+        l->modelo = parametros[2];
+        //Ano
+        l->anoValido = stringToShort(parametros[3], &l->ano) && validarAnoCarro(l->ano);
+        //NIF
+        l->nifValido = stringToInt(parametros[4], &l->nif) && validarNif(l->nif);
+        //CodVeiculo
+        l->codVeiculoValido = stringToInt(parametros[5], &l->codVeiculo) && validarCodVeiculo(l->codVeiculo);
+    }
+    return b;
+}
+
+/**
+ * @brief Insere os carros de um bloco já validado e escreve os logs, pela ordem do ficheiro
+ * 
+ * @param resultado BlocoLido devolvido por analisarBlocoCarros
+ * @param contexto ContextoCarregamento
+ * @return int 1 se sucesso
+ */
+static int aplicarBlocoCarros(void *resultado, void *contexto) {
+    BlocoLido *b = (BlocoLido *)resultado;
+    ContextoCarregamento *ctx = (ContextoCarregamento *)contexto;
+    RegistoLogs *logs = ctx->logs;
+    LinhaCarroLida *linhas = (LinhaCarroLida *)b->linhas;
+
+    for (int i = 0; i < b->nel; i++) {
+        LinhaCarroLida *l = &linhas[i];
+        int nLinhas = ++ctx->nLinhas;
+        char erro = '0';
+
+        if (l->numParam == PARAM_CARROS) {
+            //Matrícula
+            if (!l->matriculaValida) {
+                registarLinhaInvalida(logs, l->linha, nLinhas, "Matrícula inválida");
+                erro = '1';
+            }
+            else if (searchDict(ctx->bd->carrosMat, &l->codMatricula, compChaveCarroMatricula, compCarroMatricula, hashChaveCarroMatricula)) {
+                registarLinhaInvalida(logs, l->linha, nLinhas, "Matrícula repetida");
+                erro = '1';
+            }
+            //Marca
+            if (l->erroMarca) {
+                registarLinhaInvalida(logs, l->linha, nLinhas, l->erroMarca);
+                erro = '1';
+            }
+            //Modelo
+            if (l->erroModelo) {
+                registarLinhaInvalida(logs, l->linha, nLinhas, l->erroModelo);
+                erro = '1';
+            }
+            //Ano
+            if (!l->anoValido) {
+                registarLinhaInvalida(logs, l->linha, nLinhas, "Ano inválido");
+                erro = '1';
+            }
+            //NIF
+            if (!l->nifValido) {
+                registarLinhaInvalida(logs, l->linha, nLinhas, "Número de contribuinte inválido");
+                erro = '1';
+            }
+            //CodVeiculo
+            if (!l->codVeiculoValido) {
+                registarLinhaInvalida(logs, l->linha, nLinhas, "Código do veículo errado");
+                erro = '1';
+            }
+            else if (searchDict(ctx->bd->carrosCod, (void *)&l->codVeiculo, compChaveCarroCod, compCodCarro, hashChaveCarroCod)) {
+                registarLinhaInvalida(logs, l->linha, nLinhas, "Código do veículo repetido");
+                erro = '1';
+            }
+            //Caso não haja erro passar os dados para as estruturas
+            if (erro == '0') {
+                if(!inserirCarroLido(ctx->bd, l->matricula, l->marca, l->modelo, l->ano, l->nif, l->codVeiculo)) {
+                    registarLinhaInvalida(logs, l->linha, nLinhas, "Ocorreu um erro fatal a carregar a linha para a memória");
+                }
+            }
+        }
+        else if (l->numParam < PARAM_CARROS) {
+            registarLinhaInvalida(logs, l->linha, nLinhas, "Parametros insuficientes (%d NECESSÁRIOS, %d LIDOS)", PARAM_CARROS, l->numParam);
+        }
+        else {
+            registarLinhaInvalida(logs, l->linha, nLinhas, "Demasiados parametros (%d NECESSÁRIOS, %d LIDOS)", PARAM_CARROS, l->numParam);
+        }
+    }
     return 1;
 }
 
@@ -205,99 +535,45 @@ int carregarDonosTxt(Bdados *bd, char *donosFilename, FILE *logs) {
  * 
  * @param bd Base de Dados
  * @param carrosFilename Nome do ficheiro dos Carros
- * @param logs Ficheiro de logs
+ * @param logs Registo dos logs
  * @return int 1 se sucesso, 0 se erro
+ * 
+ * @note As linhas são validadas em paralelo (numThreads) e inseridas por ordem, pelo que os logs não mudam
  */
-int carregarCarrosTxt(Bdados *bd, char *carrosFilename, FILE *logs) {
+int carregarCarrosTxt(Bdados *bd, char *carrosFilename, RegistoLogs *logs) {
     const char *carrosFile = (carrosFilename) ? carrosFilename : CARROS_TXT;
 
     time_t inicio = time(NULL);   
-    fprintf(logs, "#FICHEIRO CARROS#\t\t%s\n", ctime(&inicio));
+    escreverLog(logs, "#FICHEIRO CARROS#\t\t%s\n", ctime(&inicio));
+    EtapaPerfil *perfil = novaEtapaPerfil(&perfilCarregamento, "Carros");
+    double inicioPerfil = tempoAtual();
 
-    FILE *carros = fopen(carrosFile, "r");
+    FicheiroTxt *carros = abrirFicheiroTxt(carrosFile);
     if (carros) {
-        int nLinhas = 0;
-        char *linha = NULL;
-        while((linha = lerLinhaTxt(carros, &nLinhas)) != NULL) {
-            char *parametros[PARAM_CARROS];
-            int numParam = 0; //Nº real de param lidos
-            char *copiaLinha = strdup(linha);
-            separarParametros(copiaLinha, parametros, &numParam, PARAM_CARROS);
-            char erro = '0';
-
-            if (numParam == PARAM_CARROS) {
-                //Matrícula
-                if (!validarMatricula(parametros[0])) {
-                    linhaInvalida(linha, nLinhas, logs);
-                    fprintf(logs, "Razão: Matrícula inválida\n\n");
-                    erro = '1';
-                }
-                //Marca
-                char *marca = NULL;
-                marca = validarMarca(parametros[1]);
-                if (marca) {
-                    linhaInvalida(linha, nLinhas, logs);
-                    fprintf(logs, "Razão: %s\n\n", marca);
-                    erro = '1';
-                }
-                //Modelo
-                char *modelo = NULL;
-                modelo = validarModelo(parametros[2]);
-                if (modelo) {
-                    linhaInvalida(linha, nLinhas, logs);
-                    fprintf(logs, "Razão: %s\n\n", modelo);
-                    erro = '1';
-                }
-                //Ano
-                short ano;
-                if (!stringToShort(parametros[3], &ano) || !validarAnoCarro(ano)) {
-                    linhaInvalida(linha, nLinhas, logs);
-                    fprintf(logs, "Razão: Ano inválido\n\n");
-                    erro = '1';
-                }
-                //NIF
-                int nif;
-                if (!stringToInt(parametros[4], &nif) || !validarNif(nif)) {
-                    linhaInvalida(linha, nLinhas, logs);
-                    fprintf(logs, "Razão: Número de contribuinte inválido\n\n");
-                    erro = '1';
-                }
-                //CodVeiculo
-                int codVeiculo;
-                if (!stringToInt(parametros[5], &codVeiculo) || !validarCodVeiculo(codVeiculo)) {
-                    linhaInvalida(linha, nLinhas, logs);
-                    fprintf(logs, "Razão: Código do veículo errado\n\n");
-                    erro = '1';
-                }
-                //Caso não haja erro passar os dados para as estruturas
-                if (erro == '0') {
-                    if(!inserirCarroLido(bd, parametros[0], parametros[1], parametros[2], ano, nif, codVeiculo)) {
-                        linhaInvalida(linha, nLinhas, logs);
-                        fprintf(logs, "Razão: Ocorreu um erro fatal a carregar a linha para a memória\n\n");
-                    }
-                }
-            }
-            else if (numParam < PARAM_CARROS) {
-                linhaInvalida(linha, nLinhas, logs);
-                fprintf(logs, "Razão: Parametros insuficientes (%d NECESSÁRIOS, %d LIDOS)\n\n", PARAM_CARROS, numParam);
-            }
-            else {
-                linhaInvalida(linha, nLinhas, logs);
-                fprintf(logs, "Razão: Demasiados parametros (%d NECESSÁRIOS, %d LIDOS)\n\n", PARAM_CARROS, numParam);
-            }
-            free(copiaLinha);
-            free(linha); 
+        // Pré-dimensionar as estruturas para as inserções não realocarem (se falhar, crescem como antes)
+        int n = contarLinhasTxt(carros);
+        perfil->nBytes = carros->tamanho;
+        (void)reservarDict(bd->carrosCod, bd->carrosCod->nelDict + n);
+        (void)reservarDict(bd->carrosMat, bd->carrosMat->nelDict + n);
+        (void)reservarNosLista(2 * n); // Carros do dono e carrosMarca
+        perfil->fases[FASE_LEITURA] += tempoAtual() - inicioPerfil;
+        ContextoCarregamento ctx = {bd, logs, 0, NULL};
+        if (!carregarFicheiroTxtParalelo(carros, analisarBlocoCarros, aplicarBlocoCarros, freeBlocoLido, &ctx, perfil)) {
+            escreverLog(logs, "Ocorreu um erro fatal a carregar o ficheiro de Carros para a memória (depois da linha %d)\n\n", ctx.nLinhas);
         }
-        fclose(carros);
+        perfil->nLinhas = ctx.nLinhas;
+        fecharFicheiroTxt(carros);
     }
     else {
-        fprintf(logs, "Ocorreu um erro ao abrir o ficheiro de Carros: '%s'.\n\n", carrosFile);
+        escreverLog(logs, "Ocorreu um erro ao abrir o ficheiro de Carros: '%s'.\n\n", carrosFile);
         return 0;
     }
+    escreverResumoLogs(logs);
+    perfil->tempo = tempoAtual() - inicioPerfil;
     time_t fim = time(NULL);
     char *tempoFinal = ctime(&fim); // Não precisa de free
     tempoFinal[strcspn(tempoFinal, "\n")] = '\0';
-    fprintf(logs, "\n#FIM FICHEIRO CARROS#\t\t%s\t\tTEMPO DE CARREGAMENTO:%.0fsegundos\n\n", tempoFinal, difftime(fim, inicio));
+    escreverLog(logs, "\n#FIM FICHEIRO CARROS#\t\t%s\t\tTEMPO DE CARREGAMENTO:%.3fsegundos\n\n", tempoFinal, perfil->tempo);
     return 1;
 }
 
@@ -306,65 +582,83 @@ int carregarCarrosTxt(Bdados *bd, char *carrosFilename, FILE *logs) {
  * 
  * @param bd Base de Dados
  * @param sensoresFilename Nome do ficheiro dos Sensores
- * @param logs Ficheiro de logs
+ * @param logs Registo dos logs
  * @return int 1 se sucesso, 0 se erro
  */
-int carregarSensoresTxt(Bdados *bd, char *sensoresFilename, FILE *logs) {
+int carregarSensoresTxt(Bdados *bd, char *sensoresFilename, RegistoLogs *logs) {
     const char *sensoresFile = (sensoresFilename) ? sensoresFilename : SENSORES_TXT;
     
     time_t inicio = time(NULL);   
-    fprintf(logs, "#FICHEIRO SENSORES#\t\t%s\n", ctime(&inicio));
+    escreverLog(logs, "#FICHEIRO SENSORES#\t\t%s\n", ctime(&inicio));
+    EtapaPerfil *perfil = novaEtapaPerfil(&perfilCarregamento, "Sensores");
+    double inicioPerfil = tempoAtual();
 
-    FILE *sens = fopen(sensoresFile, "r");
+    FicheiroTxt *sens = abrirFicheiroTxt(sensoresFile);
     if (sens) {
+        // Cada campo guardado ocupa no máximo o seu tamanho no ficheiro mais o separador (ou o '\0' da última linha)
+        (void)reservarNosLista(contarLinhasTxt(sens));
+        (void)reservarEspacoArena(bd->strings, sens->tamanho + 1);
+        perfil->nBytes = sens->tamanho;
+        double inicioAnalise = tempoAtual();
+        perfil->fases[FASE_LEITURA] += inicioAnalise - inicioPerfil;
+        double tempoInsercao = 0;
         int nLinhas = 0;
-        char *linha = NULL;
-        while((linha = lerLinhaTxt(sens, &nLinhas)) != NULL) {
+        Fatia linha;
+        Fatia campos[PARAM_SENSORES];
+        BufferCampos buf = {NULL, 0}; // Reutilizado por todas as linhas
+        while(proximaLinhaTxt(sens, &linha)) {
+            nLinhas++;
             char *parametros[PARAM_SENSORES];
-            int numParam = 0; //Nº real de param lidos
-            char *copiaLinha = strdup(linha);
-            separarParametros(copiaLinha, parametros, &numParam, PARAM_SENSORES);
+            int numParam = separarCampos(linha, campos, PARAM_SENSORES); //Nº real de param lidos
+            if (!camposParaStrings(campos, numParam, parametros, &buf)) {
+                registarLinhaInvalida(logs, linha, nLinhas, "Ocorreu um erro fatal a carregar a linha para a memória");
+                continue;
+            }
             char erro = '0';
 
             if (numParam == PARAM_SENSORES) {
                 //Código do sensor
                 int codSensor;
                 if (!stringToInt(parametros[0], &codSensor) || !validarCodSensor(codSensor)) {
-                    linhaInvalida(linha, nLinhas, logs);
-                    fprintf(logs, "Razão: Código do sensor inválido\n\n");
+                    registarLinhaInvalida(logs, linha, nLinhas, "Código do sensor inválido");
                     erro = '1';
                 }
                 //Caso não haja erro passar os dados para as estruturas
                 if (erro == '0') {
+                    double inicioInsercao = tempoAtual();
                     if(!inserirSensorLido(bd, codSensor, parametros[1], parametros[2], parametros[3])) {
-                        linhaInvalida(linha, nLinhas, logs);
-                        fprintf(logs, "Razão: Ocorreu um erro fatal a carregar a linha para a memória");
+                        registarLinhaInvalida(logs, linha, nLinhas, "Ocorreu um erro fatal a carregar a linha para a memória");
                     }
+                    tempoInsercao += tempoAtual() - inicioInsercao;
                 }
             }
             else if (numParam < PARAM_SENSORES) {
-                linhaInvalida(linha, nLinhas, logs);
-                fprintf(logs, "Razão: Parametros insuficientes (%d NECESSÁRIOS, %d LIDOS)\n\n", PARAM_SENSORES, numParam);
+                registarLinhaInvalida(logs, linha, nLinhas, "Parametros insuficientes (%d NECESSÁRIOS, %d LIDOS)", PARAM_SENSORES, numParam);
             }
             else {
-                linhaInvalida(linha, nLinhas, logs);
-                fprintf(logs, "Razão: Demasiados parametros (%d NECESSÁRIOS, %d LIDOS)\n\n", PARAM_SENSORES, numParam);
+                registarLinhaInvalida(logs, linha, nLinhas, "Demasiados parametros (%d NECESSÁRIOS, %d LIDOS)", PARAM_SENSORES, numParam);
             }
-            free(copiaLinha);
-            free(linha); 
         }
-        fclose(sens);
+        perfil->nLinhas = nLinhas;
+        perfil->fases[FASE_INSERCAO] += tempoInsercao;
+        perfil->fases[FASE_ANALISE] += tempoAtual() - inicioAnalise - tempoInsercao;
+        freeBufferCampos(&buf);
+        fecharFicheiroTxt(sens);
     }
     else {
-        fprintf(logs, "Ocorreu um erro ao abrir o ficheiro de Sensores: '%s'.\n\n", sensoresFile);
+        escreverLog(logs, "Ocorreu um erro ao abrir o ficheiro de Sensores: '%s'.\n\n", sensoresFile);
         return 0;
     }
     //Ordenar a lista
-    ordenarLista(bd->sensores, compararSensores);
+    double inicioOrdenacao = tempoAtual();
+    mergeSortLista(bd->sensores, compararSensores);
+    perfil->fases[FASE_ORDENACAO] += tempoAtual() - inicioOrdenacao;
+    escreverResumoLogs(logs);
+    perfil->tempo = tempoAtual() - inicioPerfil;
     time_t fim = time(NULL);
     char *tempoFinal = ctime(&fim); // Não precisa de free
     tempoFinal[strcspn(tempoFinal, "\n")] = '\0';
-    fprintf(logs, "\n#FIM FICHEIRO SENSORES#\t\t%s\t\tTEMPO DE CARREGAMENTO:%.0fsegundos\n\n", tempoFinal, difftime(fim, inicio));
+    escreverLog(logs, "\n#FIM FICHEIRO SENSORES#\t\t%s\t\tTEMPO DE CARREGAMENTO:%.3fsegundos\n\n", tempoFinal, perfil->tempo);
     return 1;
 }
 
@@ -373,82 +667,511 @@ int carregarSensoresTxt(Bdados *bd, char *sensoresFilename, FILE *logs) {
  * 
  * @param bd Base de Dados
  * @param distanciasFilename Nome do ficheiro das Distancias
- * @param logs Ficheiro de logs
+ * @param logs Registo dos logs
  * @return int 1 se sucesso, 0 se erro
  */
-int carregarDistanciasTxt(Bdados *bd, char *distanciasFilename, FILE *logs) {
+int carregarDistanciasTxt(Bdados *bd, char *distanciasFilename, RegistoLogs *logs) {
     const char *distanciasFile = (distanciasFilename) ? distanciasFilename : DISTANCIAS_TXT;
 
     time_t inicio = time(NULL);   
-    fprintf(logs, "#FICHEIRO DISTANCIAS#\t\t%s\n", ctime(&inicio));
+    escreverLog(logs, "#FICHEIRO DISTANCIAS#\t\t%s\n", ctime(&inicio));
+    EtapaPerfil *perfil = novaEtapaPerfil(&perfilCarregamento, "Distâncias");
+    double inicioPerfil = tempoAtual();
     if (!realocarMatrizDistancias(bd, bd->sensores->nel)) {
-        fprintf(logs, "Ocorreu um erro a realocar a matriz das distâncias\n\n");
+        escreverLog(logs, "Ocorreu um erro a realocar a matriz das distâncias\n\n");
         return 0;
     }
-    FILE *dists = fopen(distanciasFile, "r");
+    double inicioLeitura = tempoAtual();
+    perfil->fases[FASE_INSERCAO] += inicioLeitura - inicioPerfil; // Matriz dimensionada uma única vez
+    FicheiroTxt *dists = abrirFicheiroTxt(distanciasFile);
     if (dists) {
+        perfil->nBytes = dists->tamanho;
+        double inicioAnalise = tempoAtual();
+        perfil->fases[FASE_LEITURA] += inicioAnalise - inicioLeitura;
+        double tempoInsercao = 0;
         int nLinhas = 0;
-        char *linha = NULL;
-        while((linha = lerLinhaTxt(dists, &nLinhas)) != NULL) {
+        Fatia linha;
+        Fatia campos[PARAM_DISTANCIAS];
+        BufferCampos buf = {NULL, 0}; // Reutilizado por todas as linhas
+        while(proximaLinhaTxt(dists, &linha)) {
+            nLinhas++;
             char *parametros[PARAM_DISTANCIAS];
-            int numParam = 0; //Nº real de param lidos
-            char *copiaLinha = strdup(linha);
-            separarParametros(copiaLinha, parametros, &numParam, PARAM_DISTANCIAS);
+            int numParam = separarCampos(linha, campos, PARAM_DISTANCIAS); //Nº real de param lidos
+            if (!camposParaStrings(campos, numParam, parametros, &buf)) {
+                registarLinhaInvalida(logs, linha, nLinhas, "Ocorreu um erro fatal a carregar a linha para a memória");
+                continue;
+            }
             char erro = '0';
 
             if (numParam == PARAM_DISTANCIAS) {
                 //Código do sensor 1
                 int codSensor1;
                 if (!stringToInt(parametros[0], &codSensor1) || !validarCodSensor(codSensor1)) {
-                    linhaInvalida(linha, nLinhas, logs);
-                    fprintf(logs, "Razão: Código do sensor 1 inválido\n\n");
+                    registarLinhaInvalida(logs, linha, nLinhas, "Código do sensor 1 inválido");
                     erro = '1';
                 }
                 //Código do sensor 2
                 int codSensor2;
                 if (!stringToInt(parametros[1], &codSensor2) || !validarCodSensor(codSensor2)) {
-                    linhaInvalida(linha, nLinhas, logs);
-                    fprintf(logs, "Razão: Código do sensor 2 inválido\n\n");
+                    registarLinhaInvalida(logs, linha, nLinhas, "Código do sensor 2 inválido");
                     erro = '1';
                 }
                 float distancia;
                 converterPontoVirgulaDecimal(parametros[2]); // Passa notação de floats para vírgulas caso necessário
                 if (!stringToFloat(parametros[2], &distancia) || !validarDistancia(distancia)) {
-                    linhaInvalida(linha, nLinhas, logs);
-                    fprintf(logs, "Razão: Distância inválida\n\n");
+                    registarLinhaInvalida(logs, linha, nLinhas, "Distância inválida");
                     erro = '1';
                     printf("Distancia: %.2f\n", distancia);
                 }
                 //Caso não haja erro passar os dados para as estruturas
                 if (erro == '0') {
+                    double inicioInsercao = tempoAtual();
                     if(!inserirDistanciaLido(bd, codSensor1, codSensor2, distancia)) {
-                        linhaInvalida(linha, nLinhas, logs);
-                        fprintf(logs, "Razão: Ocorreu um erro fatal a carregar a linha para a memória");
+                        registarLinhaInvalida(logs, linha, nLinhas, "Ocorreu um erro fatal a carregar a linha para a memória");
                     }
+                    tempoInsercao += tempoAtual() - inicioInsercao;
                 }
             }
             else if (numParam < PARAM_DISTANCIAS) {
-                linhaInvalida(linha, nLinhas, logs);
-                fprintf(logs, "Razão: Parametros insuficientes (%d NECESSÁRIOS, %d LIDOS)\n\n", PARAM_DISTANCIAS, numParam);
+                registarLinhaInvalida(logs, linha, nLinhas, "Parametros insuficientes (%d NECESSÁRIOS, %d LIDOS)", PARAM_DISTANCIAS, numParam);
             }
             else {
-                linhaInvalida(linha, nLinhas, logs);
-                fprintf(logs, "Razão: Demasiados parametros (%d NECESSÁRIOS, %d LIDOS)\n\n", PARAM_DISTANCIAS, numParam);
+                registarLinhaInvalida(logs, linha, nLinhas, "Demasiados parametros (%d NECESSÁRIOS, %d LIDOS)", PARAM_DISTANCIAS, numParam);
             }
-            free(copiaLinha);
-            free(linha); 
         }
-        fclose(dists);
+        perfil->nLinhas = nLinhas;
+        perfil->fases[FASE_INSERCAO] += tempoInsercao;
+        perfil->fases[FASE_ANALISE] += tempoAtual() - inicioAnalise - tempoInsercao;
+        freeBufferCampos(&buf);
+        fecharFicheiroTxt(dists);
     }
     else {
-        fprintf(logs, "Ocorreu um erro ao abrir o ficheiro de Distancias: '%s'.\n\n", distanciasFile);
+        escreverLog(logs, "Ocorreu um erro ao abrir o ficheiro de Distancias: '%s'.\n\n", distanciasFile);
         return 0;
     }
 
+    escreverResumoLogs(logs);
+    perfil->tempo = tempoAtual() - inicioPerfil;
     time_t fim = time(NULL);
     char *tempoFinal = ctime(&fim); // Não precisa de free
     tempoFinal[strcspn(tempoFinal, "\n")] = '\0';
-    fprintf(logs, "\n#FIM FICHEIRO DISTANCIAS#\t\t%s\t\tTEMPO DE CARREGAMENTO:%.0fsegundos\n\n", tempoFinal, difftime(fim, inicio));
+    escreverLog(logs, "\n#FIM FICHEIRO DISTANCIAS#\t\t%s\t\tTEMPO DE CARREGAMENTO:%.3fsegundos\n\n", tempoFinal, perfil->tempo);
+    return 1;
+}
+
+/**
+ * @brief Valida as linhas de um bloco do ficheiro das passagens
+ * 
+ * @param bloco Bloco de linhas completas
+ * @param contexto Não usado
+ * @return void* BlocoLido com LinhaPassagemLida, NULL se erro
+ * 
+ * @note Corre em paralelo e linha a linha: as verificações entre as duas passagens de um par são feitas em aplicarBlocoPassagens,
+ *       que vê as linhas por ordem, por isso um par pode ficar dividido entre dois blocos
+ */
+static void *analisarBlocoPassagens(Fatia bloco, void *contexto) {
+    (void)contexto;
+    BlocoLido *b = criarBlocoLido(bloco);
+    if (!b) return NULL;
+
+    Fatia linha;
+    Fatia campos[PARAM_PASSAGEM];
+    char *parametros[PARAM_PASSAGEM];
+    while (proximaLinhaFatia(&bloco, &linha)) {
+        LinhaPassagemLida *l = (LinhaPassagemLida *)novaLinhaBloco(b, sizeof(LinhaPassagemLida));
+        if (!l) {
+            freeBlocoLido(b);
+            return NULL;
+        }
+        l->linha = linha;
+        l->numParam = separarCampos(linha, campos, PARAM_PASSAGEM);
+        copiarCampos(campos, l->numParam, parametros, &b->cursor);
+        if (l->numParam != PARAM_PASSAGEM) continue;
+
+        //ID do sensor
+        l->idSensorValido = stringToInt(parametros[0], &l->idSensor) && validarCodSensor(l->idSensor);
+        //Código do veículo
+        l->codVeiculoValido = stringToInt(parametros[1], &l->codVeiculo) && validarCodVeiculo(l->codVeiculo);
+        //Data (formato fixo já validado; os outros formatos passam pelo caminho antigo)
+        l->dataValida = converterDataFixa(parametros[2], &l->data);
+        if (l->dataValida == -1) {
+            l->mensagemData = converterParaData(parametros[2], &l->data);
+            l->dataValida = !l->mensagemData && validarData(l->data, '0');
+        }
+        //Tipo de registo
+        l->tipoRegisto = parametros[3][0];
+    }
+    return b;
+}
+
+/**
+ * @brief Obtém a chave de uma entrada em aberto
+ * 
+ * @param entrada EntradaAberta
+ * @return void* Chave (código do veículo, inline) ou NULL se erro
+ */
+static void *criarChaveEntradaAberta(void *entrada) {
+    if (!entrada) return NULL;
+
+    return (void *)&((EntradaAberta *)entrada)->codVeiculo;
+}
+
+/**
+ * @brief Função de hash das entradas em aberto
+ * 
+ * @param chave Código do veículo
+ * @return int hash ou -1 se erro
+ */
+static int hashChaveEntradaAberta(void *chave) {
+    if (!chave) return -1;
+
+    return *(int *)chave;
+}
+
+/**
+ * @brief Compara as chaves (códigos do veículo) de duas entradas em aberto
+ * 
+ * @param chave Chave
+ * @param chave2 Chave 2
+ * @return int -1 se erro, 0 se igual, 1 se diferente
+ */
+static int compChaveEntradaAberta(void *chave, void *chave2) {
+    if (!chave || !chave2) return -1;
+
+    return *(int *)chave != *(int *)chave2;
+}
+
+/**
+ * @brief Compara uma entrada em aberto com um código de veículo
+ * 
+ * @param entrada EntradaAberta
+ * @param codigo Código do veículo
+ * @return int -1 se erro, 0 se igual, 1 se diferente
+ */
+static int compCodEntradaAberta(void *entrada, void *codigo) {
+    if (!entrada || !codigo) return -1;
+
+    return ((EntradaAberta *)entrada)->codVeiculo != *(int *)codigo;
+}
+
+/**
+ * @brief Compara duas entradas em aberto pela linha
+ * 
+ * @param entrada1 EntradaAberta
+ * @param entrada2 EntradaAberta
+ * @return int <0, 0 ou >0 (ordem crescente da linha)
+ */
+static int compLinhaEntradaAberta(void *entrada1, void *entrada2) {
+    return ((EntradaAberta *)entrada1)->nLinha - ((EntradaAberta *)entrada2)->nLinha;
+}
+
+/**
+ * @brief Liberta uma entrada em aberto e a sua passagem
+ * 
+ * @param entrada EntradaAberta
+ */
+static void freeEntradaAberta(void *entrada) {
+    if (!entrada) return;
+
+    EntradaAberta *e = (EntradaAberta *)entrada;
+    freePassagem(e->entrada);
+    free(e->copiaLinha);
+    free(e);
+}
+
+/**
+ * @brief Obtém o registo das entradas em aberto de um veículo
+ * 
+ * @param entradas Dicionário das entradas em aberto
+ * @param codVeiculo Código do veículo
+ * @param criar 1 para criar o registo se o veículo ainda não tiver um
+ * @return EntradaAberta* Registo (a entrada pode estar fechada), NULL se não existir ou erro
+ */
+static EntradaAberta *obterEntradaAberta(Dict *entradas, int codVeiculo, int criar) {
+    EntradaAberta *e = (EntradaAberta *)searchDict(entradas, (void *)&codVeiculo, compChaveEntradaAberta, compCodEntradaAberta, hashChaveEntradaAberta);
+    if (e || !criar) return e;
+
+    e = (EntradaAberta *)calloc(1, sizeof(EntradaAberta));
+    if (!e) return NULL;
+
+    e->codVeiculo = codVeiculo;
+    if (!appendToDict(entradas, (void *)e, compChaveEntradaAberta, criarChaveEntradaAberta, hashChaveEntradaAberta, NULL, NULL)) {
+        free(e);
+        return NULL;
+    }
+    return e;
+}
+
+/**
+ * @brief Retira a passagem de entrada de um registo, deixando-o fechado
+ * 
+ * @param e Registo (pode ser NULL)
+ * @return Passagem* Entrada que estava em aberto, NULL se não havia
+ */
+static Passagem *fecharEntradaAberta(EntradaAberta *e) {
+    if (!e) return NULL;
+
+    Passagem *entrada = e->entrada;
+    e->entrada = NULL;
+    free(e->copiaLinha);
+    e->copiaLinha = NULL;
+    e->linha.tamanho = 0;
+    return entrada;
+}
+
+/**
+ * @brief Copia as linhas das entradas em aberto que ainda apontam para um buffer que vai ser libertado
+ * 
+ * @param entradas Dicionário das entradas em aberto
+ * @param inicio Início do buffer
+ * @param tamanho Tamanho do buffer
+ * 
+ * @note Se não houver memória a linha fica vazia nos logs, mas a entrada continua à espera da saída
+ */
+static void copiarLinhasAbertas(Dict *entradas, const char *inicio, size_t tamanho) {
+    for (int i = 0; i < entradas->capacidade; i++) {
+        EntradaAberta *e = (EntradaAberta *)entradas->tabela[i].obj;
+        if (!e || !e->entrada || e->copiaLinha) continue;
+        if (e->linha.inicio < inicio || e->linha.inicio >= inicio + tamanho) continue;
+
+        e->copiaLinha = (char *)malloc(e->linha.tamanho + 1);
+        if (!e->copiaLinha) {
+            e->linha.tamanho = 0;
+            continue;
+        }
+        memcpy(e->copiaLinha, e->linha.inicio, e->linha.tamanho);
+        e->copiaLinha[e->linha.tamanho] = '\0';
+        e->linha.inicio = e->copiaLinha;
+    }
+}
+
+/**
+ * @brief Regista nos logs as entradas que ficaram sem saída e liberta o dicionário das entradas em aberto
+ * 
+ * @param entradas Dicionário das entradas em aberto
+ * @param logs Registo dos logs
+ * 
+ * @note As entradas são escritas pela ordem das linhas
+ */
+static void terminarEntradasAbertas(Dict *entradas, RegistoLogs *logs) {
+    if (!entradas) return;
+
+    int nel = 0;
+    void **todas = dictToArray(entradas, &nel);
+    if (todas) {
+        int n = 0;
+        for (int i = 0; i < nel; i++) {
+            if (((EntradaAberta *)todas[i])->entrada) todas[n++] = todas[i];
+        }
+        ordenarArray(todas, n, compLinhaEntradaAberta);
+        for (int i = 0; i < n; i++) {
+            EntradaAberta *e = (EntradaAberta *)todas[i];
+            registarLinhaInvalida(logs, e->linha, e->nLinha, "Passagem de entrada sem saída correspondente");
+        }
+        free(todas);
+    }
+    freeDict(entradas, NULL, freeEntradaAberta);
+}
+
+/**
+ * @brief Cria o estado do acompanhamento de um ficheiro de passagens
+ * 
+ * @param nome Nome do ficheiro (é copiado)
+ * @param posicao Byte a seguir à última linha já lida
+ * @param nLinhas Nº de linhas já lidas
+ * @param entradas Dicionário das entradas em aberto (passa a pertencer ao estado)
+ * @return SeguimentoPassagens* NULL se erro (entradas não é libertado)
+ */
+static SeguimentoPassagens *criarSeguimentoPassagens(const char *nome, long posicao, int nLinhas, Dict *entradas) {
+    if (!nome || !entradas) return NULL;
+
+    SeguimentoPassagens *s = (SeguimentoPassagens *)malloc(sizeof(SeguimentoPassagens));
+    if (!s) return NULL;
+
+    s->nome = strdup(nome);
+    if (!s->nome) {
+        free(s);
+        return NULL;
+    }
+    s->posicao = posicao;
+    s->nLinhas = nLinhas;
+    s->entradasAbertas = entradas;
+    return s;
+}
+
+/**
+ * @brief Conta as entradas que estão à espera da saída
+ * 
+ * @param entradas Dicionário das entradas em aberto
+ * @return int Nº de entradas em aberto
+ */
+static int contarEntradasAbertas(Dict *entradas) {
+    int n = 0;
+    for (int i = 0; i < entradas->capacidade; i++) {
+        EntradaAberta *e = (EntradaAberta *)entradas->tabela[i].obj;
+        if (e && e->entrada) n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Fecha as entradas que estão em aberto há mais de timeoutPassagens minutos e escreve-as nos logs
+ * 
+ * @param entradas Dicionário das entradas em aberto
+ * @param agora Data da passagem mais recente (minutos desde a época)
+ * @param ateLinha Só as entradas até esta linha podem expirar
+ * @param logs Registo dos logs
+ * 
+ * @note Com ateLinha no início do bloco, uma entrada tem sempre o resto do seu bloco e o bloco seguinte para encontrar
+ *       a saída, mesmo que as datas do ficheiro não venham por ordem
+ */
+static void expirarEntradasAbertas(Dict *entradas, double agora, int ateLinha, RegistoLogs *logs) {
+    if (!entradas) return;
+
+    int nel = 0;
+    void **todas = dictToArray(entradas, &nel);
+    if (!todas) return;
+
+    int n = 0;
+    for (int i = 0; i < nel; i++) {
+        EntradaAberta *e = (EntradaAberta *)todas[i];
+        if (e->entrada && e->nLinha <= ateLinha && agora - minutosDesdeEpoca(&e->entrada->data) > timeoutPassagens) {
+            todas[n++] = e;
+        }
+    }
+    ordenarArray(todas, n, compLinhaEntradaAberta);
+    for (int i = 0; i < n; i++) {
+        EntradaAberta *e = (EntradaAberta *)todas[i];
+        registarLinhaInvalida(logs, e->linha, e->nLinha, "Passagem de entrada sem saída (expirou: mais de %d minutos sem a saída do veículo)", timeoutPassagens);
+        freePassagem(fecharEntradaAberta(e));
+    }
+    free(todas);
+}
+
+/**
+ * @brief Forma as viagens de um bloco já validado e escreve os logs, pela ordem do ficheiro
+ * 
+ * @param resultado BlocoLido devolvido por analisarBlocoPassagens
+ * @param contexto ContextoCarregamento (guarda as entradas em aberto entre blocos)
+ * @return int 1 se sucesso
+ * 
+ * @note Cada entrada fica em aberto, por veículo, até chegar a saída do mesmo veículo, por isso as passagens de veículos
+ *       diferentes podem vir intercaladas. Uma nova entrada do mesmo veículo descarta a anterior e uma saída mais de
+ *       timeoutPassagens minutos depois da entrada não forma viagem (a entrada expirou)
+ * @note No fim do bloco, as entradas de blocos anteriores com mais de timeoutPassagens minutos (em relação à passagem
+ *       mais recente do bloco) são fechadas, para não se acumularem as que nunca têm saída
+ */
+static int aplicarBlocoPassagens(void *resultado, void *contexto) {
+    BlocoLido *b = (BlocoLido *)resultado;
+    ContextoCarregamento *ctx = (ContextoCarregamento *)contexto;
+    RegistoLogs *logs = ctx->logs;
+    LinhaPassagemLida *linhas = (LinhaPassagemLida *)b->linhas;
+    int linhaInicial = ctx->nLinhas;
+    double maisRecente = -1; // Data (em minutos) da passagem válida mais recente do bloco
+
+    for (int i = 0; i < b->nel; i++) {
+        LinhaPassagemLida *l = &linhas[i];
+        int nLinhas = ++ctx->nLinhas;
+
+        if (l->numParam < PARAM_PASSAGEM) {
+            registarLinhaInvalida(logs, l->linha, nLinhas, "Parametros insuficientes (%d NECESSÁRIOS, %d LIDOS)", PARAM_PASSAGEM, l->numParam);
+            continue;
+        }
+        if (l->numParam > PARAM_PASSAGEM) {
+            registarLinhaInvalida(logs, l->linha, nLinhas, "Demasiados parametros (%d NECESSÁRIOS, %d LIDOS)", PARAM_PASSAGEM, l->numParam);
+            continue;
+        }
+
+        char erro = '0';
+        //ID do sensor
+        if (!l->idSensorValido) {
+            registarLinhaInvalida(logs, l->linha, nLinhas, "ID do sensor inválido");
+            erro = '1';
+        }
+        //Código do veículo
+        if (!l->codVeiculoValido) {
+            registarLinhaInvalida(logs, l->linha, nLinhas, "Código do veículo inválido");
+            erro = '1';
+        }
+        //Data
+        if (l->mensagemData) {
+            registarLinhaInvalida(logs, l->linha, nLinhas, l->mensagemData);
+            erro = '1';
+        }
+        else if (!l->dataValida) {
+            registarLinhaInvalida(logs, l->linha, nLinhas, "Data inválida");
+            erro = '1';
+        }
+        //Tipo de registo
+        if (!validarTipoRegisto(l->tipoRegisto)) {
+            registarLinhaInvalida(logs, l->linha, nLinhas, "Tipo de registo inválido");
+            erro = '1';
+        }
+        if (!l->codVeiculoValido) continue;
+
+        EntradaAberta *aberta = obterEntradaAberta(ctx->entradasAbertas, l->codVeiculo, erro == '0' && l->tipoRegisto == '0');
+        if (erro == '1') {
+            // Uma passagem inválida interrompe a viagem em curso do veículo
+            if (aberta && aberta->entrada) {
+                registarLinhaInvalida(logs, aberta->linha, aberta->nLinha, "Passagem de entrada sem saída (a passagem seguinte do veículo, na linha %d, é inválida)", nLinhas);
+                freePassagem(fecharEntradaAberta(aberta));
+            }
+            continue;
+        }
+        if (timeoutPassagens > 0) {
+            double minutos = minutosDesdeEpoca(&l->data);
+            if (minutos > maisRecente) maisRecente = minutos;
+        }
+
+        if (l->tipoRegisto == '0') {
+            // Entrada: fica à espera da saída do mesmo veículo
+            if (!aberta) {
+                registarLinhaInvalida(logs, l->linha, nLinhas, "Ocorreu um erro fatal a carregar a linha para a memória");
+                continue;
+            }
+            if (aberta->entrada) {
+                registarLinhaInvalida(logs, aberta->linha, aberta->nLinha, "Passagem de entrada sem saída (o veículo voltou a entrar na linha %d)", nLinhas);
+                freePassagem(fecharEntradaAberta(aberta));
+            }
+            aberta->entrada = obterPassagem(l->idSensor, l->data, l->tipoRegisto);
+            if (!aberta->entrada) {
+                registarLinhaInvalida(logs, l->linha, nLinhas, "Ocorreu um erro fatal a carregar a linha para a memória");
+                continue;
+            }
+            aberta->nLinha = nLinhas;
+            aberta->linha = l->linha;
+            continue;
+        }
+
+        // Saída: fecha a entrada em aberto do veículo
+        Passagem *entrada = fecharEntradaAberta(aberta);
+        if (!entrada) {
+            registarLinhaInvalida(logs, l->linha, nLinhas, "Passagem de saída sem entrada do mesmo veículo");
+            continue;
+        }
+        if (compararDatas(entrada->data, l->data) == 1) {
+            registarLinhaInvalida(logs, l->linha, nLinhas, "Data da passagem de saída inválida (entrada também foi invalidada - linha %d)", aberta->nLinha);
+            freePassagem(entrada);
+            continue;
+        }
+        if (timeoutPassagens > 0 && minutosDesdeEpoca(&l->data) - minutosDesdeEpoca(&entrada->data) > timeoutPassagens) {
+            registarLinhaInvalida(logs, l->linha, nLinhas, "A entrada do veículo (linha %d) expirou: passaram mais de %d minutos até à saída", aberta->nLinha, timeoutPassagens);
+            freePassagem(entrada);
+            continue;
+        }
+        Passagem *saida = obterPassagem(l->idSensor, l->data, l->tipoRegisto);
+        if (!saida) {
+            freePassagem(entrada);
+            registarLinhaInvalida(logs, l->linha, nLinhas, "Ocorreu um erro a carregar a viagem para memória");
+            continue;
+        }
+        if (!inserirViagemLido(ctx->bd, entrada, saida, l->codVeiculo)) {
+            registarLinhaInvalida(logs, l->linha, nLinhas, "Ocorreu um erro a carregar a viagem para memória");
+        }
+    }
+    if (timeoutPassagens > 0 && maisRecente >= 0) {
+        expirarEntradasAbertas(ctx->entradasAbertas, maisRecente, linhaInicial, logs);
+    }
     return 1;
 }
 
@@ -457,144 +1180,350 @@ int carregarDistanciasTxt(Bdados *bd, char *distanciasFilename, FILE *logs) {
  * 
  * @param bd Base de dados
  * @param passagensFilename Nome do ficheiro das passagens
- * @param logs Ficheiro de logs, aberto
+ * @param logs Registo dos logs
  * @return int 0 se erro, 1 se sucesso
+ * 
+ * @note As linhas são validadas em paralelo (numThreads) e as viagens formadas por ordem, pelo que os logs não mudam
+ * @note As passagens de vários veículos podem vir intercaladas: cada entrada espera pela saída do mesmo veículo
+ * @note A posição lida e as entradas ainda sem saída ficam em bd->seguimento, para o acompanhamento do ficheiro
+ *       continuar a partir do fim do carregamento
  */
-int carregarPassagensTxt(Bdados *bd, char *passagensFilename, FILE *logs) {
+int carregarPassagensTxt(Bdados *bd, char *passagensFilename, RegistoLogs *logs) {
     const char *passagensFile = (passagensFilename) ? passagensFilename : PASSAGEM_TXT;
 
     time_t inicio = time(NULL);   
-    fprintf(logs, "#FICHEIRO PASSAGENS#\t\t%s\n", ctime(&inicio));
+    escreverLog(logs, "#FICHEIRO PASSAGENS#\t\t%s\n", ctime(&inicio));
+    EtapaPerfil *perfil = novaEtapaPerfil(&perfilCarregamento, "Passagens");
+    double inicioPerfil = tempoAtual();
 
-    FILE *passagem = fopen(passagensFile, "r");
+    FicheiroTxt *passagem = abrirFicheiroTxt(passagensFile);
     if (passagem) {
-        int nLinhas = 0;
-        int nPassagens = 0; //Para verificar os pares das viagens
-        char *linha = NULL;
-        Passagem *viagem[2] = {NULL, NULL};
-
-        while((linha = lerLinhaTxt(passagem, &nLinhas)) != NULL) {
-            int indice = (nPassagens % 2 == 0) ? 0 : 1; // Índice do array
-            if (indice == 1 && !viagem[0]) {
-                // A primeira passagem foi inválida
-                linhaInvalida(linha, nLinhas, logs);
-                fprintf(logs, "Razão: É o par de uma passagem inválida!\n\n");
-                free(linha);
-                nPassagens++;
-                continue; // Passar à frente
-            }
-
-            char *parametros[PARAM_PASSAGEM];
-            int numParam = 0; //Nº real de param lidos
-            char *copiaLinha = strdup(linha);
-            separarParametros(copiaLinha, parametros, &numParam, PARAM_PASSAGEM);
-            char erro = '0';
-
-            if (numParam == PARAM_PASSAGEM) {
-                //ID do sensor
-                int idSensor;
-                if (!stringToInt(parametros[0], &idSensor) || !validarCodSensor(idSensor)) {
-                    linhaInvalida(linha, nLinhas, logs);
-                    fprintf(logs, "Razão: ID do sensor inválido\n\n");
-                    erro = '1';
-                }
-                //Código do veículo
-                int codVeiculo;
-                if (!stringToInt(parametros[1], &codVeiculo) || !validarCodVeiculo(codVeiculo)) {
-                    linhaInvalida(linha, nLinhas, logs);
-                    fprintf(logs, "Razão: Código do veículo inválido\n\n");
-                    erro = '1';
-                }
-                //Data
-                Data date;
-                char *mensagemData = NULL;
-                mensagemData = converterParaData(parametros[2], &date);
-                if (mensagemData) {
-                    linhaInvalida(linha, nLinhas, logs);
-                    fprintf(logs, "Razão: %s\n\n", mensagemData);
-                    erro = '1';
-                }
-                else if (!validarData(date, '0')) {
-                    linhaInvalida(linha, nLinhas, logs);
-                    fprintf(logs, "Razão: Data inválida\n\n");
-                    erro = '1';
-                }
-                //Tipo de registo
-                if (!validarTipoRegisto(parametros[3][0])) {
-                    linhaInvalida(linha, nLinhas, logs);
-                    fprintf(logs, "Razão: Tipo de registo inválido\n\n");
-                    erro = '1';
-                }
-                if (indice == 1 && viagem[0]->tipoRegisto == parametros[3][0]) {
-                    linhaInvalida(linha, nLinhas, logs);
-                    fprintf(logs, "Razão: Tipo de registo inválido no par de passagem\n\n");
-                    erro = '1';
-                }
-                if (indice == 1 && compararDatas(viagem[0]->data, date) == 1) {
-                    linhaInvalida(linha, nLinhas, logs);
-                    fprintf(logs, "Razão: Data da passagem de saída inválida (entrada também foi invalidada - linha %d)\n\n", nLinhas - 1);
-                    erro = '1';
-                }
-
-                //Caso não haja erro passar os dados para as estruturas
-                if (erro == '0') {
-                    viagem[indice] = obterPassagem(idSensor, date, parametros[3][0]);
-                    if (!viagem[indice] && indice == 1) {
-                        freePassagem(viagem[0]);
-                        viagem[0] = NULL;
-                        viagem[1] = NULL;
-                    }
-                    else {
-                        // Inserir viagem apenas se já tivermos 2 passagens
-                        if (indice == 1) {
-                            if (!inserirViagemLido(bd, viagem[0], viagem[1], codVeiculo)) {
-                                linhaInvalida(linha, nLinhas, logs);
-                                fprintf(logs, "Razão: Ocorreu um erro a carregar a viagem para memória\n\n");
-                            }
-                            // Dar set da viagem para o próximo par
-                            viagem[0] = NULL;
-                            viagem[1] = NULL;
-                        }
-                    }
-                }
-                if (erro == '1' && viagem[0] != NULL) {
-                    freePassagem(viagem[0]);
-                    viagem[0] = NULL;
-                    viagem[1] = NULL;
-                }
-            }
-            else if (numParam < PARAM_PASSAGEM) {
-                linhaInvalida(linha, nLinhas, logs);
-                fprintf(logs, "Razão: Parametros insuficientes (%d NECESSÁRIOS, %d LIDOS)\n\n", PARAM_PASSAGEM, numParam);
-            }
-            else {
-                linhaInvalida(linha, nLinhas, logs);
-                fprintf(logs, "Razão: Demasiados parametros (%d NECESSÁRIOS, %d LIDOS)\n\n", PARAM_PASSAGEM, numParam);
-            }
-            free(copiaLinha);
-            free(linha); 
-            nPassagens++;
+        // Cada viagem (duas passagens) ocupa dois nós: na lista do carro e em bd->viagens
+        (void)reservarNosLista(contarLinhasTxt(passagem));
+        perfil->nBytes = passagem->tamanho;
+        perfil->fases[FASE_LEITURA] += tempoAtual() - inicioPerfil;
+        // Um registo por veículo, no máximo: o dicionário não cresce durante o carregamento
+        ContextoCarregamento ctx = {bd, logs, 0, criarDict(DICT_CHAVE_UNICA, sizeof(int))};
+        if (!ctx.entradasAbertas) {
+            escreverLog(logs, "Ocorreu um erro fatal a preparar o carregamento das passagens\n\n");
+            fecharFicheiroTxt(passagem);
+            return 0;
         }
-        // Limpar última passagem caso fique pendente
-        if (viagem[0]) {
-            freePassagem(viagem[0]);
+        (void)reservarDict(ctx.entradasAbertas, bd->carrosCod->nelDict);
+        // Uma última linha sem '\n' pode ainda estar a ser escrita: fica para o acompanhamento do ficheiro
+        FicheiroTxt completas = *passagem;
+        completas.tamanho = fimLinhasCompletasTxt(passagem);
+        if (completas.tamanho < passagem->tamanho) {
+            escreverLog(logs, "A última linha do ficheiro não está terminada e só vai ser lida quando o for (acompanhamento do ficheiro)\n\n");
+        }
+        int erroLeitura = 0;
+        if (!carregarFicheiroTxtParalelo(&completas, analisarBlocoPassagens, aplicarBlocoPassagens, freeBlocoLido, &ctx, perfil)) {
+            escreverLog(logs, "Ocorreu um erro fatal a carregar o ficheiro de Passagens para a memória (depois da linha %d)\n\n", ctx.nLinhas);
+            erroLeitura = 1;
+        }
+        perfil->nLinhas = ctx.nLinhas;
+        // As entradas que ficaram por fechar passam para o acompanhamento do ficheiro, que continua a partir daqui
+        terminarSeguimentoPassagens(bd->seguimento, logs);
+        bd->seguimento = (erroLeitura) ? NULL : criarSeguimentoPassagens(passagensFile, (long)completas.tamanho, ctx.nLinhas, ctx.entradasAbertas);
+        if (bd->seguimento) {
+            copiarLinhasAbertas(ctx.entradasAbertas, passagem->dados, completas.tamanho);
+            int abertas = contarEntradasAbertas(ctx.entradasAbertas);
+            if (abertas > 0) {
+                escreverLog(logs, "%d passagem(ns) de entrada ficaram à espera da saída (continuam no acompanhamento do ficheiro)\n", abertas);
+            }
         }
-        if (viagem[1]) {
-            freePassagem(viagem[1]);
+        else {
+            // As linhas das entradas que ficaram por fechar ainda estão no ficheiro
+            terminarEntradasAbertas(ctx.entradasAbertas, logs);
         }
-        fclose(passagem);
+        fecharFicheiroTxt(passagem);
     }
     else {
-        fprintf(logs, "Ocorreu um erro ao abrir o ficheiro de Passagens: '%s'.\n\n", passagensFile);
+        escreverLog(logs, "Ocorreu um erro ao abrir o ficheiro de Passagens: '%s'.\n\n", passagensFile);
         return 0;
     }
+    escreverResumoLogs(logs);
+    perfil->tempo = tempoAtual() - inicioPerfil;
     time_t fim = time(NULL);
     char *tempoFinal = ctime(&fim); // Não precisa de free
     tempoFinal[strcspn(tempoFinal, "\n")] = '\0';
-    fprintf(logs, "\n#FIM FICHEIRO PASSAGENS#\t\t%s\t\tTEMPO DE CARREGAMENTO:%.0fsegundos\n\n", tempoFinal, difftime(fim, inicio));
+    escreverLog(logs, "\n#FIM FICHEIRO PASSAGENS#\t\t%s\t\tTEMPO DE CARREGAMENTO:%.3fsegundos\n\n", tempoFinal, perfil->tempo);
     return 1;
 }
 
+// Acompanhamento de um ficheiro de passagens que vai crescendo: só os bytes acrescentados são lidos
+
+/**
+ * @brief Começa a acompanhar um ficheiro de passagens a partir do seu fim atual
+ * 
+ * @param bd Base de dados (para dimensionar as entradas em aberto)
+ * @param nome Nome do ficheiro (pode ainda não existir)
+ * @return SeguimentoPassagens* Estado do acompanhamento ou NULL se erro
+ * 
+ * @note Só é usado quando não há onde continuar (bd->seguimento é de outro ficheiro ou não existe): o que já está no
+ *       ficheiro não é lido. Uma última linha incompleta fica para ser lida quando for terminada
+ */
+SeguimentoPassagens *iniciarSeguimentoPassagens(Bdados *bd, const char *nome) {
+    if (!bd || !nome) return NULL;
+
+    Dict *entradas = criarDict(DICT_CHAVE_UNICA, sizeof(int));
+    if (!entradas) return NULL;
+    (void)reservarDict(entradas, bd->carrosCod->nelDict);
+
+    long posicao = 0;
+    int nLinhas = 0;
+    FicheiroTxt *f = abrirFicheiroTxt(nome);
+    if (f) {
+        // Parar no fim da última linha completa
+        FicheiroTxt completas = *f;
+        completas.tamanho = fimLinhasCompletasTxt(f);
+        posicao = (long)completas.tamanho;
+        nLinhas = contarLinhasTxt(&completas);
+        fecharFicheiroTxt(f);
+    }
+    SeguimentoPassagens *s = criarSeguimentoPassagens(nome, posicao, nLinhas, entradas);
+    if (!s) freeDict(entradas, NULL, freeEntradaAberta);
+    return s;
+}
+
+/**
+ * @brief Lê as linhas completas acrescentadas ao ficheiro desde a última leitura e insere as viagens que fecham
+ * 
+ * @param s Estado do acompanhamento
+ * @param bd Base de dados
+ * @param logs Registo dos logs
+ * @return int Nº de linhas lidas, -1 se erro
+ * 
+ * @note As passagens passam pelo mesmo leitor (ficheiro mapeado, a partir de s->posicao), pelas mesmas validações e
+ *       pelo mesmo emparelhamento por veículo do carregamento, e as entradas em aberto são guardadas entre leituras.
+ *       Se o ficheiro ficar mais pequeno (foi truncado ou substituído) volta a ser lido desde o início
+ */
+int lerNovasPassagens(SeguimentoPassagens *s, Bdados *bd, RegistoLogs *logs) {
+    if (!s || !bd) return -1;
+
+    FicheiroTxt *f = abrirFicheiroTxt(s->nome);
+    if (!f) return 0; // Pode ainda não ter sido criado
+
+    if (f->tamanho < (size_t)s->posicao) {
+        escreverLog(logs, "O ficheiro '%s' ficou mais pequeno e vai ser lido desde o início\n", s->nome);
+        s->posicao = 0;
+        s->nLinhas = 0;
+    }
+    // Apenas as linhas completas acrescentadas: o resto é lido quando o escritor terminar a linha
+    f->pos = (size_t)s->posicao;
+    FicheiroTxt novas = *f;
+    novas.tamanho = fimLinhasCompletasTxt(f);
+    if (novas.tamanho == novas.pos) {
+        fecharFicheiroTxt(f);
+        return 0;
+    }
+
+    ContextoCarregamento ctx = {bd, logs, s->nLinhas, s->entradasAbertas};
+    int sucesso = carregarFicheiroTxtParalelo(&novas, analisarBlocoPassagens, aplicarBlocoPassagens, freeBlocoLido, &ctx, NULL);
+    int lidas = ctx.nLinhas - s->nLinhas;
+    size_t posicao = novas.tamanho;
+    if (!sucesso) {
+        // Só as linhas aplicadas contam: a próxima leitura continua a seguir à última
+        Fatia resto = {f->dados + s->posicao, novas.tamanho - (size_t)s->posicao};
+        Fatia linha;
+        for (int i = 0; i < lidas && proximaLinhaFatia(&resto, &linha); i++);
+        posicao = (size_t)(resto.inicio - f->dados);
+    }
+    s->nLinhas = ctx.nLinhas;
+    s->posicao = (long)posicao;
+    // As linhas das entradas em aberto deixam de existir quando o ficheiro é fechado
+    copiarLinhasAbertas(s->entradasAbertas, f->dados, novas.tamanho);
+    fecharFicheiroTxt(f);
+    return (sucesso) ? lidas : -1;
+}
+
+/**
+ * @brief Liberta o estado do acompanhamento: as entradas que ficaram sem saída são escritas nos logs
+ * 
+ * @param s Estado do acompanhamento (pode ser NULL)
+ * @param logs Registo dos logs (pode ser NULL, para só libertar)
+ */
+void terminarSeguimentoPassagens(SeguimentoPassagens *s, RegistoLogs *logs) {
+    if (!s) return;
+
+    terminarEntradasAbertas(s->entradasAbertas, logs);
+    free(s->nome);
+    free(s);
+}
+
+/**
+ * @brief Guarda o estado do acompanhamento do ficheiro de passagens num ficheiro binário
+ * 
+ * @param s Estado (pode ser NULL)
+ * @param file Ficheiro binário, aberto
+ */
+static void guardarSeguimentoPassagensBin(SeguimentoPassagens *s, FILE *file) {
+    int existe = (s != NULL);
+    fwrite(&existe, sizeof(int), 1, file);
+    if (!s) return;
+
+    size_t tamanhoNome = strlen(s->nome);
+    fwrite(&tamanhoNome, sizeof(size_t), 1, file);
+    fwrite(s->nome, tamanhoNome, 1, file);
+    fwrite(&s->posicao, sizeof(long), 1, file);
+    fwrite(&s->nLinhas, sizeof(int), 1, file);
+
+    int n = contarEntradasAbertas(s->entradasAbertas);
+    fwrite(&n, sizeof(int), 1, file);
+    for (int i = 0; i < s->entradasAbertas->capacidade; i++) {
+        EntradaAberta *e = (EntradaAberta *)s->entradasAbertas->tabela[i].obj;
+        if (!e || !e->entrada) continue;
+
+        fwrite(&e->codVeiculo, sizeof(int), 1, file);
+        fwrite(&e->nLinha, sizeof(int), 1, file);
+        guardarPassagemBin((void *)e->entrada, file);
+        fwrite(&e->linha.tamanho, sizeof(size_t), 1, file);
+        fwrite(e->linha.inicio, e->linha.tamanho, 1, file);
+    }
+}
+
+/**
+ * @brief Lê o estado do acompanhamento do ficheiro de passagens de um ficheiro binário
+ * 
+ * @param file Ficheiro binário, aberto
+ * @param erro Fica a 1 se o ficheiro estiver incompleto ou corrompido
+ * @return SeguimentoPassagens* NULL se não foi guardado ou se erro
+ * 
+ * @note As linhas das entradas em aberto ficam em copiaLinha (o ficheiro de passagens não é aberto)
+ */
+static SeguimentoPassagens *readSeguimentoPassagensBin(FILE *file, int *erro) {
+    *erro = 0;
+    int existe = 0;
+    if (fread(&existe, sizeof(int), 1, file) != 1) {
+        *erro = 1;
+        return NULL;
+    }
+    if (!existe) return NULL;
+
+    size_t tamanhoNome = 0;
+    if (fread(&tamanhoNome, sizeof(size_t), 1, file) != 1 || tamanhoNome == 0 || tamanhoNome > MAX_NOME_FICHEIRO_BIN) {
+        *erro = 1;
+        return NULL;
+    }
+    char nome[MAX_NOME_FICHEIRO_BIN + 1];
+    long posicao = 0;
+    int nLinhas = 0, n = 0;
+    if (fread(nome, tamanhoNome, 1, file) != 1 || fread(&posicao, sizeof(long), 1, file) != 1 ||
+        fread(&nLinhas, sizeof(int), 1, file) != 1 || fread(&n, sizeof(int), 1, file) != 1 || posicao < 0 || nLinhas < 0 || n < 0) {
+        *erro = 1;
+        return NULL;
+    }
+    nome[tamanhoNome] = '\0';
+
+    Dict *entradas = criarDict(DICT_CHAVE_UNICA, sizeof(int));
+    if (!entradas) {
+        *erro = 1;
+        return NULL;
+    }
+    for (int i = 0; i < n && !*erro; i++) {
+        int codVeiculo = 0, nLinha = 0;
+        size_t tamanhoLinha = 0;
+        if (fread(&codVeiculo, sizeof(int), 1, file) != 1 || fread(&nLinha, sizeof(int), 1, file) != 1) {
+            *erro = 1;
+            break;
+        }
+        Passagem *entrada = (Passagem *)readPassagemBin(file);
+        EntradaAberta *e = (entrada) ? obterEntradaAberta(entradas, codVeiculo, 1) : NULL;
+        if (!e || e->entrada || fread(&tamanhoLinha, sizeof(size_t), 1, file) != 1 || tamanhoLinha > MAX_LINHA_BIN ||
+            !(e->copiaLinha = (char *)malloc(tamanhoLinha + 1)) || (tamanhoLinha > 0 && fread(e->copiaLinha, tamanhoLinha, 1, file) != 1)) {
+            freePassagem(entrada);
+            *erro = 1;
+            break;
+        }
+        e->copiaLinha[tamanhoLinha] = '\0';
+        e->entrada = entrada;
+        e->nLinha = nLinha;
+        e->linha.inicio = e->copiaLinha;
+        e->linha.tamanho = tamanhoLinha;
+    }
+
+    SeguimentoPassagens *s = (*erro) ? NULL : criarSeguimentoPassagens(nome, posicao, nLinhas, entradas);
+    if (!s) freeDict(entradas, NULL, freeEntradaAberta);
+    return s;
+}
+
+/**
+ * @brief Acompanha o ficheiro das passagens até o utilizador pressionar ENTER, inserindo as viagens novas
+ * 
+ * @param bd Base de dados
+ * 
+ * @note O ficheiro é verificado a cada INTERVALO_ACOMPANHAMENTO milissegundos (funciona em qualquer sistema, sem inotify).
+ *       As linhas inválidas de cada verificação são escritas logo nos logs
+ * @note Continua onde o carregamento ou a sessão anterior pararam (bd->seguimento), com as entradas que lá ficaram à
+ *       espera da saída; no fim os dados só são guardados se o autosave estiver ativo
+ */
+void acompanharPassagensTxt(Bdados *bd) {
+    if (!bd) return;
+
+    limpar_terminal();
+    const char *passagensFile = (passagensFilename) ? passagensFilename : PASSAGEM_TXT;
+    FILE *ficheiroLogs = fopen(LOGS_TXT, "a");
+    if (!ficheiroLogs) {
+        printf("Ocorreu um erro ao abrir o ficheiro de logs '%s'.\n\n", LOGS_TXT);
+        pressEnter();
+        return;
+    }
+    time_t inicio = time(NULL);
+    fprintf(ficheiroLogs, "\n#ACOMPANHAMENTO DO FICHEIRO DE PASSAGENS#\t\t%s\t\t%s", passagensFile, ctime(&inicio));
+    SeguimentoPassagens *s = bd->seguimento;
+    if (s && strcmp(s->nome, passagensFile) != 0) {
+        // Outro ficheiro: a posição guardada não serve e as entradas em aberto não vão ter saída
+        RegistoLogs *logs = criarRegistoLogs(ficheiroLogs, 0, limiteExemplosLogs);
+        escreverLog(logs, "O ficheiro de passagens mudou ('%s' para '%s'): começa no fim do novo ficheiro\n", s->nome, passagensFile);
+        terminarSeguimentoPassagens(s, logs);
+        escreverResumoLogs(logs);
+        fecharRegistoLogs(logs);
+        s = NULL;
+    }
+    if (!s) {
+        s = iniciarSeguimentoPassagens(bd, passagensFile);
+    }
+    bd->seguimento = s;
+    if (!s) {
+        printf("Ocorreu um erro a preparar o acompanhamento de '%s'.\n\n", passagensFile);
+        fclose(ficheiroLogs);
+        pressEnter();
+        return;
+    }
+    fflush(ficheiroLogs);
+    printf("A acompanhar '%s' a partir da linha %d.\n", passagensFile, s->nLinhas + 1);
+    printf("#Pressione ENTER para terminar#\n\n");
+
+    int viagensInicio = bd->viagens->nel;
+    int linhasLidas = 0;
+    do {
+        RegistoLogs *logs = criarRegistoLogs(ficheiroLogs, 0, limiteExemplosLogs);
+        if (!logs) break;
+
+        int viagensAntes = bd->viagens->nel;
+        int lidas = lerNovasPassagens(s, bd, logs);
+        escreverResumoLogs(logs);
+        fecharRegistoLogs(logs);
+        if (lidas < 0) {
+            printf("Ocorreu um erro a ler '%s'.\n", passagensFile);
+        }
+        else if (lidas > 0) {
+            linhasLidas += lidas;
+            printf("%d linha(s) nova(s), %d viagem(ns) nova(s).\n", lidas, bd->viagens->nel - viagensAntes);
+        }
+    } while (!esperarEnter(INTERVALO_ACOMPANHAMENTO));
+
+    time_t fim = time(NULL);
+    char *tempoFinal = ctime(&fim); // Não precisa de free
+    tempoFinal[strcspn(tempoFinal, "\n")] = '\0';
+    fprintf(ficheiroLogs, "#FIM DO ACOMPANHAMENTO#\t\t%s\t\tLINHAS LIDAS:%d\t\tVIAGENS NOVAS:%d\n\n", tempoFinal, linhasLidas, bd->viagens->nel - viagensInicio);
+    fclose(ficheiroLogs);
+    printf("\nAcompanhamento terminado: %d linha(s) lida(s), %d viagem(ns) nova(s).\n\n", linhasLidas, bd->viagens->nel - viagensInicio);
+    // As viagens novas e a posição lida ficam juntas em bd, e são guardadas juntas (aqui se autosaveON, senão à saída)
+    autosave(bd);
+    pressEnter();
+}
+
 /** 
  * @brief Remove espaços extra de uma string
  * @param str    String a modificar (se necessário)
@@ -673,20 +1602,13 @@ void linhaInvalida(const char *linha, int nLinha, FILE *logs) {
  * @return int -1 se erro, Nº linhas caso contrário
  */
 int contarLinhas(const char *filename) {
-    FILE *f = fopen(filename, "r");
+    FicheiroTxt *f = abrirFicheiroTxt(filename);
     if (!f) {
         return -1;
     }
 
-    int linhas = 0;
-    int c;
-    while ((c = fgetc(f)) != EOF) {
-        if (c == '\n') {
-            linhas++;
-        }
-    }
-
-    fclose(f);
+    int linhas = contarLinhasTxt(f);
+    fecharFicheiroTxt(f);
 
     return linhas;
 }
@@ -706,6 +1628,11 @@ int guardarDadosBin(Bdados *bd, const char *nome) {
     FILE *file = fopen(nome, "wb");
     if (!file) return 0;
 
+    // Cabeçalho: identifica o ficheiro e o formato
+    int versao = VERSAO_BIN;
+    fwrite(MAGICO_BIN, 1, TAMANHO_MAGICO_BIN, file);
+    fwrite(&versao, sizeof(int), 1, file);
+
     // Checkum
     unsigned long sum = checksum(bd);
     fwrite(&sum, sizeof(unsigned long), 1, file);
@@ -717,7 +1644,8 @@ int guardarDadosBin(Bdados *bd, const char *nome) {
 
     // Donos
     guardarDadosDictBin(bd->donosNif, guardarDonoBin, file);
-    // Carros
+    // Carros (marcas e modelos primeiro, os carros só guardam os ids)
+    guardarMarcasModelosBin(file);
     guardarDadosDictBin(bd->carrosCod, guardarCarroBin, file);
     // Sensores
     guardarListaBin(bd->sensores, guardarSensorBin, file);
@@ -725,6 +1653,8 @@ int guardarDadosBin(Bdados *bd, const char *nome) {
     guardarListaBin(bd->viagens, guardarViagemBin, file);
     // Distâncias
     guardarDistanciasBin(bd->distancias, file);
+    // Até onde o ficheiro de passagens já foi lido
+    guardarSeguimentoPassagensBin(bd->seguimento, file);
     
     fclose(file);
     return 1;
@@ -768,12 +1698,83 @@ void guardarDadosBinFicheiro(Bdados *bd) {
     pressEnter();
 }
 
+/**
+ * @brief Fecha uma etapa do carregamento binário e marca o início da próxima
+ * 
+ * @param perfil Etapa
+ * @param nRegistos Nº de registos lidos na etapa
+ * @param file Ficheiro binário
+ * @param posicao Posição no ficheiro no início da etapa, é atualizada
+ * @param inicio Instante do início da etapa, é atualizado
+ */
+static void terminarEtapaBin(EtapaPerfil *perfil, long nRegistos, FILE *file, long *posicao, double *inicio) {
+    long fim = ftell(file);
+    double agora = tempoAtual();
+
+    perfil->nLinhas = nRegistos;
+    perfil->nBytes = (fim >= *posicao) ? (size_t)(fim - *posicao) : 0;
+    perfil->tempo = agora - *inicio;
+    *posicao = fim;
+    *inicio = agora;
+}
+
+/**
+ * @brief Acrescenta o relatório do último carregamento ao ficheiro de logs
+ * 
+ * @param nomeLogs Ficheiro de logs
+ */
+static void guardarPerfilLogs(const char *nomeLogs) {
+    char relatorio[TAMANHO_RELATORIO_PERFIL];
+    if (!formatarPerfil(&perfilCarregamento, relatorio, sizeof(relatorio))) return;
+
+    FILE *ficheiroLogs = fopen(nomeLogs, "a");
+    if (!ficheiroLogs) return;
+
+    fprintf(ficheiroLogs, "\n%s\n", relatorio);
+    fclose(ficheiroLogs);
+}
+
+/**
+ * @brief Liberta o que já foi lido de um ficheiro binário cujo carregamento falhou
+ * 
+ * @param bd Base de dados (os campos ficam a NULL, prontos para inicializarBD)
+ * @param file Ficheiro a fechar
+ * @return int 0, para ser devolvido por carregarDadosBin
+ */
+static int falharCarregamentoBin(Bdados *bd, FILE *file) {
+    arenaLeituraBin = NULL;
+    terminarPerfil(&perfilCarregamento);
+    fclose(file);
+
+    freeDict(bd->carrosMarca, NULL, NULL);
+    freeDict(bd->carrosMat, NULL, NULL);
+    freeDict(bd->carrosCod, NULL, freeCarro);
+    freeDict(bd->donosAlfabeticamente, freeChaveDonoAlfabeticamente, NULL);
+    freeDict(bd->donosNif, NULL, freeDono);
+    freeLista(bd->sensores, freeSensor);
+    freeLista(bd->viagens, freeViagem);
+    freeArena(bd->strings);
+    freeMarcasModelos();
+
+    bd->carrosMarca = bd->carrosMat = bd->carrosCod = NULL;
+    bd->donosAlfabeticamente = bd->donosNif = NULL;
+    bd->sensores = bd->viagens = NULL;
+    bd->distancias = NULL;
+    bd->strings = NULL;
+    return 0;
+}
+
 /**
  * @brief Carrega os dados de ficheiro binário para memória
  * 
  * @param bd Base de dados
  * @param nome Nome do ficheiro a ler
  * @return int 1 se sucesso, 0 se erro
+ * 
+ * @note Um ficheiro sem o cabeçalho MAGICO_BIN/VERSAO_BIN (de outro formato ou de uma versão anterior) é rejeitado
+ *       antes de se ler ou alocar o que quer que seja
+ * @note Se uma das estruturas não puder ser lida (ficheiro truncado ou falta de memória), o que já foi lido é libertado
+ *       e devolve 0, para se poder voltar a carregar a partir dos ficheiros .txt
  */
 int carregarDadosBin(Bdados *bd, const char *nome) {
     if (!bd || !nome) return 0;
@@ -781,7 +1782,27 @@ int carregarDadosBin(Bdados *bd, const char *nome) {
     FILE *file = fopen(nome, "rb");
     if (!file) return 0;
 
+    // Cabeçalho
+    char magico[TAMANHO_MAGICO_BIN];
+    int versao = 0;
+    if (fread(magico, 1, TAMANHO_MAGICO_BIN, file) != TAMANHO_MAGICO_BIN || memcmp(magico, MAGICO_BIN, TAMANHO_MAGICO_BIN) != 0 ||
+        fread(&versao, sizeof(int), 1, file) != 1 || versao != VERSAO_BIN) {
+        fclose(file);
+        return 0;
+    }
+
     printf("\n\nA carregar dados...\n\n");
+    iniciarPerfil(&perfilCarregamento, "bin");
+    bd->seguimento = NULL;
+    bd->carrosMarca = bd->carrosMat = bd->carrosCod = NULL;
+    bd->donosAlfabeticamente = bd->donosNif = NULL;
+    bd->sensores = bd->viagens = NULL;
+    bd->distancias = NULL;
+
+    // As strings lidas (readDonoBin, readCarroBin, readSensorBin) ficam na arena da base de dados
+    bd->strings = criarArena();
+    if (!bd->strings) return falharCarregamentoBin(bd, file);
+    arenaLeituraBin = bd->strings;
 
     // Checksum
     unsigned long sum = 0;
@@ -793,25 +1814,23 @@ int carregarDadosBin(Bdados *bd, const char *nome) {
     fread(&pausaListagem, sizeof(int), 1, file);
 
     // Donos
-    bd->donosNif = readToDictBin(criarChaveDonoNif, hashChaveDonoNif, freeDono, freeChaveDonoNif, readDonoBin, file);
-    bd->donosAlfabeticamente = criarDict();
+    EtapaPerfil *perfil = novaEtapaPerfil(&perfilCarregamento, "Donos");
+    long posicao = ftell(file);
+    double inicio = tempoAtual();
+    bd->donosNif = readToDictBin(DICT_CHAVE_UNICA, sizeof(int), criarChaveDonoNif, hashChaveDonoNif, freeDono, NULL, readDonoBin, file);
+    double t = tempoAtual();
+    perfil->fases[FASE_LEITURA] = t - inicio;
+    bd->donosAlfabeticamente = criarDict(DICT_MULTIPLO, CHAVE_ALOCADA);
+    if (!bd->donosNif || !bd->donosAlfabeticamente) return falharCarregamentoBin(bd, file);
     // Iterar o dict dos nifs e introduzir o ponteiro no bd->donosAlfabeticamente
-    for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-        NoHashing *p = bd->donosNif->tabela[i];
-
-        while(p) {
-            if (p->dados) {
-                No *x = p->dados->inicio;
+    for (int i = 0; i < bd->donosNif->capacidade; i++) {
+        NoHashing *p = &bd->donosNif->tabela[i];
+        if (!p->obj) continue;
 
-                while(x) {
-                    (void)appendToDict(bd->donosAlfabeticamente, x->info, compChaveDonoAlfabeticamente, criarChaveDonoAlfabeticamente, hashChaveDonoAlfabeticamente, NULL, freeChaveDonoAlfabeticamente);
-                    
-                    x = x->prox;
-                }
-            }
-            p = p->prox;
-        }
+        (void)appendToDict(bd->donosAlfabeticamente, p->obj, compChaveDonoAlfabeticamente, criarChaveDonoAlfabeticamente, hashChaveDonoAlfabeticamente, NULL, freeChaveDonoAlfabeticamente);
     }
+    perfil->fases[FASE_INSERCAO] = tempoAtual() - t;
+    t = tempoAtual();
     // Ordenar Donos Alfabeticamente
     for (char i = 'a'; i <= 'z'; i++) {
         void *letra = (void *)&i;
@@ -820,49 +1839,65 @@ int carregarDadosBin(Bdados *bd, const char *nome) {
             mergeSortLista(p, compDonosNome);
         }
     }
+    perfil->fases[FASE_ORDENACAO] = tempoAtual() - t;
+    terminarEtapaBin(perfil, bd->donosNif->nelDict, file, &posicao, &inicio);
 
     // Carros
-    bd->carrosCod = readToDictBin(criarChaveCarroCod, hashChaveCarroCod, freeCarro, freeChaveCarroCod, readCarroBin, file);
-    bd->carrosMarca = criarDict();
-    bd->carrosMat = criarDict();
+    perfil = novaEtapaPerfil(&perfilCarregamento, "Carros");
+    (void)readMarcasModelosBin(file); // Se falhar, readCarroBin rejeita os ids desconhecidos
+    bd->carrosCod = readToDictBin(DICT_CHAVE_UNICA, sizeof(int), criarChaveCarroCod, hashChaveCarroCod, freeCarro, NULL, readCarroBin, file);
+    t = tempoAtual();
+    perfil->fases[FASE_LEITURA] = t - inicio;
+    if (!bd->carrosCod) return falharCarregamentoBin(bd, file);
+    bd->carrosMarca = criarDict(DICT_MULTIPLO, sizeof(uint16_t));
+    bd->carrosMat = criarDict(DICT_CHAVE_UNICA, sizeof(uint32_t));
+    if (!bd->carrosMarca || !bd->carrosMat) {
+        // Os carros ainda apontam para o Dono temporário lido do ficheiro
+        for (int i = 0; i < bd->carrosCod->capacidade; i++) {
+            Carro *carro = (Carro *)bd->carrosCod->tabela[i].obj;
+            if (carro) free(carro->ptrPessoa);
+        }
+        return falharCarregamentoBin(bd, file);
+    }
+    (void)reservarDict(bd->carrosMat, bd->carrosCod->nelDict); // Uma matrícula por carro
     // Obter ptrPessoa e libertar Dono atual (e adicionar Carros ao bd->carrosMarca)
-    for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-        NoHashing *p = bd->carrosCod->tabela[i];
-
-        while(p) {
-            if (p->dados) {
-                No *x = p->dados->inicio;
-
-                while(x) {
-                    Carro *carro = (Carro *)x->info;
-                    void *chaveSearch = (void *)&carro->ptrPessoa->nif;
-                    Dono *ptrDono = (Dono *)searchDict(bd->donosNif, chaveSearch, compChaveDonoNif, compDonosNif, hashChaveDonoNif);
-                    free(carro->ptrPessoa);
-                    carro->ptrPessoa = ptrDono;
-                    if (carro->ptrPessoa) {
-                        if (!carro->ptrPessoa->carros) {
-                            carro->ptrPessoa->carros = criarLista();
-                        }
-                        (void) addInicioLista(carro->ptrPessoa->carros, (void *)carro);
-                    }
-
-                    // Adicionar ao bd->carrosMarca
-                    (void)appendToDict(bd->carrosMarca, x->info, compChaveCarroMarca, criarChaveCarroMarca, hashChaveCarroMarca, NULL, freeChaveCarroMarca);
-                    // Adicionar ao bd->carrosMat
-                    (void)appendToDict(bd->carrosMat, x->info, compChaveCarroMatricula, criarChaveCarroMatricula, hashChaveCarroMatricula, NULL, freeChaveCarroMatricula);
-                    
-                    x = x->prox;
-                }
+    for (int i = 0; i < bd->carrosCod->capacidade; i++) {
+        NoHashing *p = &bd->carrosCod->tabela[i];
+        if (!p->obj) continue;
+
+        Carro *carro = (Carro *)p->obj;
+        void *chaveSearch = (void *)&carro->ptrPessoa->nif;
+        Dono *ptrDono = (Dono *)searchDict(bd->donosNif, chaveSearch, compChaveDonoNif, compDonosNif, hashChaveDonoNif);
+        free(carro->ptrPessoa);
+        carro->ptrPessoa = ptrDono;
+        if (carro->ptrPessoa) {
+            if (!carro->ptrPessoa->carros) {
+                carro->ptrPessoa->carros = criarLista();
             }
-            p = p->prox;
+            (void) addInicioLista(carro->ptrPessoa->carros, (void *)carro);
         }
+
+        // Adicionar ao bd->carrosMarca
+        (void)appendToDict(bd->carrosMarca, carro, compChaveCarroMarca, criarChaveCarroMarca, hashChaveCarroMarca, NULL, NULL);
+        // Adicionar ao bd->carrosMat
+        (void)appendToDict(bd->carrosMat, carro, compChaveCarroMatricula, criarChaveCarroMatricula, hashChaveCarroMatricula, NULL, NULL);
     }
+    perfil->fases[FASE_INSERCAO] = tempoAtual() - t;
+    terminarEtapaBin(perfil, bd->carrosCod->nelDict, file, &posicao, &inicio);
 
     // Sensores
+    perfil = novaEtapaPerfil(&perfilCarregamento, "Sensores");
     bd->sensores = readListaBin(readSensorBin, file);
+    perfil->fases[FASE_LEITURA] = tempoAtual() - inicio;
+    if (!bd->sensores) return falharCarregamentoBin(bd, file);
+    terminarEtapaBin(perfil, bd->sensores->nel, file, &posicao, &inicio);
 
     // Passagens/Viagens
+    perfil = novaEtapaPerfil(&perfilCarregamento, "Viagens");
     bd->viagens = readListaBin(readViagemBin, file);
+    t = tempoAtual();
+    perfil->fases[FASE_LEITURA] = t - inicio;
+    if (!bd->viagens) return falharCarregamentoBin(bd, file);
     // Libertar Carro atual e obter o seu ponteiro
     No *p = bd->viagens->inicio;
 
@@ -882,10 +1917,30 @@ int carregarDadosBin(Bdados *bd, const char *nome) {
         }
         p = p->prox;
     }
+    perfil->fases[FASE_INSERCAO] = tempoAtual() - t;
+    terminarEtapaBin(perfil, bd->viagens->nel, file, &posicao, &inicio);
     // Distâncias
+    perfil = novaEtapaPerfil(&perfilCarregamento, "Distâncias");
     bd->distancias = readDistanciasBin(file);
+    if (!bd->distancias) return falharCarregamentoBin(bd, file);
+    arenaLeituraBin = NULL;
+    perfil->fases[FASE_LEITURA] = tempoAtual() - inicio;
+    // Uma entrada da matriz por registo
+    terminarEtapaBin(perfil, (long)bd->distancias->nColunas * bd->distancias->nColunas, file, &posicao, &inicio);
+
+    // Acompanhamento do ficheiro de passagens
+    int erroSeguimento = 0;
+    bd->seguimento = readSeguimentoPassagensBin(file, &erroSeguimento);
+    if (erroSeguimento) {
+        printf("Não foi possível ler até onde o ficheiro de passagens já foi lido: o acompanhamento começa no fim atual do ficheiro.\n");
+    }
 
+    perfil = novaEtapaPerfil(&perfilCarregamento, "Verificação");
     unsigned long sumAfter = checksum(bd);
+    perfil->fases[FASE_CHECKSUM] = tempoAtual() - inicio;
+    terminarEtapaBin(perfil, 0, file, &posicao, &inicio);
+    terminarPerfil(&perfilCarregamento);
+    guardarPerfilLogs(LOGS_TXT);
     
     if (sum != sumAfter) {
         printf("O ficheiro está corrompido ou foi adulterado. Os dados podem estar incompletos.\n");
@@ -970,58 +2025,46 @@ unsigned long checksum(Bdados *bd) {
     sum += backupsON;
     sum += pausaListagem;
     // Donos
-    for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-        NoHashing *p = bd->donosNif->tabela[i];
-        while(p) {
-            if (p->dados) {
-                No *x = p->dados->inicio;
-                while(x) {
-                    Dono *d = (Dono *)x->info;
-                    // NIF
-                    sum += d->nif;
-                    // Nome
-                    for (int j = 0; d->nome[j]; j++) {
-                        sum += d->nome[j];
-                    }
-                    // Cod postal 
-                    sum += d->codigoPostal.zona;
-                    sum += d->codigoPostal.local;
-                    x = x->prox;
-                }
-            }
-            p = p->prox;
+    for (int i = 0; i < bd->donosNif->capacidade; i++) {
+        NoHashing *p = &bd->donosNif->tabela[i];
+        if (!p->obj) continue;
+
+        Dono *d = (Dono *)p->obj;
+        // NIF
+        sum += d->nif;
+        // Nome
+        for (int j = 0; d->nome[j]; j++) {
+            sum += d->nome[j];
         }
+        // Cod postal 
+        sum += d->codigoPostal.zona;
+        sum += d->codigoPostal.local;
     }
     sum += bd->donosNif->nelDict;
 
     // Carros
-    for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-        NoHashing *p = bd->carrosCod->tabela[i];
-        while(p) {
-            if (p->dados) {
-                No *x = p->dados->inicio;
-                while(x) {
-                    Carro *c = (Carro *)x->info;
-                    // Cod
-                    sum += c->codVeiculo;
-                    // Matricula
-                    for (int j = 0; c->matricula[j]; j++) {
-                        sum += c->matricula[j];
-                    }
-                    // Marca e modelo
-                    for (int j = 0; c->marca[j]; j++) {
-                        sum += c->marca[j];
-                    }
-                    for (int j = 0; c->modelo[j]; j++) {
-                        sum += c->modelo[j];
-                    }
-                    // Ano
-                    sum += c->ano;
-                    x = x->prox;
-                }
-            }
-            p = p->prox;
+    for (int i = 0; i < bd->carrosCod->capacidade; i++) {
+        NoHashing *p = &bd->carrosCod->tabela[i];
+        if (!p->obj) continue;
+
+        Carro *c = (Carro *)p->obj;
+        // Cod
+        sum += c->codVeiculo;
+        // Matricula
+        for (int j = 0; c->matricula[j]; j++) {
+            sum += c->matricula[j];
+        }
+        // Marca e modelo
+        const char *marca = marcaCarro(c);
+        for (int j = 0; marca[j]; j++) {
+            sum += marca[j];
+        }
+        const char *modelo = modeloCarro(c);
+        for (int j = 0; modelo[j]; j++) {
+            sum += modelo[j];
         }
+        // Ano
+        sum += c->ano;
     }
     sum += bd->carrosCod->nelDict;
 
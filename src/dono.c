@@ -22,25 +22,27 @@ int inserirDonoLido(Bdados *bd, char *nome, int nif, CodPostal codigoPostal) {
     //nif
     dono->nif = nif;
     //Nome
-    dono->nome = (char *)malloc(strlen(nome) * sizeof(char) + 1);
-    if (!dono->nome) {
+    size_t tamanhoNome = strlen(nome) + 1;
+    dono->nome = guardarStringArena(bd->strings, nome);
+    dono->nomeNorm = reservarArena(bd->strings, tamanhoNome);
+    if (!dono->nome || !dono->nomeNorm) {
         free(dono);
         return 0;
     }
-    strcpy(dono->nome, nome);
+    normalizarString(nome, dono->nomeNorm, tamanhoNome);
     //Codigo Postal
     dono->codigoPostal.local = codigoPostal.local;
     dono->codigoPostal.zona = codigoPostal.zona;
     //Lista dos carros dos donos
     dono->carros = NULL;
     
-    if (!appendToDict(bd->donosNif, (void *)dono, compChaveDonoNif, criarChaveDonoNif, hashChaveDonoNif, freeDono, freeChaveDonoNif)) {
-        free(dono->nome);
+    if (!appendToDict(bd->donosNif, (void *)dono, compChaveDonoNif, criarChaveDonoNif, hashChaveDonoNif, NULL, NULL)) {
         free(dono);
         return 0;
     }
-    if (!appendToDict(bd->donosAlfabeticamente, (void *)dono, compChaveDonoAlfabeticamente, criarChaveDonoAlfabeticamente, hashChaveDonoAlfabeticamente, freeDono, freeChaveDonoAlfabeticamente)) {
-        free(dono->nome);
+    if (!appendToDict(bd->donosAlfabeticamente, (void *)dono, compChaveDonoAlfabeticamente, criarChaveDonoAlfabeticamente, hashChaveDonoAlfabeticamente, NULL, freeChaveDonoAlfabeticamente)) {
+        // O dono já está no donosNif: não pode lá ficar um ponteiro para memória libertada
+        (void)removeFromDict(bd->donosNif, (void *)dono, compChaveDonoNif, criarChaveDonoNif, hashChaveDonoNif, NULL);
         free(dono);
         return 0;
     }
@@ -48,6 +50,18 @@ int inserirDonoLido(Bdados *bd, char *nome, int nif, CodPostal codigoPostal) {
     return 1;
 }
 
+/**
+ * @brief Chave de ordenação dos donos pelo NIF
+ * 
+ * @param dono Dono
+ * @return uint32_t NIF (nunca negativo, ver validarNif)
+ */
+uint32_t chaveOrdenacaoDonoNif(void *dono) {
+    if (!dono) return 0;
+
+    return (uint32_t)((Dono *)dono)->nif;
+}
+
 /**
  * @brief Comparara donos pelo NIF
  * 
@@ -82,15 +96,8 @@ int compDonosNome(void *dono1, void *dono2) {
 
     Dono *x = (Dono *)dono1;
     Dono *y = (Dono *)dono2;
-    char *xNorm = normString(x->nome);
-    char *yNorm = normString(y->nome);
 
-    int res = strcmp(xNorm, yNorm);
-
-    free(xNorm);
-    free(yNorm);
-    
-    return res;
+    return strcmp(x->nomeNorm, y->nomeNorm);
 }
 
 /**
@@ -128,7 +135,7 @@ int compararCodPostal(const CodPostal cod1, const CodPostal cod2) {
  */
 void freeDono(void *dono) {
     Dono *obj = (Dono *)dono;
-    if (obj->nome) free(obj->nome);
+    // nome e nomeNorm pertencem à arena da base de dados
     if (obj->carros) {
         freeLista(obj->carros, NULL);
     }
@@ -187,8 +194,14 @@ void *readDonoBin(FILE *file) {
     size_t tamanho;
     fread(&tamanho, sizeof(size_t), 1, file);
 
-    x->nome = (char *)malloc(tamanho);
+    x->nome = reservarArena(arenaLeituraBin, tamanho);
+    x->nomeNorm = reservarArena(arenaLeituraBin, tamanho);
+    if (!x->nome || !x->nomeNorm) {
+        free(x);
+        return NULL;
+    }
     fread(x->nome, tamanho, 1, file);
+    normalizarString(x->nome, x->nomeNorm, tamanho);
 
     x->carros = NULL;
 
@@ -196,32 +209,18 @@ void *readDonoBin(FILE *file) {
 }
 
 /**
- * @brief Cria uma chave para Donos por Nif
+ * @brief Obtém a chave de um Dono por Nif
  * 
  * @param dono Dono
  * @return void* Chave ou NULL se erro
+ * 
+ * @note Chave inline (sizeof(int)): devolve o endereço do nif no próprio dono, não aloca memória
  */
 void *criarChaveDonoNif(void *dono) {
     if (!dono) return NULL;
 
     Dono *x = (Dono *)dono;
-    int *chaveNif = (int *)malloc(sizeof(int));
-    if (!chaveNif) return NULL;
-
-    *chaveNif = x->nif;
-    return (void *)chaveNif;
-}
-
-/**
- * @brief Liberta a memória ocupada pela chave dos donos por Nif
- * 
- * @param chave Chave
- */
-void freeChaveDonoNif(void *chave) {
-    if (!chave) return;
-
-    int *key = (int *)chave;
-    free(key);
+    return (void *)&x->nif;
 }
 
 /**
@@ -481,27 +480,11 @@ void printDonoVelocidadesTXT(Dono *dono, float velocidadeMedia, FILE *file) {
 size_t memUsageDono(void *dono) {
     if (!dono) return 0;
 
-    Dono *d = (Dono *)dono;
-
-    size_t mem = sizeof(Dono);
-    mem += strlen(d->nome) + 1;
+    size_t mem = sizeof(Dono); // As strings são contabilizadas na arena
 
     return mem;
 }
 
-/**
- * @brief Memória utilizada pela chave dos donos por código
- * 
- * @param chave Chave
- * @return size_t Memória utilizada ou 0 se erro
- */
-size_t memUsageChaveDonoCod(void *chave) {
-    if (!chave) return 0;
-
-    int *key = (int *)chave;
-    return sizeof(*key);
-}
-
 /**
  * @brief Memória utilizada pela chave dos donos alfabeticamente
  * 
@@ -613,47 +596,38 @@ Dono *obterCondutorMaisVelocidadeMedia(Bdados *bd) {
     float distanciaTotal = 0.0f;
     float velocidadeMedia = 0.0f;
 
-    for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-        NoHashing *p = bd->donosNif->tabela[i];
+    for (int i = 0; i < bd->donosNif->capacidade; i++) {
+        NoHashing *p = &bd->donosNif->tabela[i];
+        if (!p->obj) continue;
 
         tempoTotal = 0.0f;
         distanciaTotal = 0.0f;
         velocidadeMedia = 0.0f;
-        while(p) {
-            if (p->dados) {
-                No *m = p->dados->inicio;
-                while(m) {
-                    Dono *d = (Dono *)m->info;
-
-                    if (d->carros) {
-                        No *x = d->carros->inicio;
-                        while(x) {
-                            Carro *c = (Carro *)x->info;
-                            if (c->viagens) {
-                                No *l = c->viagens->inicio;
-                                while(l) {
-                                    Viagem *v = (Viagem *)l->info;
-                                    
-                                    tempoTotal += v->tempo;
-                                    distanciaTotal += v->kms;
-                                    l = l->prox; //viagem
-                                }
-                            }
-                            x = x->prox; //carro
-                        }
-                    }
-                    if (tempoTotal > 0) {
-                        velocidadeMedia = distanciaTotal / (tempoTotal / 60.0f);
-                        if (velocidadeMedia > velocidadeMax) {
-                            p = bd->donosNif->tabela[i];
-                            velocidadeMax = velocidadeMedia;
-                            donoMaisRapido = d;
-                        }
+        Dono *d = (Dono *)p->obj;
+
+        if (d->carros) {
+            No *x = d->carros->inicio;
+            while(x) {
+                Carro *c = (Carro *)x->info;
+                if (c->viagens) {
+                    No *l = c->viagens->inicio;
+                    while(l) {
+                        Viagem *v = (Viagem *)l->info;
+                        
+                        tempoTotal += v->tempo;
+                        distanciaTotal += v->kms;
+                        l = l->prox; //viagem
                     }
-                    m = m->prox; //dono
                 }
+                x = x->prox; //carro
+            }
+        }
+        if (tempoTotal > 0) {
+            velocidadeMedia = distanciaTotal / (tempoTotal / 60.0f);
+            if (velocidadeMedia > velocidadeMax) {
+                velocidadeMax = velocidadeMedia;
+                donoMaisRapido = d;
             }
-            p = p->prox;
         }
     }
 
@@ -672,24 +646,30 @@ void listarDonosNIF(Bdados *bd) {
     FILE *file = NULL;
     char formato[TAMANHO_FORMATO_LISTAGEM];
     
-    Lista *donosNifOrd = dictToLista(bd->donosNif);
-    mergeSortLista(donosNifOrd, compDonosNif);
-    printLista(donosNifOrd, printDono, stdout, pausaListagem);
+    int nel = 0;
+    void **donosNifOrd = dictToArray(bd->donosNif, &nel);
+    if (!donosNifOrd) {
+        printf("Ocorreu um erro inesperado! Por favor tente novamente mais tarde!\n");
+        pressEnter();
+        return;
+    }
+    (void)ordenarArrayPorChave(donosNifOrd, nel, chaveOrdenacaoDonoNif);
+    printArray(donosNifOrd, nel, printDono, stdout, pausaListagem);
     printf("\n----FIM DE LISTAGEM----\n");
     
     file = pedirListagemFicheiro(formato);
     if (file) {
         if (strcmp(formato, ".txt") == 0) {
             printHeaderDonosTXT(file);
-            printLista(donosNifOrd, printDonoTXT, file, 0);
+            printArray(donosNifOrd, nel, printDonoTXT, file, 0);
         }
         else if (strcmp(formato, ".csv") == 0) {
             printHeaderDonosCSV(file);
-            printLista(donosNifOrd, printDonoCSV, file, 0);
+            printArray(donosNifOrd, nel, printDonoCSV, file, 0);
         }
         fclose(file);
     }
-    freeLista(donosNifOrd, NULL);
+    free(donosNifOrd);
     pressEnter();
 }
 
@@ -740,72 +720,60 @@ void listarDonosVelocidadesMedias(Bdados *bd) {
 
     int count = 0;
 
-    for (int i = 0; i < TAMANHO_TABELA_HASH && listagemFlag == 0; i++) {
-        NoHashing *p = bd->donosNif->tabela[i];
-
-        while(p) {
-            if (p->dados) {
-                No *m = p->dados->inicio;
-                while(m && listagemFlag == 0) {
-                    Dono *d = (Dono *)m->info;
-                    
-                    tempo = 0;
-                    distancia = 0;
-                    velocidadeMedia = 0;
-
-                    // Procura todas as viagens de cada carro
-                    if (d->carros) {
-                        No *x = d->carros->inicio;
-                        while(x) {
-                            Carro *c = (Carro *)x->info;
-                            if (c->viagens) {
-                                No *l = c->viagens->inicio;
-                                while(l) {
-                                    Viagem *v = (Viagem *)l->info;
-                                    
-                                    tempo += v->tempo;
-                                    distancia += v->kms;
-                                    l = l->prox; //viagem
-                                }
-                            }
-                            x = x->prox; //carro
-                        }
+    for (int i = 0; i < bd->donosNif->capacidade && listagemFlag == 0; i++) {
+        NoHashing *p = &bd->donosNif->tabela[i];
+        if (!p->obj) continue;
+
+        Dono *d = (Dono *)p->obj;
+        
+        tempo = 0;
+        distancia = 0;
+        velocidadeMedia = 0;
+
+        // Procura todas as viagens de cada carro
+        if (d->carros) {
+            No *x = d->carros->inicio;
+            while(x) {
+                Carro *c = (Carro *)x->info;
+                if (c->viagens) {
+                    No *l = c->viagens->inicio;
+                    while(l) {
+                        Viagem *v = (Viagem *)l->info;
+                        
+                        tempo += v->tempo;
+                        distancia += v->kms;
+                        l = l->prox; //viagem
                     }
-                    if (tempo > 0) {
-                        velocidadeMedia = distancia / (tempo / 60.0f);
-                        Dono *dono = (Dono *)p->dados->inicio->info;
-                        printf("Nome: %s\n", dono->nome);
-                        printf("Velocidade Média: %.2f\n\n", velocidadeMedia);
-                        count++;
-                        if (count % pausaListagem == 0) {
-                            printf("\n");
-                            int opcao = enter_espaco_esc();
-                            switch (opcao) {
-                                case 0:
-                                    break;
-                                case 1:
-                                    while(count < bd->donosNif->nelDict - pausaListagem || !p) { //!p importante
-                                        if (!p) {
-                                            p = bd->donosNif->tabela[++i];
-                                        } 
-                                        else {
-                                            p = p->prox;
-                                            count++; // apenas se incrementa se houver p
-                                        }
-                                    }
-                                    break;
-                                case 2:
-                                    listagemFlag = 1;
-                                    break;
-                                default:
-                                    break;
+                }
+                x = x->prox; //carro
+            }
+        }
+        if (tempo > 0) {
+            velocidadeMedia = distancia / (tempo / 60.0f);
+            printf("Nome: %s\n", d->nome);
+            printf("Velocidade Média: %.2f\n\n", velocidadeMedia);
+            count++;
+            if (count % pausaListagem == 0) {
+                printf("\n");
+                int opcao = enter_espaco_esc();
+                switch (opcao) {
+                    case 0:
+                        break;
+                    case 1:
+                        // Avançar posições até restarem menos de pausaListagem donos
+                        while(count < bd->donosNif->nelDict - pausaListagem && i < bd->donosNif->capacidade - 1) {
+                            if (bd->donosNif->tabela[++i].obj) {
+                                count++;
                             }
                         }
-                    }
-                    m = m->prox; //dono
+                        break;
+                    case 2:
+                        listagemFlag = 1;
+                        break;
+                    default:
+                        break;
                 }
             }
-            p = p->prox;
         }
     }
     
@@ -819,93 +787,75 @@ void listarDonosVelocidadesMedias(Bdados *bd) {
     if (file) {
         if (strcmp(formato, ".txt") == 0) {
             fprintf(file, "Nif\tNome\tVelocidade media\n");
-            for (int i = 0; i < TAMANHO_TABELA_HASH && listagemFlag == 0; i++) {
-                NoHashing *p = bd->donosNif->tabela[i];
-
-                while(p) {
-                    if (p->dados) {
-                        No *m = p->dados->inicio;
-                        while(m && listagemFlag == 0) {
-                            Dono *d = (Dono *)m->info;
-                            
-                            tempo = 0;
-                            distancia = 0;
-                            velocidadeMedia = 0;
-
-                            // Procura todas as viagens de cada carro
-                            if (d->carros) {
-                                No *x = d->carros->inicio;
-                                while(x) {
-                                    Carro *c = (Carro *)x->info;
-                                    if (c->viagens) {
-                                        No *l = c->viagens->inicio;
-                                        while(l) {
-                                            Viagem *v = (Viagem *)l->info;
-                                            
-                                            tempo += v->tempo;
-                                            distancia += v->kms;
-                                            l = l->prox; //viagem
-                                        }
-                                    }
-                                    x = x->prox; //carro
-                                }
+            for (int i = 0; i < bd->donosNif->capacidade && listagemFlag == 0; i++) {
+                NoHashing *p = &bd->donosNif->tabela[i];
+                if (!p->obj) continue;
+
+                Dono *d = (Dono *)p->obj;
+                
+                tempo = 0;
+                distancia = 0;
+                velocidadeMedia = 0;
+
+                // Procura todas as viagens de cada carro
+                if (d->carros) {
+                    No *x = d->carros->inicio;
+                    while(x) {
+                        Carro *c = (Carro *)x->info;
+                        if (c->viagens) {
+                            No *l = c->viagens->inicio;
+                            while(l) {
+                                Viagem *v = (Viagem *)l->info;
+                                
+                                tempo += v->tempo;
+                                distancia += v->kms;
+                                l = l->prox; //viagem
                             }
-                            if (tempo > 0) {
-                                velocidadeMedia = distancia / (tempo / 60.0f);
-                                Dono *dono = (Dono *)p->dados->inicio->info;
-                                printDonoVelocidadesTXT(dono, velocidadeMedia, file);
-                                count++;
-                            }
-                            m = m->prox; //dono
                         }
+                        x = x->prox; //carro
                     }
-                    p = p->prox;
+                }
+                if (tempo > 0) {
+                    velocidadeMedia = distancia / (tempo / 60.0f);
+                    printDonoVelocidadesTXT(d, velocidadeMedia, file);
+                    count++;
                 }
             }
         }
         else if (strcmp(formato, ".csv") == 0) {
             fprintf(file, "Nif, Nome, Velocidade media\n");
-            for (int i = 0; i < TAMANHO_TABELA_HASH && listagemFlag == 0; i++) {
-                NoHashing *p = bd->donosNif->tabela[i];
-
-                while(p) {
-                    if (p->dados) {
-                        No *m = p->dados->inicio;
-                        while(m && listagemFlag == 0) {
-                            Dono *d = (Dono *)m->info;
-                            
-                            tempo = 0;
-                            distancia = 0;
-                            velocidadeMedia = 0;
-
-                            // Procura todas as viagens de cada carro
-                            if (d->carros) {
-                                No *x = d->carros->inicio;
-                                while(x) {
-                                    Carro *c = (Carro *)x->info;
-                                    if (c->viagens) {
-                                        No *l = c->viagens->inicio;
-                                        while(l) {
-                                            Viagem *v = (Viagem *)l->info;
-                                            
-                                            tempo += v->tempo;
-                                            distancia += v->kms;
-                                            l = l->prox; //viagem
-                                        }
-                                    }
-                                    x = x->prox; //carro
-                                }
+            for (int i = 0; i < bd->donosNif->capacidade && listagemFlag == 0; i++) {
+                NoHashing *p = &bd->donosNif->tabela[i];
+                if (!p->obj) continue;
+
+                Dono *d = (Dono *)p->obj;
+                
+                tempo = 0;
+                distancia = 0;
+                velocidadeMedia = 0;
+
+                // Procura todas as viagens de cada carro
+                if (d->carros) {
+                    No *x = d->carros->inicio;
+                    while(x) {
+                        Carro *c = (Carro *)x->info;
+                        if (c->viagens) {
+                            No *l = c->viagens->inicio;
+                            while(l) {
+                                Viagem *v = (Viagem *)l->info;
+                                
+                                tempo += v->tempo;
+                                distancia += v->kms;
+                                l = l->prox; //viagem
                             }
-                            if (tempo > 0) {
-                                velocidadeMedia = distancia / (tempo / 60.0f);
-                                Dono *dono = (Dono *)p->dados->inicio->info;
-                                printDonoVelocidadesCSV(dono, velocidadeMedia, file);
-                                count++;
-                            }
-                            m = m->prox; //dono
                         }
+                        x = x->prox; //carro
                     }
-                    p = p->prox;
+                }
+                if (tempo > 0) {
+                    velocidadeMedia = distancia / (tempo / 60.0f);
+                    printDonoVelocidadesCSV(d, velocidadeMedia, file);
+                    count++;
                 }
             }
         }
@@ -954,20 +904,13 @@ void velocidadeMediaPorCodPostal(Bdados *bd) {
         return;
     }
 
-    for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-        NoHashing *p = bd->donosNif->tabela[i];
-        while(p) {
-            if (p->dados) {
-                No *l = p->dados->inicio;
-                while(l) {
-                    Dono *d = (Dono *)l->info;
-                    if (compararCodPostal(d->codigoPostal, chave) == 0) {
-                        (void) addInicioLista(donosCods, l->info);
-                    }
-                    l = l->prox;
-                }
-            }
-            p = p->prox;
+    for (int i = 0; i < bd->donosNif->capacidade; i++) {
+        NoHashing *p = &bd->donosNif->tabela[i];
+        if (!p->obj) continue;
+
+        Dono *d = (Dono *)p->obj;
+        if (compararCodPostal(d->codigoPostal, chave) == 0) {
+            (void) addInicioLista(donosCods, d);
         }
     }
 
@@ -0,0 +1,588 @@
+/* Leitura dos ficheiros .txt de dados sem cópias por linha: o ficheiro é mapeado em memória e as linhas/campos são fatias */
+
+#include "leituraTxt.h"
+
+/**
+ * @brief Abre um ficheiro de texto e mapeia-o em memória
+ *
+ * @param nome Nome do ficheiro
+ * @return FicheiroTxt* NULL se erro
+ *
+ * @note Em Windows não há mapeamento: o ficheiro é sempre lido por inteiro para um bloco alocado (tal como quando o mmap
+ *       falha), o que ocupa o tamanho do ficheiro em memória enquanto estiver aberto
+ * @note Um ficheiro vazio é válido (não tem linhas)
+ */
+FicheiroTxt *abrirFicheiroTxt(const char *nome) {
+    if (!nome) return NULL;
+
+    FicheiroTxt *f = (FicheiroTxt *)malloc(sizeof(FicheiroTxt));
+    if (!f) return NULL;
+    f->dados = NULL;
+    f->tamanho = 0;
+    f->pos = 0;
+    f->mapeado = 0;
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    int fd = open(nome, O_RDONLY);
+    if (fd < 0) {
+        free(f);
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+        if (info.st_size == 0) {
+            close(fd);
+            return f;
+        }
+        void *mapa = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapa != MAP_FAILED) {
+            (void)posix_madvise(mapa, (size_t)info.st_size, POSIX_MADV_SEQUENTIAL);
+            f->dados = (char *)mapa;
+            f->tamanho = (size_t)info.st_size;
+            f->mapeado = 1;
+            close(fd); // O mapeamento continua válido
+            return f;
+        }
+    }
+    close(fd);
+#endif
+
+    // Alternativa: ler tudo para memória
+    FILE *file = fopen(nome, "rb");
+    if (!file) {
+        free(f);
+        return NULL;
+    }
+    size_t capacidade = 0;
+    size_t lidos;
+    do {
+        if (f->tamanho == capacidade) {
+            capacidade = capacidade ? capacidade * 2 : 65536;
+            char *temp = (char *)realloc(f->dados, capacidade);
+            if (!temp) {
+                free(f->dados);
+                free(f);
+                fclose(file);
+                return NULL;
+            }
+            f->dados = temp;
+        }
+        lidos = fread(f->dados + f->tamanho, 1, capacidade - f->tamanho, file);
+        f->tamanho += lidos;
+    } while (lidos > 0);
+    fclose(file);
+    return f;
+}
+
+/**
+ * @brief Obtém a próxima linha de um pedaço de texto
+ *
+ * @param resto Texto por ler, avança para depois da linha
+ * @param linha Devolve a linha, sem '\n' nem '\r' final
+ * @return int 1 se leu uma linha, 0 se chegou ao fim
+ *
+ * @note Mesmas regras de lerLinhaTxt: linhas vazias contam, a última linha pode não ter '\n'
+ */
+int proximaLinhaFatia(Fatia *resto, Fatia *linha) {
+    if (!resto || !linha || resto->tamanho == 0) return 0;
+
+    const char *inicio = resto->inicio;
+    const char *fim = (const char *)memchr(inicio, '\n', resto->tamanho);
+    size_t tamanho = fim ? (size_t)(fim - inicio) : resto->tamanho;
+    size_t consumido = tamanho + (fim ? 1 : 0);
+
+    resto->inicio += consumido;
+    resto->tamanho -= consumido;
+    if (tamanho > 0 && inicio[tamanho - 1] == '\r') tamanho--;
+
+    linha->inicio = inicio;
+    linha->tamanho = tamanho;
+    return 1;
+}
+
+/**
+ * @brief Obtém a próxima linha do ficheiro
+ *
+ * @param f Ficheiro
+ * @param linha Devolve a linha, sem '\n' nem '\r' final
+ * @return int 1 se leu uma linha, 0 se chegou ao fim
+ */
+int proximaLinhaTxt(FicheiroTxt *f, Fatia *linha) {
+    if (!f || f->pos >= f->tamanho) return 0;
+
+    Fatia resto = {f->dados + f->pos, f->tamanho - f->pos};
+    if (!proximaLinhaFatia(&resto, linha)) return 0;
+    f->pos = f->tamanho - resto.tamanho;
+    return 1;
+}
+
+/**
+ * @brief Conta as linhas que faltam ler do ficheiro, sem avançar a posição
+ *
+ * @param f Ficheiro
+ * @return int Nº de linhas (uma última linha sem '\n' também conta), -1 se erro
+ *
+ * @note memchr salta de '\n' em '\n' com instruções vetoriais, por isso a contagem é muito mais rápida do que
+ * o carregamento e serve para pré-dimensionar as estruturas antes de inserir
+ */
+int contarLinhasTxt(const FicheiroTxt *f) {
+    if (!f) return -1;
+
+    const char *p = f->dados + f->pos;
+    const char *fim = f->dados + f->tamanho;
+    int linhas = 0;
+    while (p < fim) {
+        const char *nl = (const char *)memchr(p, '\n', (size_t)(fim - p));
+        linhas++;
+        if (!nl) break;
+        p = nl + 1;
+    }
+    return linhas;
+}
+
+/**
+ * @brief Posição a seguir ao último '\n' do ficheiro
+ *
+ * @param f Ficheiro
+ * @return size_t Tamanho da parte com linhas completas (0 se não houver nenhum '\n')
+ *
+ * @note Serve para deixar por ler uma última linha que ainda está a ser escrita
+ */
+size_t fimLinhasCompletasTxt(const FicheiroTxt *f) {
+    if (!f) return 0;
+
+    size_t fim = f->tamanho;
+    while (fim > f->pos && f->dados[fim - 1] != '\n') fim--;
+    return fim;
+}
+
+// Procura de separadores por blocos de LARGURA_SIMD bytes: cada bloco dá uma máscara com um bit por separador
+
+typedef struct {
+    const char *inicio;
+    size_t tamanho;
+    size_t base; // Início do bloco da máscara atual
+    size_t proximo; // Início do próximo bloco a carregar
+    uint32_t mascara; // Separadores do bloco atual ainda por devolver
+} ProcuraSeparadores;
+
+/**
+ * @brief Máscara dos separadores de um bloco
+ *
+ * @param p Início do bloco
+ * @param resto Bytes disponíveis a partir de p
+ * @return uint32_t Bit i a 1 se p[i] == SEPARADOR (apenas os primeiros min(resto, LARGURA_SIMD) bytes)
+ *
+ * @note Só faz leituras vetoriais com um bloco completo, para não passar do fim do ficheiro mapeado
+ */
+static inline uint32_t mascaraSeparadores(const char *p, size_t resto) {
+#if defined(__AVX2__)
+    if (resto >= LARGURA_SIMD) {
+        __m256i bloco = _mm256_loadu_si256((const __m256i *)p);
+        return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bloco, _mm256_set1_epi8(SEPARADOR)));
+    }
+#elif defined(__SSE2__)
+    if (resto >= LARGURA_SIMD) {
+        __m128i bloco = _mm_loadu_si128((const __m128i *)p);
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bloco, _mm_set1_epi8(SEPARADOR)));
+    }
+#endif
+    size_t n = (resto < LARGURA_SIMD) ? resto : LARGURA_SIMD;
+    uint32_t mascara = 0;
+    for (size_t i = 0; i < n; i++) {
+        mascara |= (uint32_t)(p[i] == SEPARADOR) << i;
+    }
+    return mascara;
+}
+
+/**
+ * @brief Posição do bit a 1 menos significativo
+ *
+ * @param x Valor diferente de 0
+ * @return int Posição
+ */
+static inline int primeiroBit(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(x);
+#else
+    int i = 0;
+    while (!(x & 1u)) {
+        x >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+
+/**
+ * @brief Obtém a posição do próximo separador
+ *
+ * @param s Estado da procura
+ * @return size_t Posição (relativa ao início da linha), ou s->tamanho se não houver mais
+ */
+static inline size_t proximoSeparador(ProcuraSeparadores *s) {
+    while (s->mascara == 0) {
+        if (s->proximo >= s->tamanho) return s->tamanho;
+        s->base = s->proximo;
+        s->mascara = mascaraSeparadores(s->inicio + s->base, s->tamanho - s->base);
+        s->proximo += LARGURA_SIMD;
+    }
+    size_t pos = s->base + (size_t)primeiroBit(s->mascara);
+    s->mascara &= s->mascara - 1;
+    return pos;
+}
+
+/**
+ * @brief Separa uma linha em campos por SEPARADOR, sem copiar
+ *
+ * @param linha Linha
+ * @param campos Devolve as fatias de cada campo, sem espaços no início e no fim
+ * @param maxCampos Nº máximo de campos a separar
+ * @return int Nº de campos encontrados (no máximo maxCampos)
+ *
+ * @note Mesmo comportamento de separarParametros: separadores seguidos contam como um só (strtok) e
+ *       o último campo termina no separador seguinte
+ * @note Os separadores são procurados LARGURA_SIMD bytes de cada vez (AVX2/SSE2 se disponíveis)
+ */
+int separarCampos(Fatia linha, Fatia *campos, int maxCampos) {
+    if (!campos) return 0;
+
+    ProcuraSeparadores procura = {linha.inicio, linha.tamanho, 0, 0, 0};
+    size_t inicioCampo = 0;
+    int n = 0;
+
+    while (n < maxCampos) {
+        size_t sep = proximoSeparador(&procura);
+        if (sep > inicioCampo) {
+            // Remover espaços (como removerEspacos)
+            const char *a = linha.inicio + inicioCampo;
+            const char *b = linha.inicio + sep;
+            while (a < b && *a == ' ') a++;
+            while (b > a && *(b - 1) == ' ') b--;
+
+            campos[n].inicio = a;
+            campos[n].tamanho = (size_t)(b - a);
+            n++;
+        }
+        if (sep >= linha.tamanho) break;
+        inicioCampo = sep + 1;
+    }
+    return n;
+}
+
+/**
+ * @brief Copia os campos para memória já reservada, como strings terminadas em '\0'
+ *
+ * @param campos Campos
+ * @param n Nº de campos
+ * @param strings Devolve as strings
+ * @param destino Posição onde escrever, avança para depois da última string
+ *
+ * @note Precisa de (soma dos tamanhos + n) bytes, que nunca passa do tamanho da linha + 1
+ */
+void copiarCampos(const Fatia *campos, int n, char **strings, char **destino) {
+    char *p = *destino;
+    for (int i = 0; i < n; i++) {
+        memcpy(p, campos[i].inicio, campos[i].tamanho);
+        p[campos[i].tamanho] = '\0';
+        strings[i] = p;
+        p += campos[i].tamanho + 1;
+    }
+    *destino = p;
+}
+
+/**
+ * @brief Copia os campos para um buffer reutilizável, como strings terminadas em '\0'
+ *
+ * @param campos Campos
+ * @param n Nº de campos
+ * @param strings Devolve as strings (apontam para buf, válidas até à próxima chamada)
+ * @param buf Buffer (só cresce; é alocado apenas quando aparece uma linha maior)
+ * @return int 1 se sucesso, 0 se erro
+ */
+int camposParaStrings(const Fatia *campos, int n, char **strings, BufferCampos *buf) {
+    if (!campos || !strings || !buf) return 0;
+
+    size_t necessario = 0;
+    for (int i = 0; i < n; i++) {
+        necessario += campos[i].tamanho + 1;
+    }
+    if (necessario > buf->capacidade) {
+        size_t capacidade = buf->capacidade ? buf->capacidade : TAMANHO_INICIAL_BUFFER;
+        while (capacidade < necessario) capacidade *= 2;
+        char *temp = (char *)realloc(buf->dados, capacidade);
+        if (!temp) return 0;
+        buf->dados = temp;
+        buf->capacidade = capacidade;
+    }
+
+    char *destino = buf->dados;
+    copiarCampos(campos, n, strings, &destino);
+    return 1;
+}
+
+/**
+ * @brief Liberta a memória do buffer de campos
+ *
+ * @param buf Buffer
+ */
+void freeBufferCampos(BufferCampos *buf) {
+    if (!buf) return;
+
+    free(buf->dados);
+    buf->dados = NULL;
+    buf->capacidade = 0;
+}
+
+/**
+ * @brief Fecha um ficheiro aberto com abrirFicheiroTxt
+ *
+ * @param f Ficheiro
+ *
+ * @note As fatias obtidas deixam de ser válidas
+ */
+void fecharFicheiroTxt(FicheiroTxt *f) {
+    if (!f) return;
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    if (f->mapeado) {
+        munmap(f->dados, f->tamanho);
+        free(f);
+        return;
+    }
+#endif
+    free(f->dados);
+    free(f);
+}
+
+// Carregamento em pipeline: leitura -> análise (várias threads) -> aplicação (thread atual), ligadas por anéis SPSC
+
+typedef struct {
+    Fatia bloco;
+    void *resultado;
+} BlocoPipeline;
+
+typedef struct {
+    FicheiroTxt *f;
+    AnelSPSC **entradas; // Uma por analisador; o bloco i vai para o analisador i % nAnalisadores
+    int nAnalisadores;
+    atomic_int *cancelar;
+    double tempo; // Tempo gasto a cortar e ler blocos
+} EtapaLeitura;
+
+typedef struct {
+    AnelSPSC *entrada;
+    AnelSPSC *saida;
+    void *(*analisar)(Fatia bloco, void *contexto);
+    void *contexto;
+    atomic_int *cancelar;
+    double tempo; // Tempo gasto em analisar
+} EtapaAnalise;
+
+/**
+ * @brief Separa o próximo bloco de linhas completas do ficheiro
+ *
+ * @param f Ficheiro, avança para depois do bloco
+ * @param tamanho Tamanho aproximado do bloco (é estendido até ao fim da linha)
+ * @return Fatia Bloco (vazio no fim do ficheiro)
+ */
+static Fatia proximoBlocoTxt(FicheiroTxt *f, size_t tamanho) {
+    Fatia bloco = {f->dados + f->pos, 0};
+    if (f->pos >= f->tamanho) return bloco;
+
+    size_t fim = f->pos + tamanho;
+    if (fim >= f->tamanho) {
+        fim = f->tamanho;
+    }
+    else {
+        const char *nl = (const char *)memchr(f->dados + fim - 1, '\n', f->tamanho - (fim - 1));
+        fim = nl ? (size_t)(nl - f->dados) + 1 : f->tamanho;
+    }
+    bloco.tamanho = fim - f->pos;
+    f->pos = fim;
+    return bloco;
+}
+
+/**
+ * @brief Traz as páginas de um bloco para memória, para os analisadores não esperarem pelo disco
+ *
+ * @param bloco Bloco
+ */
+static void lerBlocoTxt(Fatia bloco) {
+    const volatile char *p = bloco.inicio;
+    char lixo = 0;
+    for (size_t i = 0; i < bloco.tamanho; i += TAMANHO_PAGINA_TXT) {
+        lixo ^= p[i];
+    }
+    (void)lixo;
+}
+
+/**
+ * @brief Etapa de leitura: corta o ficheiro em blocos e distribui-os pelos analisadores (ponto de entrada da thread)
+ *
+ * @param arg EtapaLeitura
+ * @return void* NULL
+ *
+ * @note No fim (ou se for cancelada) envia NULL a todos os analisadores
+ */
+static void *executarLeituraTxt(void *arg) {
+    EtapaLeitura *e = (EtapaLeitura *)arg;
+    int i = 0;
+
+    while (!atomic_load(e->cancelar) && e->f->pos < e->f->tamanho) {
+        BlocoPipeline *b = (BlocoPipeline *)malloc(sizeof(BlocoPipeline));
+        if (!b) {
+            atomic_store(e->cancelar, 1);
+            break;
+        }
+        double inicio = tempoAtual();
+        b->bloco = proximoBlocoTxt(e->f, TAMANHO_BLOCO_TXT);
+        b->resultado = NULL;
+        lerBlocoTxt(b->bloco);
+        e->tempo += tempoAtual() - inicio;
+        colocarAnelSPSCEspera(e->entradas[i], b);
+        i = (i + 1) % e->nAnalisadores;
+    }
+    for (int j = 0; j < e->nAnalisadores; j++) {
+        colocarAnelSPSCEspera(e->entradas[j], NULL);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Etapa de análise: analisa os blocos que recebe e passa-os, pela mesma ordem, à aplicação (ponto de entrada da thread)
+ *
+ * @param arg EtapaAnalise
+ * @return void* NULL
+ */
+static void *executarAnaliseTxt(void *arg) {
+    EtapaAnalise *e = (EtapaAnalise *)arg;
+
+    while (1) {
+        BlocoPipeline *b = (BlocoPipeline *)retirarAnelSPSCEspera(e->entrada);
+        if (b && !atomic_load(e->cancelar)) {
+            double inicio = tempoAtual();
+            b->resultado = e->analisar(b->bloco, e->contexto);
+            e->tempo += tempoAtual() - inicio;
+        }
+        colocarAnelSPSCEspera(e->saida, b);
+        if (!b) break;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Carrega um ficheiro de texto em pipeline: os blocos são lidos, analisados em simultâneo e aplicados por ordem
+ *
+ * @param f Ficheiro (lido a partir da posição atual)
+ * @param analisar Valida/converte as linhas de um bloco, sem alterar estado partilhado (corre em várias threads);
+ *                 devolve o resultado do bloco, ou NULL se erro
+ * @param aplicar Insere o resultado de um bloco nas estruturas (corre na thread atual, pela ordem do ficheiro)
+ * @param freeResultado Liberta o resultado de um bloco
+ * @param contexto Argumento passado a analisar (apenas leitura) e a aplicar
+ * @param perfil Etapa onde somar o tempo de leitura, análise (somado entre analisadores) e inserção; pode ser NULL
+ * @return int 1 se sucesso, 0 se algum bloco não pôde ser analisado (os blocos anteriores ficam aplicados)
+ *
+ * @note Uma thread de leitura corta blocos de TAMANHO_BLOCO_TXT bytes em fins de linha e entrega-os, à vez, a
+ *       numThreads analisadores; a thread atual é a única que aplica (as estruturas só têm um escritor).
+ *       Cada par de etapas está ligado por um AnelSPSC de CAPACIDADE_ANEL_PIPELINE blocos, o que limita a memória usada.
+ *       Como aplicar vê as linhas pela ordem original, estado que atravessa linhas (nº da linha, pares de passagens)
+ *       continua correto mesmo quando fica dividido entre blocos
+ * @note Com 1 thread (ou se não for possível criar as threads) os blocos são analisados e aplicados um a um
+ */
+int carregarFicheiroTxtParalelo(FicheiroTxt *f, void *(*analisar)(Fatia bloco, void *contexto), int (*aplicar)(void *resultado, void *contexto),
+        void (*freeResultado)(void *resultado), void *contexto, EtapaPerfil *perfil) {
+    if (!f || !analisar || !aplicar || !freeResultado) return 0;
+
+    // A leitura e a aplicação não contam: com 2 threads há de facto 2 analisadores
+    int nAnalisadores = (numThreads > 1) ? numThreads : 0;
+    if (nAnalisadores > MAX_THREADS) nAnalisadores = MAX_THREADS;
+
+    atomic_int cancelar;
+    atomic_init(&cancelar, 0);
+    AnelSPSC *entradas[MAX_THREADS];
+    EtapaAnalise etapas[MAX_THREADS];
+    pthread_t analisadores[MAX_THREADS];
+    pthread_t leitor;
+    int n = 0; // Analisadores criados
+
+    for (; n < nAnalisadores; n++) {
+        entradas[n] = criarAnelSPSC(CAPACIDADE_ANEL_PIPELINE);
+        AnelSPSC *saida = criarAnelSPSC(CAPACIDADE_ANEL_PIPELINE);
+        if (!entradas[n] || !saida) {
+            freeAnelSPSC(entradas[n]);
+            freeAnelSPSC(saida);
+            break;
+        }
+        etapas[n] = (EtapaAnalise){entradas[n], saida, analisar, contexto, &cancelar, 0};
+        if (pthread_create(&analisadores[n], NULL, executarAnaliseTxt, &etapas[n]) != 0) {
+            freeAnelSPSC(entradas[n]);
+            freeAnelSPSC(saida);
+            break;
+        }
+    }
+
+    EtapaLeitura leitura = {f, entradas, n, &cancelar, 0};
+    int comPipeline = n > 0 && pthread_create(&leitor, NULL, executarLeituraTxt, &leitura) == 0;
+    if (n > 0 && !comPipeline) {
+        // Sem leitor: terminar os analisadores e fazer tudo aqui
+        for (int i = 0; i < n; i++) {
+            colocarAnelSPSCEspera(entradas[i], NULL);
+            (void)retirarAnelSPSCEspera(etapas[i].saida);
+            pthread_join(analisadores[i], NULL);
+            freeAnelSPSC(entradas[i]);
+            freeAnelSPSC(etapas[i].saida);
+        }
+    }
+
+    int sucesso = 1;
+    double tempos[NUM_FASES] = {0}; // Leitura, análise e inserção
+    if (!comPipeline) {
+        while (sucesso && f->pos < f->tamanho) {
+            double t0 = tempoAtual();
+            Fatia bloco = proximoBlocoTxt(f, TAMANHO_BLOCO_TXT);
+            double t1 = tempoAtual();
+            void *resultado = analisar(bloco, contexto);
+            double t2 = tempoAtual();
+            if (!resultado || !aplicar(resultado, contexto)) {
+                sucesso = 0;
+            }
+            if (resultado) {
+                freeResultado(resultado);
+            }
+            tempos[FASE_LEITURA] += t1 - t0;
+            tempos[FASE_ANALISE] += t2 - t1;
+            tempos[FASE_INSERCAO] += tempoAtual() - t2;
+        }
+        adicionarTemposPerfil(perfil, tempos);
+        return sucesso;
+    }
+
+    // Aplicação: os resultados são recolhidos à vez, pela mesma ordem em que os blocos foram distribuídos
+    for (int i = 0; ; i = (i + 1) % n) {
+        BlocoPipeline *b = (BlocoPipeline *)retirarAnelSPSCEspera(etapas[i].saida);
+        if (!b) break; // Fim (todos os analisadores recebem NULL depois do último bloco)
+
+        double inicio = tempoAtual();
+        if (sucesso && (!b->resultado || !aplicar(b->resultado, contexto))) {
+            sucesso = 0;
+            atomic_store(&cancelar, 1);
+        }
+        if (b->resultado) {
+            freeResultado(b->resultado);
+        }
+        free(b);
+        tempos[FASE_INSERCAO] += tempoAtual() - inicio;
+    }
+
+    pthread_join(leitor, NULL);
+    tempos[FASE_LEITURA] = leitura.tempo;
+    for (int i = 0; i < n; i++) {
+        pthread_join(analisadores[i], NULL);
+        tempos[FASE_ANALISE] += etapas[i].tempo;
+        freeAnelSPSC(entradas[i]);
+        freeAnelSPSC(etapas[i].saida);
+    }
+    adicionarTemposPerfil(perfil, tempos);
+    return sucesso && !atomic_load(&cancelar);
+}
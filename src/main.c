@@ -21,12 +21,12 @@ Todas as versões do programa estão disponíveis no seguinte repositório do gi
 https://github.com/huger6/ProjetoED
 
 Para compilar em Windows, usar:
-	gcc -Wall -Wextra -g -O0 -std=c23 -o **FILENAME** main.c uteis.c validacoes.c sensores.c passagens.c menus.c structsGenericas.c dono.c distancias.c dados.c carro.c bdados.c configs.c
+	gcc -Wall -Wextra -g -O0 -std=c23 -o **FILENAME** main.c uteis.c validacoes.c sensores.c passagens.c menus.c structsGenericas.c dono.c distancias.c dados.c carro.c bdados.c configs.c leituraTxt.c registoLogs.c perfilCarregamento.c -pthread
 
 	Testado com o compilador GGC em C23, no Windows 11 Home 23H2 (64bits)
 
 Para compilar em Linux, usar:
-	gcc -std=c2x -Wall -Wextra -o **FILENAME** main.c uteis.c validacoes.c sensores.c passagens.c menus.c structsGenericas.c dono.c distancias.c dados.c carro.c bdados.c configs.c -D_XOPEN_SOURCE=700
+	gcc -std=c2x -Wall -Wextra -o **FILENAME** main.c uteis.c validacoes.c sensores.c passagens.c menus.c structsGenericas.c dono.c distancias.c dados.c carro.c bdados.c configs.c leituraTxt.c registoLogs.c perfilCarregamento.c -D_XOPEN_SOURCE=700 -pthread
 
 	Testado em Linux Ubuntu 20.04.6 LTS com gcc13 (C23) na versão 13.1.0
 */
@@ -6,6 +6,7 @@
 #include "dono.h"
 #include "passagens.h"
 #include "dados.h"
+#include "perfilCarregamento.h"
 
 /* Mostra menu e processa entrada do utilizador
  *
@@ -118,7 +119,7 @@ void menuListagemVeiculos() {
 /**
  * @brief Mostra o menu das passagens
  * 
- * @note Opções: 0-2
+ * @note Opções: 0-3
  */
 void menuPassagens() {
     printf("╔═════════════════════════════════╗\n");
@@ -126,6 +127,7 @@ void menuPassagens() {
     printf("╠═════════════════════════════════╣\n");
     printf("║  1. Registar viagem             ║\n");
     printf("║  2. Ver todas as viagens        ║\n");
+    printf("║  3. Acompanhar novas passagens  ║\n");
     printf("║  0. Voltar ao menu anterior     ║\n");
     printf("╚═════════════════════════════════╝\n\n");
 }
@@ -185,7 +187,7 @@ void menuInfracoes() {
  * 
  * @return void
  * 
- * @note Opções: 0-2
+ * @note Opções: 0-3
  */
 void menuAnaliseDados() {
     printf("╔══════════════════════════════════╗\n");
@@ -193,6 +195,7 @@ void menuAnaliseDados() {
     printf("╠══════════════════════════════════╣\n");
     printf("║  1. Memória ocupada              ║\n");
     printf("║  2. Marca automóvel mais comum   ║\n");
+    printf("║  3. Perfil do carregamento       ║\n");
     printf("║  0. Voltar ao menu anterior      ║\n");
     printf("╚══════════════════════════════════╝\n\n");
 }
@@ -216,7 +219,7 @@ void menuExportacao() {
 /**
  * @brief Escreve o menu das opções
  * 
- * @note Opções: 0-7
+ * @note Opções: 0-9
  */
 void menuOpcoes() {
     printf("╔════════════════════════════════════════╗\n");
@@ -229,6 +232,23 @@ void menuOpcoes() {
     printf("║  5. Carregar dados                     ║\n");
     printf("║  6. Repor definições                   ║\n");
     printf("║  7. Guia de utilização                 ║\n");
+    printf("║  8. Definir nº de threads              ║\n");
+    printf("║  9. Definições do carregamento         ║\n");
+    printf("║  0. Voltar ao menu anterior            ║\n");
+    printf("╚════════════════════════════════════════╝\n\n");
+}
+
+/**
+ * @brief Mostra o menu das definições do carregamento dos ficheiros .txt
+ * 
+ * @note Opções: 0-2
+ */
+void menuCarregamento() {
+    printf("╔════════════════════════════════════════╗\n");
+    printf("║       DEFINIÇÕES DO CARREGAMENTO       ║\n");
+    printf("╠════════════════════════════════════════╣\n");
+    printf("║  1. Limitar linhas inválidas nos logs  ║\n");
+    printf("║  2. Tempo máximo de uma viagem         ║\n");
     printf("║  0. Voltar ao menu anterior            ║\n");
     printf("╚════════════════════════════════════════╝\n\n");
 }
@@ -486,7 +506,7 @@ void processarMenuListagemVeiculos(Bdados *bd) {
 void processarMenuPassagens(Bdados *bd) {
     char opcao;
     do {
-        opcao = mostrarMenu(menuPassagens, '0', '2');
+        opcao = mostrarMenu(menuPassagens, '0', '3');
         switch(opcao) {
             case '0':
                 break;
@@ -497,6 +517,10 @@ void processarMenuPassagens(Bdados *bd) {
                 // Ver todas as passagens
                 listarViagensTodas(bd);
                 break;
+            case '3':
+                // Ler as passagens que forem sendo acrescentadas ao ficheiro
+                acompanharPassagensTxt(bd);
+                break;
             default:
                 opcao = '0'; 
                 break;
@@ -559,7 +583,7 @@ void processarMenuVelocidades(Bdados *bd) {
             case '2':
                 // Marca mais rápida
                 limpar_terminal();
-                char *marcaMaisRapida = obterMarcaMaisVelocidadeMedia(bd);
+                const char *marcaMaisRapida = obterMarcaMaisVelocidadeMedia(bd);
 
                 if (marcaMaisRapida) printf("A marca de automóveis mais rápida (velocidade média) é a \"%s\".\n\n", marcaMaisRapida);
                 else printf("Ainda não há dados sobre nenhum carro!\n\n");
@@ -624,7 +648,7 @@ void processarMenuInfracoes(Bdados *bd) {
 void processarMenuAnaliseDados(Bdados *bd) {
     char opcao;
     do {
-        opcao = mostrarMenu(menuAnaliseDados, '0', '2');
+        opcao = mostrarMenu(menuAnaliseDados, '0', '3');
         switch(opcao) {
             case '0':
                 break;
@@ -644,11 +668,21 @@ void processarMenuAnaliseDados(Bdados *bd) {
                 break;
             case '2':
                 limpar_terminal();
-                char *marcaMaisComum = obterMarcaMaisComum(bd->carrosMarca);
+                const char *marcaMaisComum = obterMarcaMaisComum(bd->carrosMarca);
 
                 if (marcaMaisComum) printf("A marca de automóveis mais comum é a \"%s\".\n\n", marcaMaisComum);
                 else printf("Ainda não há dados sobre nenhum carro!\n\n");
 
+                pressEnter();
+                break;
+            case '3':
+                limpar_terminal();
+                char relatorio[TAMANHO_RELATORIO_PERFIL];
+                if (perfilCarregamento.origem && formatarPerfil(&perfilCarregamento, relatorio, sizeof(relatorio))) {
+                    printf("Perfil do último carregamento (tempos em milissegundos):\n\n%s\n", relatorio);
+                }
+                else printf("Ainda não foi feito nenhum carregamento!\n\n");
+
                 pressEnter();
                 break;
             default:
@@ -690,6 +724,31 @@ void processarMenuExportacao(Bdados *bd) {
     } while(opcao != '0');
 }
 
+/**
+ * @brief Processa o menu das definições do carregamento
+ * 
+ * @return void
+ */
+void processarMenuCarregamento() {
+    char opcao;
+    do {
+        opcao = mostrarMenu(menuCarregamento, '0', '2');
+        switch(opcao) {
+            case '0':
+                break;
+            case '1':
+                setLimiteExemplosLogs();
+                break;
+            case '2':
+                setTimeoutPassagens();
+                break;
+            default:
+                opcao = '0';
+                break;
+        }
+    } while(opcao != '0');
+}
+
 /**
  * @brief Chama as funcionalidades e/ou submenus associados às opções
  * @param bd Ponteiro para a base de dados
@@ -699,7 +758,7 @@ void processarMenuExportacao(Bdados *bd) {
 void processarMenuOpcoes(Bdados *bd) {
     char opcao;
     do {
-        opcao = mostrarMenu(menuOpcoes, '0', '7');
+        opcao = mostrarMenu(menuOpcoes, '0', '9');
         switch(opcao) {
             case '0': break;
             case '1':
@@ -735,6 +794,12 @@ void processarMenuOpcoes(Bdados *bd) {
             case '7':
                 menuGuiaUtilizacao();
                 break;
+            case '8':
+                setNumThreads();
+                break;
+            case '9':
+                processarMenuCarregamento();
+                break;
             default: 
                 opcao = '0';
                 break;
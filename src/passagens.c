@@ -493,8 +493,8 @@ void registarViagem(Bdados *bd) {
                 pressEnter();
                 continue;
             }
-            void *matTemp = (void *)matricula;
-            c = (Carro *)searchDict(bd->carrosMat, matTemp, compChaveCarroMatricula, compCarroMatricula, hashChaveCarroMatricula);
+            uint32_t codMatricula = codificarMatricula(matricula);
+            c = (Carro *)searchDict(bd->carrosMat, &codMatricula, compChaveCarroMatricula, compCarroMatricula, hashChaveCarroMatricula);
             if (!c) {
                 free(matricula);
                 printf("Não foi encontrado nenhum carro com esta matrícula!\n\n");
@@ -0,0 +1,189 @@
+/* Perfil dos carregamentos (txt e bin): tempo de cada fase por ficheiro, débito e pico de memória,
+   medidos com um relógio monótono para que as fases abaixo de um segundo não apareçam como 0 */
+
+#include "perfilCarregamento.h"
+#include "structsGenericas.h"
+
+PerfilCarregamento perfilCarregamento = {0};
+
+/**
+ * @brief Instante atual de um relógio monótono
+ *
+ * @return double Segundos (só as diferenças entre instantes têm significado)
+ */
+double tempoAtual() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + (double)t.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Pico da memória residente (RSS) do processo desde que começou
+ *
+ * @return long KiB, 0 se não for possível obter
+ */
+long picoMemoriaProcesso() {
+#if defined(_WIN32) || defined(_WIN64)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return 0;
+    return (long)(pmc.PeakWorkingSetSize / 1024);
+#else
+    struct rusage uso;
+    if (getrusage(RUSAGE_SELF, &uso) != 0) return 0;
+    #if defined(__APPLE__)
+        return uso.ru_maxrss / 1024; // Em bytes no macOS
+    #else
+        return uso.ru_maxrss;
+    #endif
+#endif
+}
+
+/**
+ * @brief Começa um novo perfil, apagando o anterior
+ *
+ * @param p Perfil
+ * @param origem Tipo de carregamento ("txt" ou "bin")
+ */
+void iniciarPerfil(PerfilCarregamento *p, const char *origem) {
+    if (!p) return;
+
+    memset(p, 0, sizeof(PerfilCarregamento));
+    p->origem = origem;
+    p->numThreads = numThreads;
+    p->inicio = tempoAtual();
+}
+
+/**
+ * @brief Acrescenta uma etapa (normalmente um ficheiro) ao perfil
+ *
+ * @param p Perfil
+ * @param nome Nome da etapa (não é copiado)
+ * @return EtapaPerfil* Etapa a zeros, nunca NULL
+ *
+ * @note Se o perfil estiver cheio (ou for NULL) devolve uma etapa descartável, para quem mede não ter de verificar
+ */
+EtapaPerfil *novaEtapaPerfil(PerfilCarregamento *p, const char *nome) {
+    static EtapaPerfil descartada;
+
+    EtapaPerfil *e = (p && p->nEtapas < MAX_ETAPAS_PERFIL) ? &p->etapas[p->nEtapas++] : &descartada;
+    memset(e, 0, sizeof(EtapaPerfil));
+    e->nome = nome;
+    return e;
+}
+
+/**
+ * @brief Soma tempos às fases de uma etapa
+ *
+ * @param e Etapa (pode ser NULL)
+ * @param tempos Segundos de cada fase (NUM_FASES valores)
+ */
+void adicionarTemposPerfil(EtapaPerfil *e, const double *tempos) {
+    if (!e || !tempos) return;
+
+    for (int f = 0; f < NUM_FASES; f++) {
+        e->fases[f] += tempos[f];
+    }
+}
+
+/**
+ * @brief Fecha o perfil: tempo total e pico de memória
+ *
+ * @param p Perfil
+ */
+void terminarPerfil(PerfilCarregamento *p) {
+    if (!p) return;
+
+    p->tempoTotal = tempoAtual() - p->inicio;
+    p->picoMemoria = picoMemoriaProcesso();
+}
+
+/**
+ * @brief Largura a pedir ao printf para um texto UTF-8 ocupar largura colunas
+ *
+ * @param texto Texto
+ * @param largura Colunas
+ * @return int Largura em bytes
+ */
+static int larguraColuna(const char *texto, int largura) {
+    for (const unsigned char *s = (const unsigned char *)texto; *s; s++) {
+        if ((*s & 0xC0) == 0x80) largura++; // Byte de continuação: não ocupa coluna
+    }
+    return largura;
+}
+
+/**
+ * @brief Acrescenta texto formatado ao relatório, cortando o que não couber
+ *
+ * @param texto Relatório
+ * @param tamanho Tamanho de texto
+ * @param n Bytes já escritos, é atualizado
+ * @param formato Formato (printf)
+ */
+static void acrescentarTexto(char *texto, size_t tamanho, size_t *n, const char *formato, ...) {
+    if (*n >= tamanho - 1) return;
+
+    va_list args;
+    va_start(args, formato);
+    int escritos = vsnprintf(texto + *n, tamanho - *n, formato, args);
+    va_end(args);
+    if (escritos < 0) return;
+    *n += (size_t)escritos < tamanho - *n ? (size_t)escritos : tamanho - *n - 1;
+}
+
+/**
+ * @brief Acrescenta uma linha da tabela do perfil
+ *
+ * @param texto Relatório
+ * @param tamanho Tamanho de texto
+ * @param n Bytes já escritos, é atualizado
+ * @param e Etapa
+ */
+static void acrescentarEtapaPerfil(char *texto, size_t tamanho, size_t *n, const EtapaPerfil *e) {
+    double mb = e->nBytes / 1000000.0;
+    double linhasSeg = (e->tempo > 0) ? e->nLinhas / e->tempo : 0;
+    double mbSeg = (e->tempo > 0) ? mb / e->tempo : 0;
+
+    acrescentarTexto(texto, tamanho, n, "%-*s | %9ld | %7.2f | %9.3f | %8.3f | %8.3f | %8.3f | %9.3f | %8.3f | %10.0f | %7.2f\n",
+        larguraColuna(e->nome, 11), e->nome, e->nLinhas, mb, e->tempo * 1000,
+        e->fases[FASE_LEITURA] * 1000, e->fases[FASE_ANALISE] * 1000, e->fases[FASE_INSERCAO] * 1000,
+        e->fases[FASE_ORDENACAO] * 1000, e->fases[FASE_CHECKSUM] * 1000, linhasSeg, mbSeg);
+}
+
+/**
+ * @brief Escreve o relatório do perfil em forma de tabela (tempos em milissegundos)
+ *
+ * @param p Perfil
+ * @param texto Destino
+ * @param tamanho Tamanho de texto (TAMANHO_RELATORIO_PERFIL chega para MAX_ETAPAS_PERFIL etapas)
+ * @return int Nº de bytes escritos, 0 se erro
+ *
+ * @note Os tempos das fases são somados entre threads, por isso numa etapa em paralelo podem passar o tempo real
+ */
+int formatarPerfil(const PerfilCarregamento *p, char *texto, size_t tamanho) {
+    if (!p || !texto || tamanho == 0) return 0;
+
+    size_t n = 0;
+    texto[0] = '\0';
+    acrescentarTexto(texto, tamanho, &n, "#PERFIL DO CARREGAMENTO#\t\t%s, %d thread(s)\n", p->origem ? p->origem : "?", p->numThreads);
+    acrescentarTexto(texto, tamanho, &n, "Etapa       |    Linhas |      MB |  Tempo ms |  Leitura |  Análise | Inserção | Ordenação | Checksum |   Linhas/s |    MB/s\n");
+    acrescentarTexto(texto, tamanho, &n, "------------|-----------|---------|-----------|----------|----------|----------|-----------|----------|------------|--------\n");
+
+    EtapaPerfil total = {"Total", p->tempoTotal, {0}, 0, 0};
+    for (int i = 0; i < p->nEtapas; i++) {
+        const EtapaPerfil *e = &p->etapas[i];
+        acrescentarEtapaPerfil(texto, tamanho, &n, e);
+        for (int f = 0; f < NUM_FASES; f++) {
+            total.fases[f] += e->fases[f];
+        }
+        total.nLinhas += e->nLinhas;
+        total.nBytes += e->nBytes;
+    }
+    acrescentarEtapaPerfil(texto, tamanho, &n, &total);
+    if (p->picoMemoria > 0) {
+        acrescentarTexto(texto, tamanho, &n, "Pico de memória (RSS): %ld KiB (%.2f MiB)\n", p->picoMemoria, p->picoMemoria / 1024.0);
+    }
+    else {
+        acrescentarTexto(texto, tamanho, &n, "Pico de memória (RSS): indisponível\n");
+    }
+    return (int)n;
+}
@@ -0,0 +1,379 @@
+/* Logs do carregamento dos .txt: as mensagens são formatadas para blocos em memória e escritas em blocos grandes,
+   opcionalmente por uma thread própria, para que o carregamento não fique à espera do disco */
+
+#include "registoLogs.h"
+
+/**
+ * @brief Escreve os blocos à espera no anel (ponto de entrada da thread do escritor)
+ *
+ * @param arg RegistoLogs
+ * @return void* NULL
+ */
+static void *executarEscritorLogs(void *arg) {
+    RegistoLogs *r = (RegistoLogs *)arg;
+
+    pthread_mutex_lock(&r->mutex);
+    while (1) {
+        while (r->nPendentes == 0 && !r->terminar) {
+            pthread_cond_wait(&r->temBlocos, &r->mutex);
+        }
+        if (r->nPendentes == 0) break; // Terminar e já não há nada para escrever
+
+        BlocoLog bloco = r->anel[r->inicioAnel];
+        r->inicioAnel = (r->inicioAnel + 1) % r->capacidadeAnel;
+        r->nPendentes--;
+        r->aEscrever = 1;
+        pthread_mutex_unlock(&r->mutex);
+
+        fwrite(bloco.dados, 1, bloco.usado, r->ficheiro);
+
+        pthread_mutex_lock(&r->mutex);
+        r->aEscrever = 0;
+        if (bloco.capacidade == TAMANHO_BLOCO_LOG && r->nLivres < NUM_BLOCOS_LOG) {
+            r->livres[r->nLivres++] = bloco.dados;
+        }
+        else {
+            free(bloco.dados);
+        }
+    }
+    pthread_mutex_unlock(&r->mutex);
+    return NULL;
+}
+
+/**
+ * @brief Cria o registo dos logs
+ *
+ * @param ficheiro Ficheiro de logs, aberto (não é fechado pelo registo)
+ * @param comEscritor 1 para escrever numa thread em segundo plano, 0 para escrever na thread atual quando um bloco enche
+ * @param limiteExemplos Nº máximo de linhas inválidas escritas por razão (0 = sem limite); as restantes só são contadas
+ * @return RegistoLogs* NULL se erro
+ *
+ * @note Se não for possível criar a thread, o registo funciona sem escritor
+ */
+RegistoLogs *criarRegistoLogs(FILE *ficheiro, int comEscritor, int limiteExemplos) {
+    if (!ficheiro) return NULL;
+
+    RegistoLogs *r = (RegistoLogs *)calloc(1, sizeof(RegistoLogs));
+    if (!r) return NULL;
+
+    r->ficheiro = ficheiro;
+    r->limiteExemplos = (limiteExemplos > 0) ? limiteExemplos : 0;
+    r->atual.dados = (char *)malloc(TAMANHO_BLOCO_LOG);
+    r->anel = (BlocoLog *)malloc(NUM_BLOCOS_LOG * sizeof(BlocoLog));
+    r->livres = (char **)malloc(NUM_BLOCOS_LOG * sizeof(char *));
+    if (!r->atual.dados || !r->anel || !r->livres) {
+        free(r->atual.dados);
+        free(r->anel);
+        free(r->livres);
+        free(r);
+        return NULL;
+    }
+    r->atual.capacidade = TAMANHO_BLOCO_LOG;
+    r->capacidadeAnel = NUM_BLOCOS_LOG;
+
+    if (comEscritor) {
+        pthread_mutex_init(&r->mutex, NULL);
+        pthread_cond_init(&r->temBlocos, NULL);
+        if (pthread_create(&r->escritor, NULL, executarEscritorLogs, r) == 0) {
+            r->comEscritor = 1;
+        }
+        else {
+            pthread_mutex_destroy(&r->mutex);
+            pthread_cond_destroy(&r->temBlocos);
+        }
+    }
+    return r;
+}
+
+/**
+ * @brief Espera que o escritor escreva todos os blocos pendentes
+ *
+ * @param r Registo (com escritor e com o mutex já obtido, que continua obtido no fim)
+ *
+ * @note Depois disto, o que for escrito diretamente no ficheiro fica a seguir a tudo o que foi entregue
+ */
+static void esperarEscritorLogs(RegistoLogs *r) {
+    while (r->nPendentes > 0 || r->aEscrever) {
+        pthread_cond_signal(&r->temBlocos);
+        pthread_mutex_unlock(&r->mutex);
+        sched_yield();
+        pthread_mutex_lock(&r->mutex);
+    }
+}
+
+/**
+ * @brief Passa um bloco cheio para o anel do escritor (ou escreve-o, se não houver escritor)
+ *
+ * @param r Registo
+ * @param bloco Bloco (deixa de pertencer a quem chama)
+ *
+ * @note Nunca espera pelo escritor: com o anel cheio, o anel cresce
+ */
+static void entregarBlocoLog(RegistoLogs *r, BlocoLog bloco) {
+    if (!r->comEscritor) {
+        fwrite(bloco.dados, 1, bloco.usado, r->ficheiro);
+        free(bloco.dados);
+        return;
+    }
+
+    pthread_mutex_lock(&r->mutex);
+    if (r->nPendentes == r->capacidadeAnel) {
+        int capacidade = r->capacidadeAnel * 2;
+        BlocoLog *temp = (BlocoLog *)malloc(capacidade * sizeof(BlocoLog));
+        if (!temp) {
+            // Sem memória: escrever já (por ordem, depois dos pendentes)
+            esperarEscritorLogs(r);
+            fwrite(bloco.dados, 1, bloco.usado, r->ficheiro);
+            free(bloco.dados);
+            pthread_mutex_unlock(&r->mutex);
+            return;
+        }
+        for (int i = 0; i < r->nPendentes; i++) {
+            temp[i] = r->anel[(r->inicioAnel + i) % r->capacidadeAnel];
+        }
+        free(r->anel);
+        r->anel = temp;
+        r->capacidadeAnel = capacidade;
+        r->inicioAnel = 0;
+    }
+    r->anel[(r->inicioAnel + r->nPendentes) % r->capacidadeAnel] = bloco;
+    r->nPendentes++;
+    pthread_cond_signal(&r->temBlocos);
+    pthread_mutex_unlock(&r->mutex);
+}
+
+/**
+ * @brief Troca o bloco atual por um vazio com pelo menos tamanho bytes
+ *
+ * @param r Registo
+ * @param tamanho Bytes necessários
+ * @return int 1 se sucesso, 0 se erro (o bloco atual foi entregue e fica sem buffer)
+ */
+static int novoBlocoLog(RegistoLogs *r, size_t tamanho) {
+    if (!r->comEscritor && r->atual.dados && tamanho <= r->atual.capacidade) {
+        // Sem escritor o mesmo bloco é reutilizado
+        fwrite(r->atual.dados, 1, r->atual.usado, r->ficheiro);
+        r->atual.usado = 0;
+        return 1;
+    }
+    if (r->atual.usado > 0) {
+        entregarBlocoLog(r, r->atual);
+    }
+    else {
+        free(r->atual.dados);
+    }
+    r->atual.dados = NULL;
+    r->atual.usado = 0;
+    r->atual.capacidade = 0;
+
+    size_t capacidade = (tamanho > TAMANHO_BLOCO_LOG) ? tamanho : TAMANHO_BLOCO_LOG;
+    if (capacidade == TAMANHO_BLOCO_LOG && r->comEscritor) {
+        pthread_mutex_lock(&r->mutex);
+        if (r->nLivres > 0) {
+            r->atual.dados = r->livres[--r->nLivres];
+        }
+        pthread_mutex_unlock(&r->mutex);
+    }
+    if (!r->atual.dados) {
+        r->atual.dados = (char *)malloc(capacidade);
+        if (!r->atual.dados) return 0;
+    }
+    r->atual.capacidade = capacidade;
+    return 1;
+}
+
+/**
+ * @brief Formata uma mensagem para o bloco atual
+ *
+ * @param r Registo
+ * @param formato Formato (printf)
+ * @param args Argumentos
+ */
+static void formatarLog(RegistoLogs *r, const char *formato, va_list args) {
+    va_list copia;
+    va_copy(copia, args);
+    size_t livre = r->atual.capacidade - r->atual.usado;
+    int n = r->atual.dados ? vsnprintf(r->atual.dados + r->atual.usado, livre, formato, copia) : -1;
+    va_end(copia);
+
+    if (n >= 0 && (size_t)n < livre) {
+        r->atual.usado += (size_t)n;
+        return;
+    }
+    if (n < 0) {
+        va_copy(copia, args);
+        n = vsnprintf(NULL, 0, formato, copia);
+        va_end(copia);
+        if (n < 0) return;
+    }
+    // Não coube: passar para um bloco novo
+    if (!novoBlocoLog(r, (size_t)n + 1)) {
+        // Sem memória: escrever diretamente, mas só depois dos blocos que o escritor ainda tem
+        if (r->comEscritor) {
+            pthread_mutex_lock(&r->mutex);
+            esperarEscritorLogs(r);
+        }
+        vfprintf(r->ficheiro, formato, args);
+        if (r->comEscritor) {
+            pthread_mutex_unlock(&r->mutex);
+        }
+        return;
+    }
+    vsnprintf(r->atual.dados, r->atual.capacidade, formato, args);
+    r->atual.usado = (size_t)n;
+}
+
+/**
+ * @brief Escreve uma mensagem nos logs
+ *
+ * @param r Registo
+ * @param formato Formato (printf)
+ * @param ... Argumentos
+ */
+void escreverLog(RegistoLogs *r, const char *formato, ...) {
+    if (!r || !formato) return;
+
+    va_list args;
+    va_start(args, formato);
+    formatarLog(r, formato, args);
+    va_end(args);
+}
+
+/**
+ * @brief Conta mais uma ocorrência de uma razão
+ *
+ * @param r Registo
+ * @param razao Formato da razão
+ * @return int Nº de ocorrências da razão, incluindo esta (0 se erro de memória)
+ */
+static int contarRazao(RegistoLogs *r, const char *razao) {
+    for (int i = 0; i < r->nRazoes; i++) {
+        if (r->razoes[i].razao == razao || strcmp(r->razoes[i].razao, razao) == 0) {
+            return ++r->razoes[i].total;
+        }
+    }
+    if (r->nRazoes == r->capacidadeRazoes) {
+        int capacidade = r->capacidadeRazoes ? r->capacidadeRazoes * 2 : 16;
+        ContagemRazao *temp = (ContagemRazao *)realloc(r->razoes, capacidade * sizeof(ContagemRazao));
+        if (!temp) return 0;
+        r->razoes = temp;
+        r->capacidadeRazoes = capacidade;
+    }
+    r->razoes[r->nRazoes].razao = razao;
+    r->razoes[r->nRazoes].total = 1;
+    r->nRazoes++;
+    return 1;
+}
+
+/**
+ * @brief Regista uma linha inválida e a razão
+ *
+ * @param r Registo
+ * @param linha Linha inválida
+ * @param nLinha Número da linha
+ * @param razao Razão (formato printf); cada formato diferente é contado à parte
+ * @param ... Argumentos da razão
+ *
+ * @note Com limite de exemplos, só as primeiras ocorrências de cada razão são escritas; o resto aparece no resumo
+ */
+void registarLinhaInvalida(RegistoLogs *r, Fatia linha, int nLinha, const char *razao, ...) {
+    if (!r || !razao) return;
+
+    int total = contarRazao(r, razao);
+    if (r->limiteExemplos > 0 && total > r->limiteExemplos) return;
+
+    escreverLog(r, "Linha %d inválida: %.*s\n", nLinha, (int)linha.tamanho, linha.inicio);
+    escreverLog(r, "Razão: ");
+    va_list args;
+    va_start(args, razao);
+    formatarLog(r, razao, args);
+    va_end(args);
+    escreverLog(r, "\n\n");
+}
+
+/**
+ * @brief Escreve o formato de uma razão, trocando cada conversão (%d, %s, ...) por '*'
+ *
+ * @param r Registo
+ * @param razao Formato da razão
+ */
+static void escreverRazaoResumo(RegistoLogs *r, const char *razao) {
+    char texto[TAMANHO_BUFFER_LISTAGEM];
+    size_t n = 0;
+    for (const char *p = razao; *p && n < sizeof(texto) - 1; p++) {
+        if (*p == '\n') continue;
+        if (*p != '%') {
+            texto[n++] = *p;
+            continue;
+        }
+        p++;
+        if (*p == '%') {
+            texto[n++] = '%';
+            continue;
+        }
+        while (*p && strchr("-+ #0123456789.*hlLqjzt", *p)) p++;
+        if (!*p) break;
+        texto[n++] = '*';
+    }
+    texto[n] = '\0';
+    escreverLog(r, "%s", texto);
+}
+
+/**
+ * @brief Escreve o total de cada razão (apenas com limite de exemplos) e recomeça as contagens
+ *
+ * @param r Registo
+ *
+ * @note Chamado no fim de cada ficheiro, para as contagens serem por ficheiro
+ */
+void escreverResumoLogs(RegistoLogs *r) {
+    if (!r) return;
+
+    if (r->limiteExemplos > 0 && r->nRazoes > 0) {
+        escreverLog(r, "Resumo das linhas inválidas (até %d exemplo(s) por razão):\n", r->limiteExemplos);
+        for (int i = 0; i < r->nRazoes; i++) {
+            int omitidas = r->razoes[i].total - r->limiteExemplos;
+            escreverLog(r, "\t%d ocorrência(s), %d omitida(s): ", r->razoes[i].total, (omitidas > 0) ? omitidas : 0);
+            escreverRazaoResumo(r, r->razoes[i].razao);
+            escreverLog(r, "\n");
+        }
+    }
+    r->nRazoes = 0;
+}
+
+/**
+ * @brief Escreve o que falta, termina o escritor e liberta o registo
+ *
+ * @param r Registo
+ *
+ * @note O ficheiro fica aberto (e com os dados já passados ao sistema)
+ */
+void fecharRegistoLogs(RegistoLogs *r) {
+    if (!r) return;
+
+    if (r->atual.usado > 0) {
+        entregarBlocoLog(r, r->atual);
+    }
+    else {
+        free(r->atual.dados);
+    }
+
+    if (r->comEscritor) {
+        pthread_mutex_lock(&r->mutex);
+        r->terminar = 1;
+        pthread_cond_signal(&r->temBlocos);
+        pthread_mutex_unlock(&r->mutex);
+        pthread_join(r->escritor, NULL);
+        pthread_mutex_destroy(&r->mutex);
+        pthread_cond_destroy(&r->temBlocos);
+    }
+    fflush(r->ficheiro);
+
+    for (int i = 0; i < r->nLivres; i++) {
+        free(r->livres[i]);
+    }
+    free(r->livres);
+    free(r->anel);
+    free(r->razoes);
+    free(r);
+}
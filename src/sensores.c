@@ -19,34 +19,17 @@ int inserirSensorLido(Bdados *bd, int codSensor, char *designacao, char *latitud
     //Codigo Sensor
     sen->codSensor = codSensor;
     //Designação
-    sen->designacao = (char *)malloc(strlen(designacao) * sizeof(char) + 1);
-    if (!sen->designacao) {
-        free(sen);
-        return 0;
-    }
-    strcpy(sen->designacao, designacao);
+    sen->designacao = guardarStringArena(bd->strings, designacao);
     //Latitude
-    sen->latitude = (char *)malloc(strlen(latitude) * sizeof(char) + 1);
-    if (!sen->latitude) {
-        free(sen->designacao);
-        free(sen);
-        return 0;
-    }
-    strcpy(sen->latitude, latitude);
+    sen->latitude = guardarStringArena(bd->strings, latitude);
     //Longitude
-    sen->longitude = (char *)malloc(strlen(longitude) * sizeof(char) + 1);
-    if (!sen->longitude) {
-        free(sen->designacao);
-        free(sen->latitude);
+    sen->longitude = guardarStringArena(bd->strings, longitude);
+    if (!sen->designacao || !sen->latitude || !sen->longitude) {
         free(sen);
         return 0;
     }
-    strcpy(sen->longitude, longitude);
 
     if (!addInicioLista(bd->sensores, (void *)sen)) {
-        free(sen->designacao);
-        free(sen->latitude);
-        free(sen->longitude);
         free(sen);
         return 0;
     }
@@ -96,11 +79,8 @@ int compIdSensor(void *sensor, void *idSensor) {
  * @param sensor Sensor a libertar
  */
 void freeSensor(void *sensor) {
-    Sensor *obj = (Sensor *)sensor;
-    if (obj->designacao) free(obj->designacao);
-    if (obj->latitude) free(obj->latitude);
-    if (obj->longitude) free(obj->longitude);
-    free(obj);
+    // As strings do sensor pertencem à arena da base de dados
+    free(sensor);
 }
 
 /**
@@ -157,7 +137,7 @@ void *readSensorBin(FILE *file) {
 
     size_t tamanhoDesignacao;
     fread(&tamanhoDesignacao, sizeof(size_t), 1, file);
-    x->designacao = (char *)malloc(tamanhoDesignacao);
+    x->designacao = reservarArena(arenaLeituraBin, tamanhoDesignacao);
     if (!x->designacao) {
         free(x);
         return NULL;
@@ -166,9 +146,8 @@ void *readSensorBin(FILE *file) {
 
     size_t tamanhoLatitude;
     fread(&tamanhoLatitude, sizeof(size_t), 1, file);
-    x->latitude = (char *)malloc(tamanhoLatitude);
+    x->latitude = reservarArena(arenaLeituraBin, tamanhoLatitude);
     if (!x->latitude) {
-        free(x->designacao);
         free(x);
         return NULL;
     }
@@ -176,10 +155,8 @@ void *readSensorBin(FILE *file) {
 
     size_t tamanhoLongitude;
     fread(&tamanhoLongitude, sizeof(size_t), 1, file);
-    x->longitude = (char *)malloc(tamanhoLongitude);
+    x->longitude = reservarArena(arenaLeituraBin, tamanhoLongitude);
     if (!x->longitude) {
-        free(x->designacao);
-        free(x->latitude);
         free(x);
         return NULL;
     }
@@ -288,12 +265,7 @@ void printSensorHTML(void *sensor, FILE *file) {
 size_t memUsageSensor(void *sensor) {
     if (!sensor) return 0;
 
-    Sensor *s = (Sensor *)sensor;
-
-    size_t mem = sizeof(Sensor);
-    mem += strlen(s->designacao) + 1;
-    mem += strlen(s->latitude) + 1;
-    mem += strlen(s->longitude) + 1;
+    size_t mem = sizeof(Sensor); // As strings são contabilizadas na arena
 
     return mem;
 }
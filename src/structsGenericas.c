@@ -1,7 +1,366 @@
 #include "structsGenericas.h"
+#include <pthread.h>
+#include <sched.h>
 
 int listagemFlag = 0; // Inicializar a 0, caso seja 1 a listagem é interrompida
 int printingDict = 0;
+int numThreads = NUM_THREADS; // Configurável nas opções
+
+// Pool de nós
+
+/*
+ * Os nós das listas e dos rankings são retirados de blocos (slabs) de NOS_POR_SLAB nós.
+ * Os nós libertados voltam a uma lista de nós livres, ligados pelo próprio campo prox.
+ * Quando os nós livres passam de limiteLivres, os slabs em que todos os nós estão livres
+ * são devolvidos ao sistema (ver libertarSlabsLivres), mesmo que o resto do pool esteja em uso.
+ */
+typedef struct slab {
+    struct slab *prox;
+    size_t nNos;
+    size_t nLivres; // Só é válido durante libertarSlabsLivres
+} Slab;
+
+typedef struct {
+    size_t tamanhoNo;
+    size_t offsetProx; // Posição do campo prox no nó (usado para ligar os nós livres)
+    void *livres;
+    Slab *slabs;
+    size_t emUso;
+    size_t nLivres;
+    size_t limiteLivres; // Nº de nós livres a partir do qual se procuram slabs inteiramente livres
+} PoolNos;
+
+static PoolNos poolNos = {sizeof(No), offsetof(No, prox), NULL, NULL, 0, 0, LIMITE_MINIMO_NOS_LIVRES};
+static PoolNos poolRankings = {sizeof(NoRankings), offsetof(NoRankings, prox), NULL, NULL, 0, 0, LIMITE_MINIMO_NOS_LIVRES};
+
+/**
+ * @brief Acesso ao campo prox de um nó do pool
+ * 
+ * @param pool Pool
+ * @param no Nó
+ * @return void** Endereço do campo prox
+ */
+static void **proxNoPool(PoolNos *pool, void *no) {
+    return (void **)((char *)no + pool->offsetProx);
+}
+
+// Os nós ficam logo a seguir ao cabeçalho do slab, alinhado a um ponteiro
+#define CABECALHO_SLAB ((sizeof(Slab) + sizeof(void *) - 1) / sizeof(void *) * sizeof(void *))
+
+/**
+ * @brief Obtém o primeiro nó de um slab
+ * 
+ * @param s Slab
+ * @return char* Início dos nós
+ */
+static char *nosSlab(Slab *s) {
+    return (char *)s + CABECALHO_SLAB;
+}
+
+/**
+ * @brief Aloca um slab e junta os seus nós aos nós livres
+ * 
+ * @param pool Pool
+ * @param nNos Nº de nós do slab
+ * @return int 1 se sucesso, 0 se erro
+ */
+static int novoSlabPool(PoolNos *pool, size_t nNos) {
+    Slab *s = (Slab *)malloc(CABECALHO_SLAB + pool->tamanhoNo * nNos);
+    if (!s) return 0;
+
+    s->prox = pool->slabs;
+    s->nNos = nNos;
+    pool->slabs = s;
+
+    char *nos = nosSlab(s);
+    for (size_t i = nNos; i-- > 0; ) {
+        void *no = nos + i * pool->tamanhoNo;
+        *proxNoPool(pool, no) = pool->livres;
+        pool->livres = no;
+    }
+    pool->nLivres += nNos;
+    return 1;
+}
+
+/**
+ * @brief Obtém um nó do pool, alocando um novo slab se não houver nós livres
+ * 
+ * @param pool Pool
+ * @return void* Nó ou NULL se erro
+ */
+static void *alocarNoPool(PoolNos *pool) {
+    if (!pool->livres && !novoSlabPool(pool, NOS_POR_SLAB)) return NULL;
+
+    void *no = pool->livres;
+    pool->livres = *proxNoPool(pool, no);
+    pool->emUso++;
+    pool->nLivres--;
+    return no;
+}
+
+/**
+ * @brief Compara dois slabs pelo endereço (para o qsort)
+ * 
+ * @param a Ponteiro para o slab 1
+ * @param b Ponteiro para o slab 2
+ * @return int -1, 0 ou 1
+ */
+static int compararSlabs(const void *a, const void *b) {
+    uintptr_t x = (uintptr_t)*(Slab *const *)a;
+    uintptr_t y = (uintptr_t)*(Slab *const *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Obtém o slab a que um nó pertence
+ * 
+ * @param ordem Slabs ordenados por endereço
+ * @param n Nº de slabs
+ * @param no Nó
+ * @return Slab* Slab (o último que começa antes do nó)
+ */
+static Slab *slabDoNo(Slab **ordem, size_t n, void *no) {
+    size_t inicio = 0;
+    size_t fim = n;
+    while (fim - inicio > 1) {
+        size_t meio = inicio + (fim - inicio) / 2;
+        if ((uintptr_t)ordem[meio] <= (uintptr_t)no) inicio = meio;
+        else fim = meio;
+    }
+    return ordem[inicio];
+}
+
+/**
+ * @brief Devolve ao sistema os slabs de um pool em que todos os nós estão livres
+ * 
+ * @param pool Pool
+ * 
+ * @note O(nós livres * log slabs). Se ainda houver nós em uso, o limite seguinte passa para o dobro dos nós que ficaram
+ *       livres, para que slabs fragmentados não obriguem a percorrer os nós livres em cada devolução
+ */
+static void libertarSlabsLivres(PoolNos *pool) {
+    size_t n = 0;
+    for (Slab *s = pool->slabs; s; s = s->prox) n++;
+
+    Slab **ordem = (pool->emUso && n) ? (Slab **)malloc(n * sizeof(Slab *)) : NULL;
+    if (pool->emUso && !ordem) return; // Sem memória para a procura, fica para a próxima devolução
+    if (ordem) {
+        n = 0;
+        for (Slab *s = pool->slabs; s; s = s->prox) {
+            s->nLivres = 0;
+            ordem[n++] = s;
+        }
+        qsort(ordem, n, sizeof(Slab *), compararSlabs);
+        for (void *no = pool->livres; no; no = *proxNoPool(pool, no)) {
+            slabDoNo(ordem, n, no)->nLivres++;
+        }
+
+        // Retirar da lista de livres os nós dos slabs que vão ser libertados
+        void **ant = &pool->livres;
+        while (*ant) {
+            Slab *s = slabDoNo(ordem, n, *ant);
+            if (s->nLivres == s->nNos) {
+                *ant = *proxNoPool(pool, *ant);
+                pool->nLivres--;
+            }
+            else {
+                ant = proxNoPool(pool, *ant);
+            }
+        }
+        free(ordem);
+    }
+    else {
+        // Nenhum nó em uso: todos os slabs são libertados
+        pool->livres = NULL;
+        pool->nLivres = 0;
+    }
+
+    Slab **p = &pool->slabs;
+    while (*p) {
+        Slab *s = *p;
+        if (!pool->emUso || s->nLivres == s->nNos) {
+            *p = s->prox;
+            free(s);
+        }
+        else {
+            p = &s->prox;
+        }
+    }
+    pool->limiteLivres = (2 * pool->nLivres > LIMITE_MINIMO_NOS_LIVRES) ? 2 * pool->nLivres : LIMITE_MINIMO_NOS_LIVRES;
+}
+
+/**
+ * @brief Devolve ao pool uma cadeia de nós já ligados pelo campo prox
+ * 
+ * @param pool Pool
+ * @param inicio Primeiro nó da cadeia
+ * @param fim Último nó da cadeia
+ * @param n Número de nós da cadeia
+ * 
+ * @note O(1), a cadeia é colocada inteira à cabeça dos nós livres. Só quando os nós livres passam de limiteLivres
+ *       (por exemplo, ao libertar uma lista ou um dicionário grandes) são procurados slabs para devolver ao sistema
+ */
+static void devolverCadeiaPool(PoolNos *pool, void *inicio, void *fim, size_t n) {
+    if (!inicio || !fim) return;
+
+    *proxNoPool(pool, fim) = pool->livres;
+    pool->livres = inicio;
+    pool->emUso -= n;
+    pool->nLivres += n;
+    if (pool->nLivres > pool->limiteLivres) libertarSlabsLivres(pool);
+}
+
+/**
+ * @brief Garante que há pelo menos n nós de lista livres, num único slab se for preciso alocar
+ * 
+ * @param n Nº de nós que vão ser inseridos em listas
+ * @return int 1 se sucesso, 0 se erro
+ * 
+ * @note Usado antes de carregamentos grandes, para não alocar slabs durante as inserções
+ */
+int reservarNosLista(int n) {
+    if (n <= 0 || (size_t)n <= poolNos.nLivres) return 1;
+
+    if (!novoSlabPool(&poolNos, (size_t)n - poolNos.nLivres)) return 0;
+    // A reserva ainda não foi usada, não deve ser devolvida logo na próxima devolução de nós
+    if (poolNos.limiteLivres < 2 * poolNos.nLivres) poolNos.limiteLivres = 2 * poolNos.nLivres;
+    return 1;
+}
+
+/**
+ * @brief Devolve ao sistema a memória dos pools de nós das listas e dos rankings
+ * 
+ * @note Liberta todos os slabs cujos nós já foram todos libertados (freeLista/freeRanking), mesmo que ainda
+ *       existam listas ou rankings em uso noutros slabs
+ */
+void libertarPoolsNos() {
+    libertarSlabsLivres(&poolNos);
+    libertarSlabsLivres(&poolRankings);
+}
+
+// Arena de strings
+
+/**
+ * @brief Cria uma arena de strings vazia
+ * 
+ * @return ArenaStrings* Arena ou NULL se erro
+ * 
+ * @note As strings guardadas na arena são imutáveis e só são libertadas todas de uma vez, em freeArena
+ */
+ArenaStrings *criarArena() {
+    ArenaStrings *arena = (ArenaStrings *)malloc(sizeof(ArenaStrings));
+    if (!arena) return NULL;
+
+    arena->blocos = NULL;
+    arena->memReservada = sizeof(ArenaStrings);
+    return arena;
+}
+
+/**
+ * @brief Reserva espaço contíguo na arena
+ * 
+ * @param arena Arena
+ * @param tamanho Número de bytes a reservar
+ * @return char* Início do espaço reservado ou NULL se erro
+ * 
+ * @note Pedidos maiores que TAMANHO_BLOCO_ARENA ficam num bloco próprio
+ */
+char *reservarArena(ArenaStrings *arena, size_t tamanho) {
+    if (!arena || tamanho == 0) return NULL;
+
+    BlocoArena *b = arena->blocos;
+    if (!b || b->capacidade - b->usado < tamanho) {
+        size_t capacidade = tamanho > TAMANHO_BLOCO_ARENA ? tamanho : TAMANHO_BLOCO_ARENA;
+        b = (BlocoArena *)malloc(sizeof(BlocoArena) + capacidade);
+        if (!b) return NULL;
+
+        b->usado = 0;
+        b->capacidade = capacidade;
+        b->prox = arena->blocos;
+        arena->blocos = b;
+        arena->memReservada += sizeof(BlocoArena) + capacidade;
+    }
+    char *res = b->dados + b->usado;
+    b->usado += tamanho;
+    return res;
+}
+
+/**
+ * @brief Garante que o bloco atual da arena tem pelo menos tamanho bytes livres
+ * 
+ * @param arena Arena
+ * @param tamanho Nº de bytes que vão ser guardados
+ * @return int 1 se sucesso, 0 se erro
+ * 
+ * @note Usado antes de carregamentos grandes, para as strings seguintes não alocarem blocos novos
+ */
+int reservarEspacoArena(ArenaStrings *arena, size_t tamanho) {
+    if (!arena) return 0;
+
+    BlocoArena *b = arena->blocos;
+    if (tamanho == 0 || (b && b->capacidade - b->usado >= tamanho)) return 1;
+
+    b = (BlocoArena *)malloc(sizeof(BlocoArena) + tamanho);
+    if (!b) return 0;
+
+    b->usado = 0;
+    b->capacidade = tamanho;
+    b->prox = arena->blocos;
+    arena->blocos = b;
+    arena->memReservada += sizeof(BlocoArena) + tamanho;
+    return 1;
+}
+
+/**
+ * @brief Copia uma string para a arena
+ * 
+ * @param arena Arena
+ * @param str String a copiar
+ * @return char* Cópia guardada na arena ou NULL se erro
+ * 
+ * @note A cópia não deve ser libertada com free()
+ */
+char *guardarStringArena(ArenaStrings *arena, const char *str) {
+    if (!arena || !str) return NULL;
+
+    size_t tamanho = strlen(str) + 1;
+    char *copia = reservarArena(arena, tamanho);
+    if (!copia) return NULL;
+
+    memcpy(copia, str, tamanho);
+    return copia;
+}
+
+/**
+ * @brief Liberta a arena e todas as strings nela guardadas
+ * 
+ * @param arena Arena
+ */
+void freeArena(ArenaStrings *arena) {
+    if (!arena) return;
+
+    BlocoArena *b = arena->blocos;
+    while (b) {
+        BlocoArena *seg = b->prox;
+        free(b);
+        b = seg;
+    }
+    free(arena);
+}
+
+/**
+ * @brief Memória ocupada pela arena
+ * 
+ * @param arena Arena
+ * @return size_t Memória reservada (incluindo espaço ainda livre) ou 0 se erro
+ */
+size_t arenaMemUsage(ArenaStrings *arena) {
+    if (!arena) return 0;
+
+    return arena->memReservada;
+}
+
+// Listas
 
 /**
  * @brief Cria uma lista genérica
@@ -29,7 +388,7 @@ int addInicioLista(Lista *li, void *elemento) {
         return 0;
     }
 
-    No *aux = (No *)malloc(sizeof(No));
+    No *aux = (No *)alocarNoPool(&poolNos);
     if (!aux) return 0;
 
     aux->info = elemento;
@@ -40,6 +399,33 @@ int addInicioLista(Lista *li, void *elemento) {
     return 1;
 }
 
+/**
+ * @brief Remove um elemento da lista
+ * 
+ * @param li Lista
+ * @param elemento Elemento a remover (comparado pelo endereço)
+ * @return int 1 se foi removido, 0 se não existe na lista ou erro
+ * 
+ * @note O elemento não é libertado, só o nó que o guardava
+ */
+int removerDaLista(Lista *li, void *elemento) {
+    if (!li || !elemento) return 0;
+
+    No *ant = NULL;
+    No *p = li->inicio;
+    while (p && p->info != elemento) {
+        ant = p;
+        p = p->prox;
+    }
+    if (!p) return 0;
+
+    if (ant) ant->prox = p->prox;
+    else li->inicio = p->prox;
+    li->nel--;
+    devolverCadeiaPool(&poolNos, p, p, 1);
+    return 1;
+}
+
 /**
  * @brief Coloca um elemento no final da lista
  * 
@@ -53,7 +439,7 @@ int addFimLista(Lista *li, void *elemento) {
         return 0;
     }
 
-    No *aux = (No *)malloc(sizeof(No));
+    No *aux = (No *)alocarNoPool(&poolNos);
     if (!aux) return 0;
 
     aux->info = elemento;
@@ -236,238 +622,512 @@ void exportarListaHTML(Lista *li, char *pagename, void (*printTableHead)(FILE *f
  * @param li    Lista
  * @param freeObj   Função para libertar a memória de cada x elemento
  * 
- * @note freeObj pode ser passada como NULL para ignorar a libertação de cada elemento
+ * @note freeObj pode ser passada como NULL para ignorar a libertação de cada elemento. Os nós sem informação (de uma
+ *       leitura binária interrompida) são ignorados
  */
 void freeLista(Lista *li, void (*freeObj)(void *obj)) {
     if (!li) return;
 
     No *p = li->inicio;
-    No *seg;
+    No *ultimo = NULL;
+    size_t n = 0;
 
     while(p) {
-        seg = p->prox;
-        if (freeObj) {
+        if (freeObj && p->info) {
             (*freeObj)(p->info);
         }
-        free(p);
-        p = seg;
+        ultimo = p;
+        n++;
+        p = p->prox;
     }
+    // Os nós já estão ligados entre si, voltam ao pool de uma só vez
+    devolverCadeiaPool(&poolNos, li->inicio, ultimo, n);
     free(li);
 }
 
+// Ordenação de nós ligados
+
+/*
+ * Merge sort iterativo (bottom-up) com deteção de sequências já ordenadas, partilhado pelas listas e rankings.
+ * A pilha de sequências por fundir segue as regras do timsort, pelo que nunca passa de O(log n) entradas
+ * e não há recursão. Uma lista já ordenada é percorrida uma única vez.
+ */
+#define MAX_SEQUENCIAS_ORDENACAO 96
+
+typedef struct {
+    size_t offsetProx; // Posição do campo prox no nó
+    size_t offsetInfo; // Posição do campo passado à função de comparação
+} FormatoNo;
+
+static const FormatoNo formatoNoLista = {offsetof(No, prox), offsetof(No, info)};
+static const FormatoNo formatoNoRanking = {offsetof(NoRankings, prox), offsetof(NoRankings, compInfo)};
+
 /**
- * @brief 
+ * @brief Acesso ao campo prox de um nó
  * 
- * @param a Nó da primeira lista
- * @param b Nó da segunda lista
- * @param compObjs Função para comparar elementos (deve retornar < 0 se obj1 < obj2)
- * @return No* Lista agrupada
+ * @param f Formato do nó
+ * @param no Nó
+ * @return void** Endereço do campo prox
  */
-static No *mergeListas(No *a, No *b, int (*compObjs)(void *obj1, void *obj2)) {
-    if (!a) return b;
-    if (!b) return a;
-    
-    No *result = NULL;
-    
-    if (compObjs(a->info, b->info) <= 0) {
-        result = a;
-        result->prox = mergeListas(a->prox, b, compObjs);
-    } else {
-        result = b;
-        result->prox = mergeListas(a, b->prox, compObjs);
-    }
-    
-    return result;
+static void **proxNo(const FormatoNo *f, void *no) {
+    return (void **)((char *)no + f->offsetProx);
 }
 
 /**
- * @brief Separar a lista em duas metades
+ * @brief Obtém a informação de um nó a comparar
  * 
- * @param head Lista a separar
- * @param front Ponteiro para a primeira metade
- * @param back Ponteiro para a segunda metade
+ * @param f Formato do nó
+ * @param no Nó
+ * @return void* Informação
  */
-static void splitLista(No *head, No **front, No **back) {
-    No *rapido = head->prox;
-    No *lento = head;
-    
-    while (rapido != NULL) {
-        rapido = rapido->prox;
-        if (rapido != NULL) {
-            lento = lento->prox;
-            rapido = rapido->prox;
-        }
-    }
-    
-    *front = head;
-    *back = lento->prox;
-    lento->prox = NULL;
+static void *infoNo(const FormatoNo *f, void *no) {
+    return *(void **)((char *)no + f->offsetInfo);
 }
 
 /**
- * @brief MergeSort recursivo para os nós da função
+ * @brief Funde duas sequências ordenadas numa só, sem recursão
  * 
- * @param headRef Head da função
- * @param compObjs Função para comparar objetos
+ * @param f Formato do nó
+ * @param a Primeira sequência
+ * @param b Segunda sequência
+ * @param compObjs Função para comparar elementos (deve retornar < 0 se obj1 < obj2)
+ * @return void* Início da sequência resultante
+ * 
+ * @note Estável: em caso de empate fica primeiro o elemento de a
  */
-static void mergesortRecursivo(No **headRef, int (*compObjs)(void *obj1, void *obj2)) {
-    No *head = *headRef;
-    if (!head || !head->prox) return;
-    
-    No *a;
-    No *b;
-    
-    splitLista(head, &a, &b);
-    mergesortRecursivo(&a, compObjs);
-    mergesortRecursivo(&b, compObjs);
-    
-    *headRef = mergeListas(a, b, compObjs);
+static void *fundirSequencias(const FormatoNo *f, void *a, void *b, int (*compObjs)(void *obj1, void *obj2)) {
+    void *inicio = NULL;
+    void **cauda = &inicio;
+
+    while (a && b) {
+        if (compObjs(infoNo(f, a), infoNo(f, b)) <= 0) {
+            *cauda = a;
+            cauda = proxNo(f, a);
+            a = *cauda;
+        }
+        else {
+            *cauda = b;
+            cauda = proxNo(f, b);
+            b = *cauda;
+        }
+    }
+    *cauda = a ? a : b;
+    return inicio;
 }
 
 /**
- * @brief Ordenar lista genérica com merge sort
+ * @brief Separa a próxima sequência ordenada do início de uma cadeia de nós
  * 
- * @param li Lista a ordenar
+ * @param f Formato do nó
+ * @param cadeia Endereço do início da cadeia, avança para depois da sequência
  * @param compObjs Função para comparar elementos
+ * @param tamanho Devolve o tamanho da sequência
+ * @return void* Início da sequência (terminada em NULL)
+ * 
+ * @note Sequências estritamente decrescentes são invertidas, o que mantém a ordenação estável
  */
-void mergeSortLista(Lista* li, int (*compObjs)(void *obj1, void *obj2)) {
-    if (!li || !li->inicio || !compObjs) return;
-    // Código adaptado de https://www.geeksforgeeks.org/merge-sort-for-linked-list/
+static void *separarSequencia(const FormatoNo *f, void **cadeia, int (*compObjs)(void *obj1, void *obj2), size_t *tamanho) {
+    void *inicio = *cadeia;
+    void *atual = inicio;
+    void *seg = *proxNo(f, atual);
+    *tamanho = 1;
+
+    if (seg && compObjs(infoNo(f, atual), infoNo(f, seg)) > 0) {
+        // Decrescente: inverter à medida que se avança
+        *proxNo(f, atual) = NULL;
+        while (seg && compObjs(infoNo(f, atual), infoNo(f, seg)) > 0) {
+            void *depois = *proxNo(f, seg);
+            *proxNo(f, seg) = atual;
+            atual = seg;
+            seg = depois;
+            (*tamanho)++;
+        }
+        *cadeia = seg;
+        return atual;
+    }
 
-    mergesortRecursivo(&li->inicio, compObjs);
+    while (seg && compObjs(infoNo(f, atual), infoNo(f, seg)) <= 0) {
+        atual = seg;
+        seg = *proxNo(f, seg);
+        (*tamanho)++;
+    }
+    *proxNo(f, atual) = NULL;
+    *cadeia = seg;
+    return inicio;
 }
 
 /**
- * @brief Ordena a lista
+ * @brief Ordena uma cadeia de nós ligados
  * 
- * @param li    Lista
- * @param compObjs  Função para comparar os elementos (ordem de ordenação)
- * 
- * @note Troca os elementos obj1 com obj2 quando a função compObjs retorna 1
- */
-void ordenarLista(Lista * li, int (*compObjs)(void *obj1, void *obj2)) {
-    if (!li || li->nel < 2 || !compObjs) return;
-
-    char trocou;
-    do {
-        No *ant = NULL;
-        No *a = li->inicio; //atual
-        No *p = a->prox; //proximo
-        trocou = '0';
-        
-        while (p) {
-            if ((*compObjs)(a->info, p->info) > 0) {
-                trocou = '1'; //trocar p para a posicao de atual
-                a->prox = p->prox;
-                p->prox = a;
-
-                if (ant) ant->prox = p;
-                else li->inicio = p; //atual é o inicio
-
-                ant = p;
-                p = a->prox;
-            } else {
-                ant = a;
-                a = p;
-                p = p->prox;
+ * @param f Formato do nó
+ * @param inicio Primeiro nó
+ * @param compObjs Função para comparar elementos (deve retornar < 0 se obj1 < obj2)
+ * @return void* Primeiro nó da cadeia ordenada
+ */
+static void *ordenarNos(const FormatoNo *f, void *inicio, int (*compObjs)(void *obj1, void *obj2)) {
+    void *sequencias[MAX_SEQUENCIAS_ORDENACAO];
+    size_t tamanhos[MAX_SEQUENCIAS_ORDENACAO];
+    int n = 0;
+
+    void *resto = inicio;
+    while (resto) {
+        sequencias[n] = separarSequencia(f, &resto, compObjs, &tamanhos[n]);
+        n++;
+
+        // Manter os tamanhos da pilha a decrescer (pelo menos) como Fibonacci
+        while (n > 1) {
+            int k = n - 2;
+            if ((k > 0 && tamanhos[k - 1] <= tamanhos[k] + tamanhos[k + 1]) ||
+                (k > 1 && tamanhos[k - 2] <= tamanhos[k - 1] + tamanhos[k])) {
+                if (tamanhos[k - 1] < tamanhos[k + 1]) k--;
             }
+            else if (tamanhos[k] > tamanhos[k + 1]) {
+                break;
+            }
+            sequencias[k] = fundirSequencias(f, sequencias[k], sequencias[k + 1], compObjs);
+            tamanhos[k] += tamanhos[k + 1];
+            for (int i = k + 1; i < n - 1; i++) {
+                sequencias[i] = sequencias[i + 1];
+                tamanhos[i] = tamanhos[i + 1];
+            }
+            n--;
         }
-    } while (trocou == '1');
+    }
+
+    // Fundir o que resta, do topo para a base
+    while (n > 1) {
+        sequencias[n - 2] = fundirSequencias(f, sequencias[n - 2], sequencias[n - 1], compObjs);
+        tamanhos[n - 2] += tamanhos[n - 1];
+        n--;
+    }
+    return n ? sequencias[0] : NULL;
 }
 
+/*
+ * Versão paralela: a cadeia é cortada em tantos troços quantas as threads, cada thread ordena o seu troço
+ * com ordenarNos e os troços são depois fundidos aos pares (também em paralelo), por ordem, o que mantém
+ * a estabilidade. As threads só tocam em nós dos seus troços, por isso não há partilha nem locks.
+ */
+
+typedef struct {
+    const FormatoNo *f;
+    void *a; // Troço a ordenar, ou primeira sequência a fundir
+    void *b; // NULL para ordenar a; caso contrário, sequência a fundir com a
+    int (*compObjs)(void *obj1, void *obj2);
+    void *resultado;
+} TarefaOrdenacao;
+
 /**
- * @brief Pesquisa um código na lista dada
+ * @brief Executa uma tarefa de ordenação (ponto de entrada das threads)
  * 
- * @param li Lista onde procurar
- * @param compObjs Função para verificar se é a chave pretendida (deve retornar 0 caso seja)
- * @param chave Ponteiro para o dado a procurar
- * @return void* Fazer cast consoante o tipo de dados
+ * @param arg TarefaOrdenacao
+ * @return void* NULL
  */
-void *searchLista(Lista *li, int (*compCod)(void *codObj, void *chave), void *chave) {
-    if (!li || !li->inicio || !compCod) return NULL;
-
-    No *p = li->inicio;
-    while(p) {
-        if ((*compCod)(p->info, chave) == 0) {
-            return p->info;
-        }
-        p = p->prox;
+static void *executarTarefaOrdenacao(void *arg) {
+    TarefaOrdenacao *t = (TarefaOrdenacao *)arg;
+    if (t->b) {
+        t->resultado = fundirSequencias(t->f, t->a, t->b, t->compObjs);
+    }
+    else {
+        t->resultado = ordenarNos(t->f, t->a, t->compObjs);
     }
     return NULL;
 }
 
 /**
- * @brief Guarda o conteúdo de uma lista em ficheiro binário
+ * @brief Executa várias tarefas em simultâneo (uma thread por tarefa) e espera que todas terminem
  * 
- * @param li Lista
- * @param saveInfo Função para guardar cada elemento da lista
- * @param file Ficheiro binário aberto
+ * @param tarefa Função executada por cada thread
+ * @param args Array de argumentos, um por tarefa
+ * @param tamanhoArg Tamanho de cada argumento em bytes
+ * @param n Nº de tarefas (no máximo MAX_THREADS)
  * 
- * @note Guarda o Nº de elementos da lista primeiro
+ * @note A primeira tarefa corre na thread atual; se não for possível criar uma thread, a tarefa corre também aqui
  */
-void guardarListaBin(Lista *li, void (*saveInfo)(void *obj, FILE *fileObj), FILE *file) {
-    if (!li || !li->inicio || !file || !saveInfo) return;
+void executarEmParalelo(void *(*tarefa)(void *arg), void *args, size_t tamanhoArg, int n) {
+    if (!tarefa || !args || n < 1) return;
+    if (n > MAX_THREADS) n = MAX_THREADS;
 
-    No *p = li->inicio;
-    fwrite(&li->nel, sizeof(int), 1, file);
-    for (int i = 0; i < li->nel; i++) {
-        (*saveInfo)(p->info, file);
-        p = p->prox;
+    pthread_t threads[MAX_THREADS];
+    int criada[MAX_THREADS] = {0};
+    char *arg = (char *)args;
+
+    for (int i = 1; i < n; i++) {
+        criada[i] = pthread_create(&threads[i], NULL, tarefa, arg + i * tamanhoArg) == 0;
+    }
+    (void)tarefa(arg);
+    for (int i = 1; i < n; i++) {
+        if (criada[i]) {
+            pthread_join(threads[i], NULL);
+        }
+        else {
+            (void)tarefa(arg + i * tamanhoArg); // Alternativa sequencial
+        }
     }
 }
 
 /**
- * @brief Ler os dados binários para uma lista
+ * @brief Cria um anel SPSC (uma thread produtora, uma consumidora)
  * 
- * @param readInfo Função para ler cada elemento da lista
- * @param file Ficheiro binário
- * @return Lista* Lista com os elementos lidos ou NULL se erro
+ * @param capacidade Nº mínimo de itens (arredondado para potência de 2)
+ * @return AnelSPSC* NULL se erro
  */
-Lista *readListaBin(void *(*readInfo)(FILE *fileObj), FILE *file) {
-    if (!file || !readInfo) return NULL;
-
-    Lista *li = criarLista();
-    if (!li) return NULL;
-
-    fread(&li->nel, sizeof(int), 1, file);
-    if (li->nel < 0) {
-        free(li);
+AnelSPSC *criarAnelSPSC(size_t capacidade) {
+    size_t cap = 2;
+    while (cap < capacidade) cap <<= 1;
+
+    AnelSPSC *a = (AnelSPSC *)malloc(sizeof(AnelSPSC));
+    if (!a) return NULL;
+    a->itens = (void **)malloc(cap * sizeof(void *));
+    if (!a->itens) {
+        free(a);
         return NULL;
     }
+    a->mascara = cap - 1;
+    atomic_init(&a->cabeca, 0);
+    atomic_init(&a->cauda, 0);
+    return a;
+}
 
-    No *ant = NULL;
-    for (int i = 0; i < li->nel; i++) {
-        No *atual = (No *)malloc(sizeof(No));
-        if (!atual) {
-            freeLista(li, NULL);
-            return NULL;
-        }
-        atual->info = (*readInfo)(file);
-        atual->prox = NULL;
+/**
+ * @brief Coloca um item no anel (apenas pela thread produtora)
+ * 
+ * @param a Anel
+ * @param item Item (pode ser NULL)
+ * @return int 1 se colocou, 0 se o anel está cheio
+ */
+int colocarAnelSPSC(AnelSPSC *a, void *item) {
+    size_t cauda = atomic_load_explicit(&a->cauda, memory_order_relaxed);
+    size_t cabeca = atomic_load_explicit(&a->cabeca, memory_order_acquire);
+    if (cauda - cabeca > a->mascara) return 0;
 
-        if (!ant) {
-            li->inicio = atual;
-        }
-        else {
-            ant->prox = atual;
-        }
-        ant = atual;
-    }
-    return li;
+    a->itens[cauda & a->mascara] = item;
+    atomic_store_explicit(&a->cauda, cauda + 1, memory_order_release);
+    return 1;
 }
 
 /**
- * @brief Obter a memória ocupada por uma lista
+ * @brief Retira um item do anel (apenas pela thread consumidora)
  * 
- * @param li Lista
- * @param objMemUsage Função para determinar a memória ocupada por um elemento
- * @return size_t Memória ocupada pela lista ou 0 se erro
+ * @param a Anel
+ * @param item Devolve o item
+ * @return int 1 se retirou, 0 se o anel está vazio
  */
-size_t listaMemUsage(Lista *li, size_t (*objMemUsage)(void *obj)) {
-    if (!li) return 0;
+int retirarAnelSPSC(AnelSPSC *a, void **item) {
+    size_t cabeca = atomic_load_explicit(&a->cabeca, memory_order_relaxed);
+    size_t cauda = atomic_load_explicit(&a->cauda, memory_order_acquire);
+    if (cabeca == cauda) return 0;
 
-    size_t mem = 0;
-    mem += sizeof(*li);
+    *item = a->itens[cabeca & a->mascara];
+    atomic_store_explicit(&a->cabeca, cabeca + 1, memory_order_release);
+    return 1;
+}
+
+/**
+ * @brief Coloca um item no anel, esperando (sched_yield) enquanto estiver cheio
+ * 
+ * @param a Anel
+ * @param item Item
+ */
+void colocarAnelSPSCEspera(AnelSPSC *a, void *item) {
+    while (!colocarAnelSPSC(a, item)) {
+        sched_yield();
+    }
+}
+
+/**
+ * @brief Retira um item do anel, esperando (sched_yield) enquanto estiver vazio
+ * 
+ * @param a Anel
+ * @return void* Item
+ */
+void *retirarAnelSPSCEspera(AnelSPSC *a) {
+    void *item;
+    while (!retirarAnelSPSC(a, &item)) {
+        sched_yield();
+    }
+    return item;
+}
+
+/**
+ * @brief Liberta um anel (os itens que ainda tenha não são libertados)
+ * 
+ * @param a Anel
+ */
+void freeAnelSPSC(AnelSPSC *a) {
+    if (!a) return;
+
+    free(a->itens);
+    free(a);
+}
+
+/**
+ * @brief Ordena uma cadeia de nós ligados, em paralelo se for grande
+ * 
+ * @param f Formato do nó
+ * @param inicio Primeiro nó
+ * @param nel Nº de nós da cadeia
+ * @param compObjs Função para comparar elementos (deve retornar < 0 se obj1 < obj2)
+ * @return void* Primeiro nó da cadeia ordenada
+ * 
+ * @note Usa numThreads threads; abaixo de LIMIAR_ORDENACAO_PARALELA elementos (ou com 1 thread) é sequencial.
+ *       compObjs tem de poder ser chamada por várias threads ao mesmo tempo (não pode ter estado global)
+ */
+static void *ordenarNosParalelo(const FormatoNo *f, void *inicio, int nel, int (*compObjs)(void *obj1, void *obj2)) {
+    int nThreads = numThreads;
+    if (nThreads > MAX_THREADS) nThreads = MAX_THREADS;
+    if (nThreads > nel / (LIMIAR_ORDENACAO_PARALELA / 2)) nThreads = nel / (LIMIAR_ORDENACAO_PARALELA / 2); // Troços não demasiado pequenos
+    if (nThreads < 2 || nel < LIMIAR_ORDENACAO_PARALELA) {
+        return ordenarNos(f, inicio, compObjs);
+    }
+
+    // Cortar a cadeia em nThreads troços consecutivos
+    TarefaOrdenacao tarefas[MAX_THREADS];
+    int porTroco = (nel + nThreads - 1) / nThreads;
+    void *p = inicio;
+    int nTrocos = 0;
+    while (p && nTrocos < nThreads) {
+        tarefas[nTrocos] = (TarefaOrdenacao){f, p, NULL, compObjs, NULL};
+        nTrocos++;
+        if (nTrocos == nThreads) break; // O último troço fica com o resto (nel pode estar desatualizado)
+        for (int i = 1; i < porTroco && *proxNo(f, p); i++) {
+            p = *proxNo(f, p);
+        }
+        void *seg = *proxNo(f, p);
+        *proxNo(f, p) = NULL;
+        p = seg;
+    }
+    executarEmParalelo(executarTarefaOrdenacao, tarefas, sizeof(TarefaOrdenacao), nTrocos);
+
+    // Fundir troços vizinhos aos pares até restar um
+    void *trocos[MAX_THREADS];
+    for (int i = 0; i < nTrocos; i++) {
+        trocos[i] = tarefas[i].resultado;
+    }
+    while (nTrocos > 1) {
+        int nPares = nTrocos / 2;
+        for (int i = 0; i < nPares; i++) {
+            tarefas[i] = (TarefaOrdenacao){f, trocos[2 * i], trocos[2 * i + 1], compObjs, NULL};
+        }
+        executarEmParalelo(executarTarefaOrdenacao, tarefas, sizeof(TarefaOrdenacao), nPares);
+        for (int i = 0; i < nPares; i++) {
+            trocos[i] = tarefas[i].resultado;
+        }
+        if (nTrocos % 2) {
+            trocos[nPares] = trocos[nTrocos - 1];
+        }
+        nTrocos = nPares + nTrocos % 2;
+    }
+    return trocos[0];
+}
+
+/**
+ * @brief Ordenar lista genérica com merge sort
+ * 
+ * @param li Lista a ordenar
+ * @param compObjs Função para comparar elementos
+ * 
+ * @note Estável, iterativo e O(n) para listas já (quase) ordenadas; listas grandes são ordenadas em paralelo
+ */
+void mergeSortLista(Lista* li, int (*compObjs)(void *obj1, void *obj2)) {
+    if (!li || !li->inicio || !compObjs) return;
+
+    li->inicio = (No *)ordenarNosParalelo(&formatoNoLista, li->inicio, li->nel, compObjs);
+}
+
+/**
+ * @brief Pesquisa um código na lista dada
+ * 
+ * @param li Lista onde procurar
+ * @param compObjs Função para verificar se é a chave pretendida (deve retornar 0 caso seja)
+ * @param chave Ponteiro para o dado a procurar
+ * @return void* Fazer cast consoante o tipo de dados
+ */
+void *searchLista(Lista *li, int (*compCod)(void *codObj, void *chave), void *chave) {
+    if (!li || !li->inicio || !compCod) return NULL;
+
+    No *p = li->inicio;
+    while(p) {
+        if ((*compCod)(p->info, chave) == 0) {
+            return p->info;
+        }
+        p = p->prox;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Guarda o conteúdo de uma lista em ficheiro binário
+ * 
+ * @param li Lista
+ * @param saveInfo Função para guardar cada elemento da lista
+ * @param file Ficheiro binário aberto
+ * 
+ * @note Guarda o Nº de elementos da lista primeiro
+ */
+void guardarListaBin(Lista *li, void (*saveInfo)(void *obj, FILE *fileObj), FILE *file) {
+    if (!li || !li->inicio || !file || !saveInfo) return;
+
+    No *p = li->inicio;
+    fwrite(&li->nel, sizeof(int), 1, file);
+    for (int i = 0; i < li->nel; i++) {
+        (*saveInfo)(p->info, file);
+        p = p->prox;
+    }
+}
+
+/**
+ * @brief Ler os dados binários para uma lista
+ * 
+ * @param readInfo Função para ler cada elemento da lista
+ * @param file Ficheiro binário
+ * @return Lista* Lista com os elementos lidos ou NULL se erro
+ */
+Lista *readListaBin(void *(*readInfo)(FILE *fileObj), FILE *file) {
+    if (!file || !readInfo) return NULL;
+
+    Lista *li = criarLista();
+    if (!li) return NULL;
+
+    fread(&li->nel, sizeof(int), 1, file);
+    if (li->nel < 0) {
+        free(li);
+        return NULL;
+    }
+
+    No *ant = NULL;
+    for (int i = 0; i < li->nel; i++) {
+        No *atual = (No *)alocarNoPool(&poolNos);
+        if (!atual) {
+            freeLista(li, NULL);
+            return NULL;
+        }
+        atual->info = (*readInfo)(file);
+        atual->prox = NULL;
+
+        if (!ant) {
+            li->inicio = atual;
+        }
+        else {
+            ant->prox = atual;
+        }
+        ant = atual;
+    }
+    return li;
+}
+
+/**
+ * @brief Obter a memória ocupada por uma lista
+ * 
+ * @param li Lista
+ * @param objMemUsage Função para determinar a memória ocupada por um elemento
+ * @return size_t Memória ocupada pela lista ou 0 se erro
+ */
+size_t listaMemUsage(Lista *li, size_t (*objMemUsage)(void *obj)) {
+    if (!li) return 0;
+
+    size_t mem = 0;
+    mem += sizeof(*li);
 
     No *p = li->inicio;
     while(p) {
@@ -483,40 +1143,240 @@ size_t listaMemUsage(Lista *li, size_t (*objMemUsage)(void *obj)) {
 // Hashing/Dicts
 
 /**
- * @brief Cria um dicionário/hashing
+ * @brief Espalha os bits do hash devolvido pelas funções de hash
+ * 
+ * @param hash Hash (não negativo)
+ * @return unsigned int Hash misturado
  * 
+ * @note Necessário porque a capacidade é potência de 2 e as chaves inteiras (NIF, código) são usadas diretamente como hash
+ */
+static unsigned int misturarHash(int hash) {
+    unsigned int h = (unsigned int)hash;
+
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+
+    return h;
+}
+
+/**
+ * @brief Obtém o índice inicial de sondagem para um dado hash
+ * 
+ * @param has Dicionário
+ * @param hash Hash misturado da chave
+ * @return int Índice na tabela
+ */
+static int indiceDict(Dict *has, unsigned int hash) {
+    return (int)(hash & (unsigned int)(has->capacidade - 1));
+}
+
+/**
+ * @brief Obtém a capacidade necessária para guardar nel chaves sem exceder CARGA_MAXIMA_DICT
+ * 
+ * @param nel Número de chaves
+ * @return int Capacidade (potência de 2, no máximo CAPACIDADE_MAXIMA_DICT)
+ */
+static int capacidadeParaDict(long nel) {
+    long capacidade = CAPACIDADE_INICIAL_DICT;
+    while (capacidade < CAPACIDADE_MAXIMA_DICT && nel * 100 > capacidade * CARGA_MAXIMA_DICT) {
+        capacidade *= 2;
+    }
+    return (int)capacidade;
+}
+
+/**
+ * @brief Cria um dicionário com uma dada capacidade
+ * 
+ * @param capacidade Capacidade (potência de 2)
+ * @param chaveUnica DICT_MULTIPLO ou DICT_CHAVE_UNICA
+ * @param tamanhoChave CHAVE_ALOCADA ou tamanho da chave inline
  * @return Dict* NULL em caso de erro
  */
-Dict *criarDict() {
+static Dict *criarDictCapacidade(int capacidade, int chaveUnica, int tamanhoChave) {
+    if (tamanhoChave < 0 || tamanhoChave > TAMANHO_MAX_CHAVE_INLINE) return NULL;
+
     Dict *has = (Dict *)malloc(sizeof(Dict));
     if (!has) return NULL;
-    for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-        has->tabela[i] = NULL;
+
+    has->tabela = (NoHashing *)calloc(capacidade, sizeof(NoHashing));
+    if (!has->tabela) {
+        free(has);
+        return NULL;
     }
+    has->capacidade = capacidade;
     has->nelDict = 0;
+    has->chaveUnica = chaveUnica;
+    has->tamanhoChave = tamanhoChave;
     return has;
 }
 
 /**
- * @brief Obtém o nó de inserção de um elemento
+ * @brief Obtém a chave guardada num nó
+ * 
+ * @param has Dicionário
+ * @param p Nó
+ * @return void* Chave
+ */
+static void *chaveNo(Dict *has, NoHashing *p) {
+    return has->tamanhoChave ? (void *)p->chaveInline : p->chave;
+}
+
+/**
+ * @brief Guarda a chave num nó
+ * 
+ * @param has Dicionário
+ * @param p Nó
+ * @param chave Chave devolvida por criarChave
+ * 
+ * @note Chaves inline são copiadas para o nó, as restantes passam a pertencer ao dicionário
+ */
+static void colocarChaveNo(Dict *has, NoHashing *p, void *chave) {
+    if (has->tamanhoChave) memcpy(p->chaveInline, chave, has->tamanhoChave);
+    else p->chave = chave;
+}
+
+/**
+ * @brief Liberta uma chave criada por criarChave que não chegou a ser guardada
+ * 
+ * @param has Dicionário
+ * @param chave Chave
+ * @param freeChave Função para libertar a chave
+ */
+static void descartarChave(Dict *has, void *chave, void (*freeChave)(void *chave)) {
+    if (!has->tamanhoChave && freeChave) freeChave(chave);
+}
+
+/**
+ * @brief Cria um dicionário/hashing
+ * 
+ * @param chaveUnica DICT_MULTIPLO (cada chave guarda uma lista) ou DICT_CHAVE_UNICA (cada chave guarda o próprio elemento)
+ * @param tamanhoChave CHAVE_ALOCADA ou tamanho (em bytes, até TAMANHO_MAX_CHAVE_INLINE) de uma chave de tamanho fixo
+ * @return Dict* NULL em caso de erro
+ * 
+ * @note Num DICT_CHAVE_UNICA não existem listas: não é alocado um Lista/No por elemento
+ * @note Com chaves inline, criarChave deve devolver um ponteiro para a chave dentro do elemento (não alocado),
+ *       os bytes são copiados para o nó e freeChave nunca é chamada
+ */
+Dict *criarDict(int chaveUnica, int tamanhoChave) {
+    return criarDictCapacidade(CAPACIDADE_INICIAL_DICT, chaveUnica, tamanhoChave);
+}
+
+/**
+ * @brief Obtém a primeira posição livre a partir de um índice
  * 
  * @param has Dicionário
- * @param indice Índice na tabela hash
- * @param obj Elemento
+ * @param indice Índice inicial
+ * @return int Índice da posição livre
+ * 
+ * @note A tabela nunca está cheia (ver CARGA_MAXIMA_DICT)
+ */
+static int posicaoLivre(Dict *has, int indice) {
+    int mascara = has->capacidade - 1;
+
+    while (has->tabela[indice].dados) {
+        indice = (indice + 1) & mascara;
+    }
+    return indice;
+}
+
+/**
+ * @brief Muda a capacidade do dicionário e reposiciona as entradas
+ * 
+ * @param has Dicionário
+ * @param capacidade Nova capacidade (potência de 2)
+ * @return int 0 se erro, 1 se sucesso
+ * 
+ * @note Usa o hash guardado em cada nó, sem voltar a chamar hashChave
+ */
+static int redimensionarDict(Dict *has, int capacidade) {
+    int capacidadeAntiga = has->capacidade;
+    NoHashing *tabelaAntiga = has->tabela;
+
+    NoHashing *nova = (NoHashing *)calloc(capacidade, sizeof(NoHashing));
+    if (!nova) return 0;
+
+    has->tabela = nova;
+    has->capacidade = capacidade;
+
+    for (int i = 0; i < capacidadeAntiga; i++) {
+        if (!tabelaAntiga[i].dados) continue;
+
+        int indice = posicaoLivre(has, indiceDict(has, tabelaAntiga[i].hash));
+        has->tabela[indice] = tabelaAntiga[i];
+    }
+    free(tabelaAntiga);
+    return 1;
+}
+
+/**
+ * @brief Duplica a tabela se mais uma chave passar CARGA_MAXIMA_DICT
+ * 
+ * @param has Dicionário
+ * @return int 0 se erro (sem memória ou a tabela já tem CAPACIDADE_MAXIMA_DICT), 1 se há espaço
+ */
+static int espacoParaNovaChave(Dict *has) {
+    if ((long)(has->nelDict + 1) * 100 <= (long)has->capacidade * CARGA_MAXIMA_DICT) return 1;
+    if (has->capacidade >= CAPACIDADE_MAXIMA_DICT) return 0;
+
+    return redimensionarDict(has, has->capacidade * 2);
+}
+
+/**
+ * @brief Garante capacidade para um dado número de chaves, evitando redimensionamentos sucessivos
+ * 
+ * @param has Dicionário
+ * @param nel Número total de chaves previsto
+ * @return int 0 se erro, 1 se sucesso
+ */
+int reservarDict(Dict *has, int nel) {
+    if (!has || nel < 0) return 0;
+
+    int capacidade = capacidadeParaDict(nel);
+    if (capacidade <= has->capacidade) return 1;
+
+    return redimensionarDict(has, capacidade);
+}
+
+/**
+ * @brief Ocupa uma posição livre com uma nova chave
+ * 
+ * @param has Dicionário
+ * @param hash Hash misturado da chave
+ * @param chave Chave devolvida por criarChave
+ * @return NoHashing* Nó ocupado (dados/obj devem ser preenchidos por quem chama)
+ */
+static NoHashing *ocuparPosicao(Dict *has, unsigned int hash, void *chave) {
+    NoHashing *p = &has->tabela[posicaoLivre(has, indiceDict(has, hash))];
+
+    colocarChaveNo(has, p, chave);
+    p->hash = hash;
+    has->nelDict++;
+    return p;
+}
+
+/**
+ * @brief Obtém o nó de uma chave
+ * 
+ * @param has Dicionário
+ * @param hash Hash misturado da chave
+ * @param chave Chave
  * @param compChave Função para comparar a chave (deve retornar 0 se iguais)
  * @return NoHashing* de inserção ou NULL se erro ou essa chave ainda não existe
+ * 
+ * @note compChave só é chamada quando o hash guardado no nó coincide
  */
-NoHashing *posicaoInsercao(Dict *has, int indice, void *chave, int (*compChave)(void *chave, void *chave2)) {
-    if (!has || !chave || !compChave || indice < 0 || indice >= TAMANHO_TABELA_HASH) return NULL;
+NoHashing *posicaoInsercao(Dict *has, unsigned int hash, void *chave, int (*compChave)(void *chave, void *chave2)) {
+    if (!has || !chave || !compChave) return NULL;
     
-    if (has->tabela[indice]) {
-        NoHashing *p = has->tabela[indice];
-    
-        while(p) {
-            if ((*compChave)(p->chave, chave) == 0)
-                return p;
-            p = p->prox;
-        }
+    int mascara = has->capacidade - 1;
+    int indice = indiceDict(has, hash);
+    while (has->tabela[indice].dados) {
+        if (has->tabela[indice].hash == hash && (*compChave)(chaveNo(has, &has->tabela[indice]), chave) == 0)
+            return &has->tabela[indice];
+        indice = (indice + 1) & mascara;
     }
     return NULL;
 }
@@ -529,16 +1389,16 @@ NoHashing *posicaoInsercao(Dict *has, int indice, void *chave, int (*compChave)(
  * @param compChave Função para comparar chaves (deve retornar 0 se iguais)
  * @param hashChave Função para obter o hash da chave
  * @return Lista* Lista ou NULL se erro
+ * 
+ * @note Não se aplica a um DICT_CHAVE_UNICA (usar searchDict)
  */
 Lista *obterListaDoDict(Dict *has, void *chave, int (*compChave)(void *chave, void *chave2), int (*hashChave)(void *obj)) {
-    if (!has || !chave || !compChave || !hashChave) return NULL;
+    if (!has || has->chaveUnica || !chave || !compChave || !hashChave) return NULL;
 
-    int indice = hashChave(chave);
-    if (indice < 0) return NULL;
+    int hash = hashChave(chave);
+    if (hash < 0) return NULL;
 
-    indice %= TAMANHO_TABELA_HASH;
-
-    NoHashing *p = posicaoInsercao(has, indice, chave, compChave);
+    NoHashing *p = posicaoInsercao(has, misturarHash(hash), chave, compChave);
 
     if (p) {
         return p->dados;
@@ -555,53 +1415,140 @@ Lista *obterListaDoDict(Dict *has, void *chave, int (*compChave)(void *chave, vo
  * @param criarChave Função para criar uma chave
  * @param hashChave Função para obter o hash da chave
  * @param freeObj Função para libertar o objeto (pode ser NULL caso se queira ignorar)
- * @param freeChave Função para libertar a chave
+ * @param freeChave Função para libertar a chave (pode ser NULL com chaves inline)
  * @return int 0 se erro, 1 se sucesso
+ * 
+ * @note A tabela duplica de tamanho quando a ocupação ultrapassa CARGA_MAXIMA_DICT
+ * @note Num DICT_CHAVE_UNICA, inserir uma chave já existente é um erro
  */
 int appendToDict(Dict *has, void *obj, int (*compChave)(void *chave, void *obj), void *(*criarChave)(void *obj), int (*hashChave)(void *obj), void (*freeObj)(void *obj), void (*freeChave)(void *chave)) {
-    if (!has || !obj || !compChave || !criarChave || !hashChave || !freeChave) return 0;
+    if (!has || !obj || !compChave || !criarChave || !hashChave || (!has->tamanhoChave && !freeChave)) return 0;
     
     void *chave = criarChave(obj);
     if (!chave) return 0;
 
-    int indice = hashChave(chave);
-    if (indice < 0) return 0;
-    
-    indice %= TAMANHO_TABELA_HASH;
+    int hashChaveObj = hashChave(chave);
+    if (hashChaveObj < 0) {
+        descartarChave(has, chave, freeChave);
+        return 0;
+    }
+    unsigned int hash = misturarHash(hashChaveObj);
 
-    NoHashing *p = posicaoInsercao(has, indice, chave, compChave);
+    NoHashing *p = posicaoInsercao(has, hash, chave, compChave);
 
     if (p) {
-        freeChave(chave); // A chave já não é necessária
+        descartarChave(has, chave, freeChave); // A chave já não é necessária
+        if (has->chaveUnica) return 0;
         return addInicioLista(p->dados, obj);
     }
 
     // Criar nova entrada
-    NoHashing *novo = (NoHashing *)malloc(sizeof(NoHashing));
-    if (!novo) return 0;
-    
-    novo->dados = criarLista();
-    if (!novo->dados) {
-        free(novo);
+    if (!espacoParaNovaChave(has)) {
+        descartarChave(has, chave, freeChave);
         return 0;
     }
-    novo->chave = chave;
-    
-    if (!addInicioLista(novo->dados, obj)) {
-        freeChave(novo->chave);
-        freeLista(novo->dados, freeObj);
-        free(novo);
+
+    if (has->chaveUnica) {
+        ocuparPosicao(has, hash, chave)->obj = obj;
+        return 1;
+    }
+
+    Lista *dados = criarLista();
+    if (!dados) {
+        descartarChave(has, chave, freeChave);
         return 0;
     }
-    novo->prox = NULL;
     
-    novo->prox = has->tabela[indice];
-    has->tabela[indice] = novo;
-    has->nelDict++;
+    if (!addInicioLista(dados, obj)) {
+        descartarChave(has, chave, freeChave);
+        freeLista(dados, freeObj);
+        return 0;
+    }
+
+    ocuparPosicao(has, hash, chave)->dados = dados;
     
     return 1;
 }
 
+/**
+ * @brief Liberta uma posição da tabela, puxando para trás as entradas seguintes da mesma sequência de sondagem
+ * 
+ * @param has Dicionário
+ * @param indice Índice da posição a libertar
+ * 
+ * @note Sem marcas de posição apagada: uma entrada só recua se a sua posição inicial não ficar depois da posição livre
+ */
+static void libertarPosicao(Dict *has, int indice) {
+    int mascara = has->capacidade - 1;
+    int livre = indice;
+
+    memset(&has->tabela[livre], 0, sizeof(NoHashing));
+    for (int i = (livre + 1) & mascara; has->tabela[i].dados; i = (i + 1) & mascara) {
+        int inicial = indiceDict(has, has->tabela[i].hash);
+        if (((i - inicial) & mascara) >= ((i - livre) & mascara)) {
+            has->tabela[livre] = has->tabela[i];
+            memset(&has->tabela[i], 0, sizeof(NoHashing));
+            livre = i;
+        }
+    }
+    has->nelDict--;
+}
+
+/**
+ * @brief Remove um elemento do dicionário (o contrário de appendToDict)
+ * 
+ * @param has Dicionário
+ * @param obj Elemento a remover (comparado pelo endereço)
+ * @param compChave Função para comparar as chaves (deve retornar 0 se iguais)
+ * @param criarChave Função para criar a chave do elemento
+ * @param hashChave Função para obter o hash da chave
+ * @param freeChave Função para libertar a chave (pode ser NULL com chaves inline)
+ * @return int 1 se foi removido, 0 se não existe no dicionário ou erro
+ * 
+ * @note O elemento não é libertado. Num DICT_MULTIPLO, a chave só desaparece quando a sua lista fica vazia
+ */
+int removeFromDict(Dict *has, void *obj, int (*compChave)(void *chave, void *obj), void *(*criarChave)(void *obj), int (*hashChave)(void *obj), void (*freeChave)(void *chave)) {
+    if (!has || !obj || !compChave || !criarChave || !hashChave || (!has->tamanhoChave && !freeChave)) return 0;
+
+    void *chave = criarChave(obj);
+    if (!chave) return 0;
+
+    int hashChaveObj = hashChave(chave);
+    NoHashing *p = (hashChaveObj < 0) ? NULL : posicaoInsercao(has, misturarHash(hashChaveObj), chave, compChave);
+    descartarChave(has, chave, freeChave);
+    if (!p) return 0;
+
+    if (has->chaveUnica) {
+        if (p->obj != obj) return 0;
+    }
+    else {
+        if (!removerDaLista(p->dados, obj)) return 0;
+        if (p->dados->nel > 0) return 1;
+        freeLista(p->dados, NULL);
+    }
+    if (!has->tamanhoChave) freeChave(p->chave);
+    libertarPosicao(has, (int)(p - has->tabela));
+    return 1;
+}
+
+/**
+ * @brief Obtém o índice a partir do qual restam menos de n elementos no dicionário
+ * 
+ * @param has Dicionário
+ * @param n Número de elementos
+ * @return int Índice na tabela
+ */
+static int indiceUltimosElementos(Dict *has, int n) {
+    int nel = 0;
+    int i = has->capacidade - 1;
+    for (; i > 0 && nel < n; i--) {
+        if (has->tabela[i].dados) {
+            nel += has->chaveUnica ? 1 : has->tabela[i].dados->nel;
+        }
+    }
+    return i + 2; // avançar até ao próximo elemento, de modo a ficar com menos de n elementos
+}
+
 /**
  * @brief Mostra todos os elementos do dicionário
  * 
@@ -617,74 +1564,46 @@ void printDict(Dict *has, void (*printObj)(void *obj, FILE *file),FILE *file, in
     listagemFlag = 0;
     printingDict = 1;
 
-    for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-        NoHashing *p = has->tabela[i];
-        while (p) {
+    for (int i = 0; i < has->capacidade; i++) {
+        NoHashing *p = &has->tabela[i];
+        if (!p->dados) continue;
+
+        if (has->chaveUnica) {
+            printObj(p->obj, file);
+            if (file == stdout) printf("\n");
+        }
+        else {
             printLista(p->dados, printObj, file, pausa);
-            if (listagemFlag == 1) {
-                listagemFlag = 0;
-                return;
-            }
-            if (listagemFlag == -1) {
-                int nel = 0;
-                for (int j = TAMANHO_TABELA_HASH - 1; j > 0 && nel < pausa; j--) {
-                    NoHashing *k = has->tabela[j];
-                    while(k) {
-                        if (k->dados) {
-                            nel += k->dados->nel;
-                        }
-                        k = k->prox;
-                    }
-                    i = j;
-                }
-                i++; // avançar até ao próximo elemento, de modo a ficar com menos de pausa elementos
-                p = has->tabela[i];
-                // Ecnontrar p não nulo
-                while(!p) {
-                    i++;
-                    p = has->tabela[i];
-                }
-            }
-            p = p->prox;
+        }
+        if (listagemFlag == 1) {
+            listagemFlag = 0;
+            return;
+        }
+        if (listagemFlag == -1) {
+            i = indiceUltimosElementos(has, pausa) - 1;
+            continue;
+        }
 
-            if (file == stdout && pausa) {
-                count++;
-                if (count % pausa == 0) {
-                    printf("\n");
-                    int opcao = enter_espaco_esc();
-                    switch (opcao) {
-                        case 0:
-                            break;
-                        case 1:
-                            int nel = 0;
-                            for (int j = TAMANHO_TABELA_HASH - 1; j > 0 && nel < pausa; j--) {
-                                NoHashing *k = has->tabela[j];
-                                while(k) {
-                                    if (k->dados) {
-                                        nel += k->dados->nel;
-                                    }
-                                    k = k->prox;
-                                }
-                                i = j;
-                            }
-                            i++; // avançar até ao próximo elemento, de modo a ficar com menos de pausa elementos
-                            p = has->tabela[i];
-                            // Encontrar p não nulo
-                            while(!p) {
-                                i++;
-                                p = has->tabela[i];
-                            }
-                            break;
-                        case 2:
-                            return;
-                        default:
-                            break;
-                    }
+        if (file == stdout && pausa) {
+            count++;
+            if (count % pausa == 0) {
+                printf("\n");
+                int opcao = enter_espaco_esc();
+                switch (opcao) {
+                    case 0:
+                        break;
+                    case 1:
+                        i = indiceUltimosElementos(has, pausa) - 1;
+                        break;
+                    case 2:
+                        return;
+                    default:
+                        break;
                 }
             }
-
-            if (file == stdout) printf("\n");
         }
+
+        if (file == stdout) printf("\n");
     }
     printingDict = 0;
 }
@@ -706,13 +1625,13 @@ void exportarDictXML(Dict *has, char *nomeDict, void (*printObj)(void *obj, int
         fprintf(file, "<%s>\n", nomeDict);
     }
 
-    for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-        NoHashing *p = has->tabela[i];
-        while(p) {
-            if (nomeDict) exportarListaXML(p->dados, NULL, printObj, indentacao + 1, file);
-            else exportarListaXML(p->dados, NULL, printObj, indentacao, file);
-            p = p->prox;
-        }
+    for (int i = 0; i < has->capacidade; i++) {
+        NoHashing *p = &has->tabela[i];
+        if (!p->dados) continue;
+
+        int ind = nomeDict ? indentacao + 1 : indentacao;
+        if (has->chaveUnica) printObj(p->obj, ind, file);
+        else exportarListaXML(p->dados, NULL, printObj, ind, file);
     }
 
     if (nomeDict) {
@@ -733,12 +1652,12 @@ void exportarDictCSV(Dict *has, void (*printHeader)(FILE *file), void (*printObj
 
     printHeader(file);
 
-    for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-        NoHashing *p = has->tabela[i];
-        while(p) {
-            exportarListaCSV(p->dados, NULL, printObj, file);
-            p = p->prox;
-        }
+    for (int i = 0; i < has->capacidade; i++) {
+        NoHashing *p = &has->tabela[i];
+        if (!p->dados) continue;
+
+        if (has->chaveUnica) printObj(p->obj, file);
+        else exportarListaCSV(p->dados, NULL, printObj, file);
     }
 }
 
@@ -781,15 +1700,19 @@ void exportarDictHTML(Dict *has, char *pagename, void (*printTableHead)(FILE *fi
     (*printTableHead)(file);
     fprintf(file, "\t\t\t\t<tbody>\n");
 
-    for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-        NoHashing *p = has->tabela[i];
-        while(p) {
-            No *n = p->dados->inicio;
-            while(n) {
-                printObj(n->info, file);
-                n = n->prox;
-            }
-            p = p->prox;
+    for (int i = 0; i < has->capacidade; i++) {
+        NoHashing *p = &has->tabela[i];
+        if (!p->dados) continue;
+
+        if (has->chaveUnica) {
+            printObj(p->obj, file);
+            continue;
+        }
+
+        No *n = p->dados->inicio;
+        while(n) {
+            printObj(n->info, file);
+            n = n->prox;
         }
     }
 
@@ -810,20 +1733,24 @@ void exportarDictHTML(Dict *has, char *pagename, void (*printTableHead)(FILE *fi
  * @param freeObj Função para libertar a memória de cada elemento
  * 
  * @note freeObj pode ser passada como NULL para ignorar a libertação de cada elemento da lista
+ * @note freeChave pode ser NULL com chaves inline
  */
 void freeDict(Dict *has, void (*freeChave)(void *chave), void (*freeObj)(void *obj)) {
-    if (!has || !freeChave) return;
+    if (!has || (!has->tamanhoChave && !freeChave)) return;
 
-    for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-        NoHashing *p = has->tabela[i];
-        while (p) {
-            NoHashing *temp = p;
-            p = p->prox;
-            freeChave(temp->chave);
-            freeLista(temp->dados, freeObj);
-            free(temp);
+    for (int i = 0; i < has->capacidade; i++) {
+        NoHashing *p = &has->tabela[i];
+        if (!p->dados) continue;
+
+        if (!has->tamanhoChave) freeChave(p->chave);
+        if (has->chaveUnica) {
+            if (freeObj) freeObj(p->obj);
+        }
+        else {
+            freeLista(p->dados, freeObj);
         }
     }
+    free(has->tabela);
     free(has);
 }
 
@@ -836,20 +1763,19 @@ void freeDict(Dict *has, void (*freeChave)(void *chave), void (*freeObj)(void *o
  * @param compCod Função para comparar a chave com o elemento da lista
  * @param hashChave Função para obter o hash da chave
  * @return void* ou NULL se erro
+ * 
+ * @note Num DICT_CHAVE_UNICA o elemento é devolvido diretamente (compCod não é usado)
  */
 void *searchDict(Dict *has, void *chave, int (*compChave)(void *chave, void *obj), int (*compCod)(void *codObj, void *chave), int (*hashChave)(void *chave)) {
     if (!has || !chave || !compChave|| !compCod || !hashChave) return NULL;
 
-    int indice = hashChave(chave);
-    if (indice < 0) return NULL;
-    
-    indice %= TAMANHO_TABELA_HASH;
+    int hash = hashChave(chave);
+    if (hash < 0) return NULL;
 
-    NoHashing *p = has->tabela[indice];
-    while (p) {
-        if (compChave(p->chave, chave) == 0)
-            return searchLista(p->dados, compCod, chave);
-        p = p->prox;
+    NoHashing *p = posicaoInsercao(has, misturarHash(hash), chave, compChave);
+    if (p) {
+        if (has->chaveUnica) return p->obj;
+        return searchLista(p->dados, compCod, chave);
     }
 
     return NULL;
@@ -868,141 +1794,650 @@ void guardarDadosDictBin(Dict *has, void (*saveInfo)(void *obj, FILE *fileObj),
 
     fwrite(&has->nelDict, sizeof(int), 1, file);
 
-    for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-        NoHashing *p = has->tabela[i];
-        while (p) {
+    for (int i = 0; i < has->capacidade; i++) {
+        NoHashing *p = &has->tabela[i];
+        if (!p->dados) continue;
+
+        if (has->chaveUnica) {
+            // Mesmo formato que uma lista de 1 elemento
+            int nel = 1;
+            fwrite(&nel, sizeof(int), 1, file);
+            saveInfo(p->obj, file);
+        }
+        else {
             guardarListaBin(p->dados, saveInfo, file);
-            p = p->prox;
         }
     }
 }
 
 /**
- * @brief Lê os dados de um ficheiro binário para um dicionário
+ * @brief Nº de bytes entre a posição atual e o fim de um ficheiro
+ * 
+ * @param file Ficheiro binário, aberto
+ * @return long Bytes por ler, -1 se erro (a posição fica como estava)
+ */
+static long bytesRestantesFicheiro(FILE *file) {
+    long atual = ftell(file);
+    if (atual < 0 || fseek(file, 0, SEEK_END) != 0) return -1;
+
+    long fim = ftell(file);
+    if (fseek(file, atual, SEEK_SET) != 0 || fim < atual) return -1;
+    return fim - atual;
+}
+
+/**
+ * @brief Lê os dados de um ficheiro binário para um dicionário
+ * 
+ * @param chaveUnica DICT_MULTIPLO ou DICT_CHAVE_UNICA
+ * @param tamanhoChave CHAVE_ALOCADA ou tamanho da chave inline
+ * @param compChave Função para comparar a chave (deve retornar 0 se igual)
+ * @param criarChave Função para criar a chave
+ * @param hashChave Função para obter o hash da chave
+ * @param freeObj Função para libertar a memória ocupada por um objeto
+ * @param freeChave Função para libertar a memória ocupada por uma chave (pode ser NULL com chaves inline)
+ * @param readInfo Função para ler um elemento do ficheiro binário
+ * @param file Ficheiro binário, aberto
+ * @return Dict* Dicionário com os dados ou NULL se erro
+ * 
+ * @note A tabela é criada logo com a capacidade final (até RESERVA_MAXIMA_DICT_BIN chaves, depois cresce). Um nº de
+ *       chaves que não cabe no resto do ficheiro é rejeitado antes de alocar o que quer que seja
+ */
+Dict *readToDictBin(int chaveUnica, int tamanhoChave, void *(*criarChave)(void *obj), int (*hashChave)(void *obj), void (*freeObj)(void *obj),
+                        void (*freeChave)(void *chave), void *(*readInfo)(FILE *fileObj), FILE *file) {
+    if (!file || !readInfo || (!tamanhoChave && !freeChave) || !freeObj || !hashChave || !criarChave) return NULL;
+
+    // NEL Dict
+    int nelDict = 0;
+    if (fread(&nelDict, sizeof(int), 1, file) != 1 || nelDict < 0) return NULL;
+    // Cada chave ocupa pelo menos o nº de elementos da sua lista
+    long restante = bytesRestantesFicheiro(file);
+    if (restante < 0 || (long)nelDict > restante / (long)sizeof(int)) return NULL;
+
+    long reserva = (nelDict < RESERVA_MAXIMA_DICT_BIN) ? nelDict : RESERVA_MAXIMA_DICT_BIN;
+    Dict *has = criarDictCapacidade(capacidadeParaDict(reserva), chaveUnica, tamanhoChave);
+    if (!has) return NULL;
+
+    Lista *lista = NULL;
+    for (int i = 0; i < nelDict; i++) {
+        // Ler a lista guardada
+        lista = readListaBin(readInfo, file);
+        if (!lista || !lista->inicio || !lista->inicio->info || (chaveUnica && lista->nel != 1)) {
+            if (lista) freeLista(lista, freeObj);
+            freeDict(has, freeChave, freeObj);
+            return NULL;
+        }
+
+        // O primeiro elemento cria a chave e obtém o índice
+        void *primeiroObj = lista->inicio->info;
+        void *chave = criarChave(primeiroObj);
+        int hash = chave ? hashChave(chave) : -1;
+        if (hash < 0) {
+            if (chave) descartarChave(has, chave, freeChave);
+            freeLista(lista, freeObj);
+            freeDict(has, freeChave, freeObj);
+            return NULL;
+        }
+
+        // Colocar a entrada na tabela
+        if (!espacoParaNovaChave(has)) {
+            descartarChave(has, chave, freeChave);
+            freeLista(lista, freeObj);
+            freeDict(has, freeChave, freeObj);
+            return NULL;
+        }
+        NoHashing *p = ocuparPosicao(has, misturarHash(hash), chave);
+        if (chaveUnica) {
+            p->obj = primeiroObj;
+            freeLista(lista, NULL);
+        }
+        else {
+            p->dados = lista;
+        }
+    }
+
+    return has;
+}
+
+/**
+ * @brief Obtém a memória utilizada por um dicionário
+ * 
+ * @param has Dicionário
+ * @param objMemUsage Função para obter a memória ocupada por cada elemento
+ * @param chaveMemUsage Função para obter a memória ocupada pela chave (ignorada com chaves inline)
+ * @return size_t Memória ocupada ou 0 se erro
+ */
+size_t dictMemUsage(Dict *has, size_t (*objMemUsage)(void *obj), size_t (*chaveMemUsage)(void *chave)) {
+    if (!has) return 0;
+
+    size_t mem = 0;
+    mem += sizeof(*has); //ptr + capacidade + nel
+    mem += has->capacidade * sizeof(NoHashing); // Tabela
+
+    for (int i = 0; i < has->capacidade; i++) {
+        NoHashing *p = &has->tabela[i];
+        if (!p->dados) continue;
+
+        if (chaveMemUsage && !has->tamanhoChave) {
+            mem += chaveMemUsage(p->chave);
+        }
+        if (has->chaveUnica) {
+            if (objMemUsage) mem += objMemUsage(p->obj);
+        }
+        else {
+            mem += listaMemUsage(p->dados, objMemUsage);
+        }
+    }
+
+    return mem;
+}
+
+/**
+ * @brief Adiciona todos os elementos de um dicionário a uma lista
+ * 
+ * @param has Dicionário
+ * @return Lista* Lista ou NULL se erro
+ */
+Lista *dictToLista(Dict *has) {
+    if (!has) return NULL;
+
+    Lista *li = criarLista();
+    if (!li) return NULL;
+
+    for (int i = 0; i < has->capacidade; i++) {
+        NoHashing *p = &has->tabela[i];
+        if (!p->dados) continue;
+
+        if (has->chaveUnica) {
+            addInicioLista(li, p->obj);
+            continue;
+        }
+
+        No *x = p->dados->inicio;
+        while(x) {
+            addInicioLista(li, x->info);
+
+            x = x->prox;
+        }
+    }
+
+    return li;
+}
+
+/**
+ * @brief Copia os ponteiros de todos os elementos de um dicionário para um array contíguo
+ * 
+ * @param has Dicionário
+ * @param nel Devolve o número de elementos do array
+ * @return void** Array (libertar com free(), os elementos não são copiados) ou NULL se erro
+ */
+void **dictToArray(Dict *has, int *nel) {
+    if (!has || !nel) return NULL;
+
+    int total = 0;
+    if (has->chaveUnica) {
+        total = has->nelDict;
+    }
+    else {
+        for (int i = 0; i < has->capacidade; i++) {
+            if (has->tabela[i].dados) total += has->tabela[i].dados->nel;
+        }
+    }
+
+    void **arr = (void **)malloc(sizeof(void *) * (total > 0 ? total : 1));
+    if (!arr) return NULL;
+
+    int n = 0;
+    for (int i = 0; i < has->capacidade; i++) {
+        NoHashing *p = &has->tabela[i];
+        if (!p->dados) continue;
+
+        if (has->chaveUnica) {
+            arr[n++] = p->obj;
+            continue;
+        }
+        for (No *x = p->dados->inicio; x; x = x->prox) {
+            arr[n++] = x->info;
+        }
+    }
+    *nel = n;
+    return arr;
+}
+
+// Arrays
+
+/**
+ * @brief Mostra todos os elementos de um array
+ * 
+ * @param arr Array
+ * @param nel Número de elementos
+ * @param printObj Função para mostrar o elemento
+ * @param file Ficheiro
+ * @param pausa Elementos por página (0 para não pausar)
+ * 
+ * @note Mesmo comportamento de printLista, mas o salto para o fim é direto
+ */
+void printArray(void **arr, int nel, void (*printObj)(void *obj, FILE *file), FILE *file, int pausa) {
+    if (!arr || !printObj || !file || pausa < 0) return;
+
+    int noStop = 1;
+    listagemFlag = 0;
+
+    for (int i = 0; i < nel; i++) {
+        (*printObj)(arr[i], file);
+
+        if (file == stdout && pausa) {
+            int count = i + 1;
+            if (count % pausa == 0 && count < nel && noStop) {
+                printf("\n");
+                int opcao = enter_espaco_esc();
+                switch (opcao) {
+                    case 0:
+                        break;
+                    case 1:
+                        if (nel - pausa > i) i = nel - pausa - 1; // Mostrar só os últimos
+                        noStop = 0;
+                        break;
+                    case 2:
+                        listagemFlag = 1;
+                        return;
+                    default:
+                        break;
+                }
+            }
+        }
+
+        if (file == stdout) printf("\n");
+    }
+}
+
+/**
+ * @brief Ordena um pequeno intervalo do array por inserção
+ * 
+ * @param arr Array
+ * @param inicio Primeiro índice
+ * @param fim Último índice (inclusive)
+ * @param compObjs Função para comparar elementos
+ */
+static void insercaoArray(void **arr, int inicio, int fim, int (*compObjs)(void *obj1, void *obj2)) {
+    for (int i = inicio + 1; i <= fim; i++) {
+        void *x = arr[i];
+        int j = i - 1;
+        while (j >= inicio && compObjs(arr[j], x) > 0) {
+            arr[j + 1] = arr[j];
+            j--;
+        }
+        arr[j + 1] = x;
+    }
+}
+
+/**
+ * @brief Reorganiza um heap (max) de raiz i, dentro do intervalo [inicio, inicio + n[
+ */
+static void descerHeapArray(void **arr, int inicio, int n, int i, int (*compObjs)(void *obj1, void *obj2)) {
+    void *x = arr[inicio + i];
+    while (2 * i + 1 < n) {
+        int filho = 2 * i + 1;
+        if (filho + 1 < n && compObjs(arr[inicio + filho], arr[inicio + filho + 1]) < 0) filho++;
+        if (compObjs(x, arr[inicio + filho]) >= 0) break;
+        arr[inicio + i] = arr[inicio + filho];
+        i = filho;
+    }
+    arr[inicio + i] = x;
+}
+
+/**
+ * @brief Heapsort de um intervalo do array (usado quando o quicksort degenera)
+ */
+static void heapsortArray(void **arr, int inicio, int fim, int (*compObjs)(void *obj1, void *obj2)) {
+    int n = fim - inicio + 1;
+    for (int i = n / 2 - 1; i >= 0; i--) {
+        descerHeapArray(arr, inicio, n, i, compObjs);
+    }
+    for (int i = n - 1; i > 0; i--) {
+        void *aux = arr[inicio];
+        arr[inicio] = arr[inicio + i];
+        arr[inicio + i] = aux;
+        descerHeapArray(arr, inicio, i, 0, compObjs);
+    }
+}
+
+/**
+ * @brief Introsort: quicksort com mediana de 3, heapsort se a profundidade passar o limite
+ * 
+ * @note Recursão apenas na menor partição, a maior é tratada no próprio ciclo
+ */
+static void introsortArray(void **arr, int inicio, int fim, int profundidade, int (*compObjs)(void *obj1, void *obj2)) {
+    while (fim - inicio + 1 > LIMITE_INSERCAO_ARRAY) {
+        if (profundidade-- == 0) {
+            heapsortArray(arr, inicio, fim, compObjs);
+            return;
+        }
+        // Mediana de 3 colocada em arr[meio]
+        int meio = inicio + (fim - inicio) / 2;
+        void *aux;
+        if (compObjs(arr[meio], arr[inicio]) < 0) { aux = arr[meio]; arr[meio] = arr[inicio]; arr[inicio] = aux; }
+        if (compObjs(arr[fim], arr[meio]) < 0) { aux = arr[fim]; arr[fim] = arr[meio]; arr[meio] = aux; }
+        if (compObjs(arr[meio], arr[inicio]) < 0) { aux = arr[meio]; arr[meio] = arr[inicio]; arr[inicio] = aux; }
+        void *pivo = arr[meio];
+
+        int i = inicio, j = fim;
+        while (i <= j) {
+            while (compObjs(arr[i], pivo) < 0) i++;
+            while (compObjs(arr[j], pivo) > 0) j--;
+            if (i <= j) {
+                aux = arr[i]; arr[i] = arr[j]; arr[j] = aux;
+                i++;
+                j--;
+            }
+        }
+        if (j - inicio < fim - i) {
+            introsortArray(arr, inicio, j, profundidade, compObjs);
+            inicio = i;
+        }
+        else {
+            introsortArray(arr, i, fim, profundidade, compObjs);
+            fim = j;
+        }
+    }
+    insercaoArray(arr, inicio, fim, compObjs);
+}
+
+/**
+ * @brief Ordena um array de ponteiros
+ * 
+ * @param arr Array
+ * @param nel Número de elementos
+ * @param compObjs Função para comparar elementos (deve retornar < 0 se obj1 < obj2)
+ * 
+ * @note Introsort: O(n log n) no pior caso, não é estável
+ */
+void ordenarArray(void **arr, int nel, int (*compObjs)(void *obj1, void *obj2)) {
+    if (!arr || nel < 2 || !compObjs) return;
+
+    int profundidade = 0;
+    for (int n = nel; n > 1; n >>= 1) profundidade += 2;
+
+    introsortArray(arr, 0, nel - 1, profundidade, compObjs);
+}
+
+/**
+ * @brief Ordena um array de ponteiros por uma chave inteira (radix sort LSD)
+ * 
+ * @param arr Array
+ * @param nel Número de elementos
+ * @param chaveObj Função que devolve a chave de ordenação de um elemento
+ * @return int 1 se sucesso, 0 se erro
+ * 
+ * @note Estável, 4 passagens de 8 bits; passagens em que todos os elementos têm o mesmo byte são saltadas
+ */
+int ordenarArrayPorChave(void **arr, int nel, uint32_t (*chaveObj)(void *obj)) {
+    if (!arr || !chaveObj) return 0;
+    if (nel < 2) return 1;
+
+    uint32_t *chaves = (uint32_t *)malloc(sizeof(uint32_t) * nel * 2);
+    void **aux = (void **)malloc(sizeof(void *) * nel);
+    if (!chaves || !aux) {
+        free(chaves);
+        free(aux);
+        return 0;
+    }
+    uint32_t *chavesAux = chaves + nel;
+    for (int i = 0; i < nel; i++) {
+        chaves[i] = chaveObj(arr[i]);
+    }
+
+    void **origem = arr, **destino = aux;
+    uint32_t *chavesOrigem = chaves, *chavesDestino = chavesAux;
+    for (int shift = 0; shift < 32; shift += 8) {
+        int contagem[257] = {0};
+        for (int i = 0; i < nel; i++) {
+            contagem[((chavesOrigem[i] >> shift) & 0xFF) + 1]++;
+        }
+        if (contagem[((chavesOrigem[0] >> shift) & 0xFF) + 1] == nel) continue; // Byte igual em todos
+        for (int b = 0; b < 256; b++) {
+            contagem[b + 1] += contagem[b];
+        }
+        for (int i = 0; i < nel; i++) {
+            int pos = contagem[(chavesOrigem[i] >> shift) & 0xFF]++;
+            destino[pos] = origem[i];
+            chavesDestino[pos] = chavesOrigem[i];
+        }
+        void **t = origem; origem = destino; destino = t;
+        uint32_t *tc = chavesOrigem; chavesOrigem = chavesDestino; chavesDestino = tc;
+    }
+    if (origem != arr) {
+        memcpy(arr, origem, sizeof(void *) * nel);
+    }
+    free(chaves);
+    free(aux);
+    return 1;
+}
+
+// Internamento de strings
+
+/**
+ * @brief Cria uma tabela de internamento vazia
+ * 
+ * @return Internamento* Tabela ou NULL se erro
+ * 
+ * @note Cada texto distinto recebe um id pequeno (0, 1, 2, ...), pela ordem em que é internado
+ */
+Internamento *criarInternamento() {
+    Internamento *in = (Internamento *)malloc(sizeof(Internamento));
+    if (!in) return NULL;
+
+    in->capacidade = CAPACIDADE_INICIAL_INTERNAMENTO;
+    in->nel = 0;
+    in->tabela = (uint16_t *)calloc(in->capacidade, sizeof(uint16_t));
+    in->textos = (char **)malloc(sizeof(char *) * (in->capacidade / 2));
+    in->chaves = (char **)malloc(sizeof(char *) * (in->capacidade / 2));
+    in->strings = criarArena();
+    if (!in->tabela || !in->textos || !in->chaves || !in->strings) {
+        freeInternamento(in);
+        return NULL;
+    }
+    return in;
+}
+
+/**
+ * @brief Procura a posição da tabela onde está (ou deve ficar) uma chave
+ * 
+ * @param in Internamento
+ * @param chave Chave
+ * @return int Índice na tabela
+ */
+static int posicaoInternamento(Internamento *in, const char *chave) {
+    int mascara = in->capacidade - 1;
+    int i = (int)(misturarHash(hashString(chave)) & (unsigned int)mascara);
+
+    while (in->tabela[i] && strcmp(in->chaves[in->tabela[i] - 1], chave) != 0) {
+        i = (i + 1) & mascara;
+    }
+    return i;
+}
+
+/**
+ * @brief Duplica a capacidade da tabela de internamento
+ * 
+ * @param in Internamento
+ * @return int 1 se sucesso, 0 se erro
+ */
+static int crescerInternamento(Internamento *in) {
+    int capacidade = in->capacidade * 2;
+
+    uint16_t *tabela = (uint16_t *)calloc(capacidade, sizeof(uint16_t));
+    char **textos = (char **)realloc(in->textos, sizeof(char *) * (capacidade / 2));
+    if (textos) in->textos = textos;
+    char **chaves = (char **)realloc(in->chaves, sizeof(char *) * (capacidade / 2));
+    if (chaves) in->chaves = chaves;
+    if (!tabela || !textos || !chaves) {
+        free(tabela);
+        return 0;
+    }
+
+    free(in->tabela);
+    in->tabela = tabela;
+    in->capacidade = capacidade;
+    for (int id = 0; id < in->nel; id++) {
+        in->tabela[posicaoInternamento(in, in->chaves[id])] = (uint16_t)(id + 1);
+    }
+    return 1;
+}
+
+/**
+ * @brief Obtém o id de um texto, internando-o caso ainda não exista
  * 
- * @param compChave Função para comparar a chave (deve retornar 0 se igual)
- * @param criarChave Função para criar a chave
- * @param hashChave Função para obter o hash da chave
- * @param freeObj Função para libertar a memória ocupada por um objeto
- * @param freeChave Função para libertar a memória ocupada por uma chave
- * @param readInfo Função para ler um elemento do ficheiro binário
- * @param file Ficheiro binário, aberto
- * @return Dict* Dicionário com os dados ou NULL se erro
+ * @param in Internamento
+ * @param texto Texto a guardar
+ * @param chave Chave usada para identificar textos iguais (NULL para usar o próprio texto)
+ * @return int id (0 a MAX_INTERNADOS - 1) ou -1 se erro
+ * 
+ * @note Com uma chave normalizada, textos diferentes com a mesma chave partilham o id (e o primeiro texto)
  */
-Dict *readToDictBin(void *(*criarChave)(void *obj), int (*hashChave)(void *obj), void (*freeObj)(void *obj),
-                        void (*freeChave)(void *chave), void *(*readInfo)(FILE *fileObj), FILE *file) {
-    if (!file || !readInfo || !freeChave || !freeObj || !hashChave || !criarChave) return NULL;
+int internarTexto(Internamento *in, const char *texto, const char *chave) {
+    if (!in || !texto) return -1;
+    if (!chave) chave = texto;
 
-    Dict *has = criarDict();
-    if (!has) return NULL;
+    int i = posicaoInternamento(in, chave);
+    if (in->tabela[i]) return in->tabela[i] - 1;
 
-    // NEL Dict
-    fread(&has->nelDict, sizeof(int), 1, file);
-    if (has->nelDict < 0) {
-        free(has);
-        return NULL;
+    if (in->nel >= MAX_INTERNADOS) return -1;
+    if ((in->nel + 1) * 2 > in->capacidade) {
+        if (!crescerInternamento(in)) return -1;
+        i = posicaoInternamento(in, chave);
     }
 
-    Lista *lista = NULL;
-    for (int i = 0; i < has->nelDict; i++) {
-        // Ler a lista guardada
-        lista = readListaBin(readInfo, file);
-        if (!lista || !lista->inicio->info) {
-            freeDict(has, freeChave, freeObj);
-            return NULL;
-        }
-
-        // O primeiro elemento cria a chave e obtém o índice
-        void *primeiroObj = lista->inicio->info;
-        void *chave = criarChave(primeiroObj);
-        int indice = hashChave(chave) % TAMANHO_TABELA_HASH;
-        if (indice < 0) {
-            freeChave(chave);
-            if (lista->inicio->info) {
-                freeLista(lista, freeObj);
-            }
-            freeDict(has, freeChave, freeObj);
-            return NULL;
-        }
+    char *copiaTexto = guardarStringArena(in->strings, texto);
+    char *copiaChave = chave == texto ? copiaTexto : guardarStringArena(in->strings, chave);
+    if (!copiaTexto || !copiaChave) return -1;
 
-        // Criar o nó e adicionar ao Dict
-        NoHashing *novo = (NoHashing *)malloc(sizeof(NoHashing));
-        if (!novo) {
-            freeLista(lista, freeObj);
-            freeChave(chave);
-            freeDict(has, freeChave, freeObj);
-            return NULL;
-        }
+    in->textos[in->nel] = copiaTexto;
+    in->chaves[in->nel] = copiaChave;
+    in->tabela[i] = (uint16_t)(in->nel + 1);
+    return in->nel++;
+}
 
-        novo->chave = chave;
-        novo->dados = lista;
-        novo->prox = has->tabela[indice];
-        has->tabela[indice] = novo;
-    }
+/**
+ * @brief Obtém o texto associado a um id
+ * 
+ * @param in Internamento
+ * @param id id
+ * @return const char* Texto ou NULL se erro
+ */
+const char *textoInternado(Internamento *in, int id) {
+    if (!in || id < 0 || id >= in->nel) return NULL;
 
-    return has;
+    return in->textos[id];
 }
 
 /**
- * @brief Obtém a memória utilizada por um dicionário
+ * @brief Obtém a chave associada a um id
  * 
- * @param has Dicionário
- * @param objMemUsage Função para obter a memória ocupada por cada elemento
- * @param chaveMemUsage Função para obter a memória ocupada pela chave
- * @return size_t Memória ocupada ou 0 se erro
+ * @param in Internamento
+ * @param id id
+ * @return const char* Chave ou NULL se erro
  */
-size_t dictMemUsage(Dict *has, size_t (*objMemUsage)(void *obj), size_t (*chaveMemUsage)(void *chave)) {
-    if (!has) return 0;
+const char *chaveInternada(Internamento *in, int id) {
+    if (!in || id < 0 || id >= in->nel) return NULL;
 
-    size_t mem = 0;
-    mem += sizeof(*has); //ptr + nel
+    return in->chaves[id];
+}
 
-    for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-        NoHashing *p = has->tabela[i];
-        
-        while (p) {
-            mem += sizeof(*p); // NoHashing
+/**
+ * @brief Guarda uma tabela de internamento em ficheiro binário
+ * 
+ * @param in Internamento
+ * @param file Ficheiro binário, aberto
+ * 
+ * @note Os textos são escritos pela ordem dos ids, para que readInternamentoBin os reponha
+ */
+void guardarInternamentoBin(Internamento *in, FILE *file) {
+    if (!file) return;
+
+    int nel = in ? in->nel : 0;
+    fwrite(&nel, sizeof(int), 1, file);
+    for (int id = 0; id < nel; id++) {
+        size_t tamanhoTexto = strlen(in->textos[id]) + 1;
+        fwrite(&tamanhoTexto, sizeof(size_t), 1, file);
+        fwrite(in->textos[id], tamanhoTexto, 1, file);
+
+        size_t tamanhoChave = strlen(in->chaves[id]) + 1;
+        fwrite(&tamanhoChave, sizeof(size_t), 1, file);
+        fwrite(in->chaves[id], tamanhoChave, 1, file);
+    }
+}
 
-            if (chaveMemUsage) {
-                mem += chaveMemUsage(p->chave);
+/**
+ * @brief Lê uma tabela de internamento de um ficheiro binário
+ * 
+ * @param file Ficheiro binário, aberto
+ * @return Internamento* Tabela ou NULL se erro
+ */
+Internamento *readInternamentoBin(FILE *file) {
+    if (!file) return NULL;
+
+    int nel = 0;
+    if (fread(&nel, sizeof(int), 1, file) != 1 || nel < 0 || nel > MAX_INTERNADOS) return NULL;
+
+    Internamento *in = criarInternamento();
+    if (!in) return NULL;
+
+    for (int id = 0; id < nel; id++) {
+        size_t tamanhoTexto, tamanhoChave;
+        char *texto = NULL, *chave = NULL;
+
+        fread(&tamanhoTexto, sizeof(size_t), 1, file);
+        texto = (char *)malloc(tamanhoTexto);
+        if (texto && fread(texto, tamanhoTexto, 1, file) == 1) {
+            fread(&tamanhoChave, sizeof(size_t), 1, file);
+            chave = (char *)malloc(tamanhoChave);
+            if (chave && fread(chave, tamanhoChave, 1, file) != 1) {
+                free(chave);
+                chave = NULL;
             }
-            mem += listaMemUsage(p->dados, objMemUsage);
-
-            p = p->prox;
+        }
+        // Os ids são atribuídos pela ordem de leitura, logo coincidem com os guardados
+        int idLido = chave ? internarTexto(in, texto, chave) : -1;
+        free(texto);
+        free(chave);
+        if (idLido != id) {
+            freeInternamento(in);
+            return NULL;
         }
     }
-
-    return mem;
+    return in;
 }
 
 /**
- * @brief Adiciona todos os elementos de um dicionário a uma lista
+ * @brief Liberta uma tabela de internamento
  * 
- * @param has Dicionário
- * @return Lista* Lista ou NULL se erro
+ * @param in Internamento
  */
-Lista *dictToLista(Dict *has) {
-    if (!has) return NULL;
-
-    Lista *li = criarLista();
-    if (!li) return NULL;
-
-    for (int i = 0; i < TAMANHO_TABELA_HASH; i++) {
-        NoHashing *p = has->tabela[i];
-
-        while(p) {
-            No *x = p->dados->inicio;
+void freeInternamento(Internamento *in) {
+    if (!in) return;
+
+    free(in->tabela);
+    free(in->textos);
+    free(in->chaves);
+    freeArena(in->strings);
+    free(in);
+}
 
-            while(x) {
-                addInicioLista(li, x->info);
+/**
+ * @brief Memória ocupada por uma tabela de internamento
+ * 
+ * @param in Internamento
+ * @return size_t Memória ocupada ou 0 se erro
+ */
+size_t internamentoMemUsage(Internamento *in) {
+    if (!in) return 0;
 
-                x = x->prox;
-            }
-            p = p->prox;
-        }
-    }
+    size_t mem = sizeof(Internamento);
+    mem += in->capacidade * sizeof(uint16_t);
+    mem += (in->capacidade / 2) * sizeof(char *) * 2;
+    mem += arenaMemUsage(in->strings);
 
-    return li;
+    return mem;
 }
 
 // Rankings
@@ -1032,7 +2467,7 @@ Ranking *criarRanking() {
 int addToRanking(Ranking *r, void *mainInfo, void *compInfo) {
     if (!r || !mainInfo || !compInfo) return 0;
 
-    NoRankings *aux = (NoRankings *)malloc(sizeof(NoRankings));
+    NoRankings *aux = (NoRankings *)alocarNoPool(&poolRankings);
     if (!aux) return 0;
 
     aux->mainInfo = mainInfo;
@@ -1111,100 +2546,396 @@ void freeRanking(Ranking *r, void (*freeMainObj)(void *obj), void (*freeCompObj)
     if (!r) return;
 
     NoRankings *p = r->inicio;
-    NoRankings *seg;
+    NoRankings *ultimo = NULL;
+    size_t n = 0;
 
     while(p) {
-        seg = p->prox;
         if (freeMainObj) {
             (*freeMainObj)(p->mainInfo);
         }
         if (freeCompObj) {
             (*freeCompObj)(p->compInfo);
         }
-        free(p);
-        p = seg;
+        ultimo = p;
+        n++;
+        p = p->prox;
     }
+    devolverCadeiaPool(&poolRankings, r->inicio, ultimo, n);
     free(r);
 }
 
 /**
- * @brief Combina 2 ranking ordenados em 1
+ * @brief Ordena os rankings
+ * 
+ * @param r Ranking a ordenar
+ * @param compObjs Função para comparar identificadores (ordem de ordenação)
  * 
- * @param a Nó do primeiro ranking
- * @param b Nó do segundo ranking
- * @param compObjs Função para comparar identificadores (deve retornar < 0 se obj1 < obj2)
- * @return NoRankings* Ranking agrupado
+ * @note Usa o mesmo merge sort (paralelo para rankings grandes) das listas, comparando o compInfo de cada nó
  */
-static NoRankings *mergeRankings(NoRankings *a, NoRankings *b, int (*compObjs)(void *obj1, void *obj2)) {
-    if (!a) return b;
-    if (!b) return a;
-    
-    NoRankings *result = NULL;
-    
-    if (compObjs(a->compInfo, b->compInfo) <= 0) {
-        result = a;
-        result->prox = mergeRankings(a->prox, b, compObjs);
-    } else {
-        result = b;
-        result->prox = mergeRankings(a, b->prox, compObjs);
+void mergeSortRanking(Ranking* r, int (*compObjs)(void *obj1, void *obj2)) {
+    if (!r || !r->inicio || !compObjs) return;
+
+    r->inicio = (NoRankings *)ordenarNosParalelo(&formatoNoRanking, r->inicio, r->nel, compObjs);
+}
+
+// Rankings numéricos
+
+/**
+ * @brief Cria um ranking numérico (pontuações guardadas no próprio array)
+ * 
+ * @param tipo RANKING_INT ou RANKING_FLOAT
+ * @return RankingNumerico* 
+ */
+RankingNumerico *criarRankingNumerico(int tipo) {
+    return criarRankingTopK(tipo, 0, NULL, NULL);
+}
+
+/**
+ * @brief Cria um ranking numérico que guarda apenas as K melhores entradas
+ * 
+ * @param tipo RANKING_INT ou RANKING_FLOAT
+ * @param k Nº máximo de entradas guardadas (0 = sem limite)
+ * @param preencher Função que percorre os dados e adiciona as entradas ao ranking (pode ser NULL)
+ * @param contexto Argumento passado a preencher
+ * @return RankingNumerico* 
+ * 
+ * @note Com k > 0 as entradas formam um heap (a pior na raiz) até o ranking ser ordenado;
+ *       preencher permite expandir para a lista completa quando o utilizador passa das K primeiras
+ */
+RankingNumerico *criarRankingTopK(int tipo, int k, int (*preencher)(RankingNumerico *r, void *contexto), void *contexto) {
+    if ((tipo != RANKING_INT && tipo != RANKING_FLOAT) || k < 0) return NULL;
+
+    RankingNumerico *r = (RankingNumerico *)malloc(sizeof(RankingNumerico));
+    if (!r) return NULL;
+
+    r->capacidade = (k > 0 && k < CAPACIDADE_INICIAL_RANKING) ? k : CAPACIDADE_INICIAL_RANKING;
+    r->entradas = (EntradaRanking *)malloc(sizeof(EntradaRanking) * r->capacidade);
+    if (!r->entradas) {
+        free(r);
+        return NULL;
     }
-    
-    return result;
+    r->nel = 0;
+    r->tipo = tipo;
+    r->limite = k;
+    r->total = 0;
+    r->preencher = preencher;
+    r->contexto = contexto;
+    return r;
 }
 
 /**
- * @brief Separa 2 rankings
+ * @brief Converte a pontuação de uma entrada numa chave sem sinal cuja ordem crescente é a ordem decrescente da pontuação
  * 
- * @param head Ranking a separar
- * @param front Ponteiro para a primeira metade
- * @param back Ponteiro para a segunda metade
+ * @param tipo RANKING_INT ou RANKING_FLOAT
+ * @param e Entrada
+ * @return uint32_t Chave de ordenação
+ * 
+ * @note Nos ints basta inverter o bit de sinal; nos floats IEEE-754 os negativos têm todos os bits invertidos
  */
-static void splitRanking(NoRankings *head, NoRankings **front, NoRankings **back) {
-    NoRankings *rapido = head->prox;
-    NoRankings *lento = head;
-    
-    while (rapido != NULL) {
-        rapido = rapido->prox;
-        if (rapido != NULL) {
-            lento = lento->prox;
-            rapido = rapido->prox;
+static uint32_t chaveEntradaRanking(int tipo, const EntradaRanking *e) {
+    uint32_t bits;
+    if (tipo == RANKING_INT) {
+        bits = (uint32_t)e->valor.i ^ 0x80000000u;
+    }
+    else {
+        memcpy(&bits, &e->valor.f, sizeof(bits));
+        bits = (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+    }
+    return ~bits; // Maior pontuação primeiro
+}
+
+/**
+ * @brief Verifica se a entrada a fica depois da entrada b no ranking
+ * 
+ * @param tipo RANKING_INT ou RANKING_FLOAT
+ * @param a Entrada
+ * @param b Entrada
+ * @return int 1 se a é pior que b, 0 caso contrário
+ * 
+ * @note Em caso de empate fica à frente a que foi inserida primeiro
+ */
+static int entradaPior(int tipo, const EntradaRanking *a, const EntradaRanking *b) {
+    uint32_t ka = chaveEntradaRanking(tipo, a);
+    uint32_t kb = chaveEntradaRanking(tipo, b);
+    return ka > kb || (ka == kb && a->ordem > b->ordem);
+}
+
+/**
+ * @brief Desce uma entrada no heap do Top-K (a pior entrada fica na raiz)
+ * 
+ * @param entradas Entradas
+ * @param n Nº de entradas do heap
+ * @param i Posição a descer
+ * @param tipo RANKING_INT ou RANKING_FLOAT
+ */
+static void descerHeapRanking(EntradaRanking *entradas, int n, int i, int tipo) {
+    EntradaRanking e = entradas[i];
+    while (2 * i + 1 < n) {
+        int filho = 2 * i + 1;
+        if (filho + 1 < n && entradaPior(tipo, &entradas[filho + 1], &entradas[filho])) filho++;
+        if (!entradaPior(tipo, &entradas[filho], &e)) break;
+        entradas[i] = entradas[filho];
+        i = filho;
+    }
+    entradas[i] = e;
+}
+
+/**
+ * @brief Sobe uma entrada no heap do Top-K
+ * 
+ * @param entradas Entradas
+ * @param i Posição a subir
+ * @param tipo RANKING_INT ou RANKING_FLOAT
+ */
+static void subirHeapRanking(EntradaRanking *entradas, int i, int tipo) {
+    EntradaRanking e = entradas[i];
+    while (i > 0) {
+        int pai = (i - 1) / 2;
+        if (!entradaPior(tipo, &e, &entradas[pai])) break;
+        entradas[i] = entradas[pai];
+        i = pai;
+    }
+    entradas[i] = e;
+}
+
+/**
+ * @brief Insere uma entrada no ranking, respeitando o limite do Top-K
+ * 
+ * @param r Ranking
+ * @param e Entrada (a ordem é atribuída aqui)
+ * @return int 0 se erro, 1 se sucesso (também quando a entrada fica fora do Top-K)
+ */
+static int inserirEntradaRanking(RankingNumerico *r, EntradaRanking e) {
+    e.ordem = r->total++;
+
+    if (r->limite > 0 && r->nel == r->limite) {
+        if (!entradaPior(r->tipo, &r->entradas[0], &e)) return 1; // Não entra no Top-K
+        r->entradas[0] = e;
+        descerHeapRanking(r->entradas, r->nel, 0, r->tipo);
+        return 1;
+    }
+
+    if (r->nel == r->capacidade) {
+        int novaCapacidade = r->capacidade * 2;
+        if (r->limite > 0 && novaCapacidade > r->limite) novaCapacidade = r->limite;
+
+        EntradaRanking *temp = (EntradaRanking *)realloc(r->entradas, sizeof(EntradaRanking) * novaCapacidade);
+        if (!temp) {
+            r->total--;
+            return 0;
         }
+        r->entradas = temp;
+        r->capacidade = novaCapacidade;
     }
-    
-    *front = head;
-    *back = lento->prox;
-    lento->prox = NULL;
+    r->entradas[r->nel++] = e;
+    if (r->limite > 0) {
+        subirHeapRanking(r->entradas, r->nel - 1, r->tipo);
+    }
+    return 1;
 }
 
 /**
- * @brief Mergesort recursivo para os nós da função
+ * @brief Adiciona um objeto com pontuação inteira ao ranking
  * 
- * @param headRef Head da função
- * @param compObjs Função para comparar identificadores
+ * @param r Ranking (RANKING_INT)
+ * @param mainInfo Objeto
+ * @param valor Pontuação
+ * @return int 0 se erro, 1 se sucesso
  */
-static void mergesortRecursivoRanking(NoRankings **headRef, int (*compObjs)(void *obj1, void *obj2)) {
-    NoRankings *head = *headRef;
-    if (!head || !head->prox) return;
-    
-    NoRankings *a;
-    NoRankings *b;
-    
-    splitRanking(head, &a, &b);
-    mergesortRecursivoRanking(&a, compObjs);
-    mergesortRecursivoRanking(&b, compObjs);
-    
-    *headRef = mergeRankings(a, b, compObjs);
+int addToRankingInt(RankingNumerico *r, void *mainInfo, int valor) {
+    if (!r || !mainInfo || r->tipo != RANKING_INT) return 0;
+
+    EntradaRanking e = {.mainInfo = mainInfo, .valor.i = valor};
+    return inserirEntradaRanking(r, e);
 }
 
 /**
- * @brief Ordena os rankings
+ * @brief Adiciona um objeto com pontuação float ao ranking
  * 
- * @param r Ranking a ordenar
- * @param compObjs Função para comparar identificadores (ordem de ordenação)
+ * @param r Ranking (RANKING_FLOAT)
+ * @param mainInfo Objeto
+ * @param valor Pontuação
+ * @return int 0 se erro, 1 se sucesso
  */
-void mergeSortRanking(Ranking* r, int (*compObjs)(void *obj1, void *obj2)) {
-    if (!r || !r->inicio || !compObjs) return;
+int addToRankingFloat(RankingNumerico *r, void *mainInfo, float valor) {
+    if (!r || !mainInfo || r->tipo != RANKING_FLOAT) return 0;
+
+    EntradaRanking e = {.mainInfo = mainInfo, .valor.f = valor};
+    return inserirEntradaRanking(r, e);
+}
+
+/**
+ * @brief Ordena um ranking numérico por ordem decrescente de pontuação
+ * 
+ * @param r Ranking
+ * @return int 1 se sucesso, 0 se erro
+ * 
+ * @note Sem limite usa radix sort LSD estável sobre o padrão de bits da pontuação (empates mantêm a ordem de inserção);
+ *       no Top-K ordena o heap in-place (heapsort, O(K log K)) com o mesmo desempate. Chamar depois de todas as inserções
+ */
+int ordenarRankingNumerico(RankingNumerico *r) {
+    if (!r) return 0;
+    int nel = r->nel;
+    if (nel < 2) return 1;
+
+    if (r->limite > 0) {
+        for (int fim = nel - 1; fim > 0; fim--) {
+            EntradaRanking t = r->entradas[0];
+            r->entradas[0] = r->entradas[fim];
+            r->entradas[fim] = t;
+            descerHeapRanking(r->entradas, fim, 0, r->tipo);
+        }
+        return 1;
+    }
+
+    EntradaRanking *aux = (EntradaRanking *)malloc(sizeof(EntradaRanking) * nel);
+    uint32_t *chaves = (uint32_t *)malloc(sizeof(uint32_t) * nel * 2);
+    if (!aux || !chaves) {
+        free(aux);
+        free(chaves);
+        return 0;
+    }
+    uint32_t *chavesAux = chaves + nel;
+    for (int i = 0; i < nel; i++) {
+        chaves[i] = chaveEntradaRanking(r->tipo, &r->entradas[i]);
+    }
+
+    EntradaRanking *origem = r->entradas, *destino = aux;
+    uint32_t *chavesOrigem = chaves, *chavesDestino = chavesAux;
+    for (int shift = 0; shift < 32; shift += 8) {
+        int contagem[257] = {0};
+        for (int i = 0; i < nel; i++) {
+            contagem[((chavesOrigem[i] >> shift) & 0xFF) + 1]++;
+        }
+        if (contagem[((chavesOrigem[0] >> shift) & 0xFF) + 1] == nel) continue; // Byte igual em todos
+        for (int b = 0; b < 256; b++) {
+            contagem[b + 1] += contagem[b];
+        }
+        for (int i = 0; i < nel; i++) {
+            int pos = contagem[(chavesOrigem[i] >> shift) & 0xFF]++;
+            destino[pos] = origem[i];
+            chavesDestino[pos] = chavesOrigem[i];
+        }
+        EntradaRanking *t = origem; origem = destino; destino = t;
+        uint32_t *tc = chavesOrigem; chavesOrigem = chavesDestino; chavesDestino = tc;
+    }
+    if (origem != r->entradas) {
+        memcpy(r->entradas, origem, sizeof(EntradaRanking) * nel);
+    }
+    free(aux);
+    free(chaves);
+    return 1;
+}
+
+/**
+ * @brief (Re)preenche o ranking através da sua função preencher e ordena-o
+ * 
+ * @param r Ranking
+ * @return int 1 se sucesso, 0 se erro
+ */
+int preencherRankingNumerico(RankingNumerico *r) {
+    if (!r || !r->preencher) return 0;
+
+    r->nel = 0;
+    r->total = 0;
+    if (!(*r->preencher)(r, r->contexto)) return 0;
+    return ordenarRankingNumerico(r);
+}
+
+/**
+ * @brief Expande um Top-K para o ranking completo, voltando a percorrer os dados
+ * 
+ * @param r Ranking
+ * @return int 1 se sucesso (ou se nada tinha ficado de fora), 0 se erro
+ * 
+ * @note As primeiras K entradas mantêm a posição, pois o desempate é o mesmo nos dois modos
+ */
+int expandirRankingNumerico(RankingNumerico *r) {
+    if (!r) return 0;
+    if (r->limite == 0 || r->total == r->nel) return 1;
+
+    r->limite = 0;
+    return preencherRankingNumerico(r);
+}
+
+/**
+ * @brief Mostra um ranking numérico
+ * 
+ * @param r Ranking
+ * @param printCarroRanking Função para mostrar o objeto e a pontuação
+ * @param printHeaderCompObj Função para mostrar o cabeçalho
+ * @param printCompObj Função para mostrar a pontuação (recebe um int* ou float*)
+ * @param file Ficheiro
+ * @param pausa Pausa da listagem
+ * 
+ * @note Reutiliza as funções de linha dos rankings ligados através de um NoRankings temporário.
+ *       Um Top-K só é expandido se o utilizador passar das K entradas (ou se a listagem não tiver pausas)
+ */
+void printRankingNumerico(RankingNumerico *r, void printCarroRanking(NoRankings *no, void (*printCompObj)(void *compInfo, FILE *file), FILE *file), 
+        void (*printHeaderCompObj)(FILE *file), void (*printCompObj)(void *compInfo, FILE *file), FILE *file, int pausa) {
+    if (!r || !printCompObj || !printHeaderCompObj || !file || pausa < 0) return;
+
+    int noStop = 1;
+    int count = 0;
+    listagemFlag = 0;
+
+    if (file != stdout || !pausa) {
+        expandirRankingNumerico(r);
+    }
+
+    (*printHeaderCompObj)(file);
+    for (int i = 0; i < r->nel; i++) {
+        NoRankings no = {r->entradas[i].mainInfo, (void *)&r->entradas[i].valor, NULL};
+
+        if (file == stdout) {
+            fprintf(file, "%d. \t", i + 1);
+        }
+        else {
+            fprintf(file, "%d", i + 1);
+        }
+        (*printCarroRanking)(&no, printCompObj, file);
+
+        if (file == stdout && pausa) {
+            count++;
+            if (count % pausa == 0 && count < r->total && noStop) {
+                printf("\n");
+                int opcao = enter_espaco_esc();
+                switch (opcao) {
+                    case 0:
+                        if (count == r->nel) {
+                            expandirRankingNumerico(r); // Passou do Top-K
+                        }
+                        break;
+                    case 1:
+                        // Salta para os últimos 'pausa' elementos, que podem estar fora do Top-K
+                        expandirRankingNumerico(r);
+                        if (r->nel - pausa > i + 1) {
+                            i = r->nel - pausa - 1; // O ciclo avança para o primeiro dos últimos 'pausa'
+                            count = i + 1;
+                        }
+                        noStop = 0;
+                        break;
+                    case 2:
+                        return;
+                    default:
+                        break;
+                }
+            }
+        }
+
+        if (file == stdout) printf("\n");
+    }
+}
+
+/**
+ * @brief Liberta a memória associada a um ranking numérico (os objetos não são libertados)
+ * 
+ * @param r Ranking
+ */
+void freeRankingNumerico(RankingNumerico *r) {
+    if (!r) return;
 
-    mergesortRecursivoRanking(&r->inicio, compObjs);
+    free(r->entradas);
+    free(r);
 }
  
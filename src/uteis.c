@@ -119,6 +119,36 @@ int enter_espaco_esc() {
     #endif
 }
 
+/**
+ * @brief Espera algum tempo, terminando mais cedo se o utilizador pressionar ENTER
+ * 
+ * @param milissegundos Tempo máximo de espera
+ * @return int 1 se ENTER foi pressionado, 0 se o tempo acabou
+ * 
+ * @note Não bloqueia para além do tempo pedido, por isso serve de pausa em ciclos que vão verificando algo
+ */
+int esperarEnter(int milissegundos) {
+    #ifdef _WIN32
+        for (int t = 0; t < milissegundos; t += 50) {
+            while (_kbhit()) {
+                if (_getch() == 13) return 1;  // Enter
+            }
+            Sleep(50);
+        }
+        return 0;
+    #else
+        fd_set entrada;
+        FD_ZERO(&entrada);
+        FD_SET(STDIN_FILENO, &entrada);
+        struct timeval espera = {milissegundos / 1000, (milissegundos % 1000) * 1000};
+        if (select(STDIN_FILENO + 1, &entrada, NULL, NULL, &espera) <= 0) return 0;
+
+        // O terminal está em modo de linha: só há dados depois de um ENTER
+        limpar_buffer();
+        return 1;
+    #endif
+}
+
 /* Gera um int aleatório entre min e max
  *
  * @param min   Número mínimo a ser gerado
@@ -178,6 +208,57 @@ int sim_nao(char *mensagem) {
     } while (1);
 }
 
+/*
+ * Tabela de conversão para os caracteres U+00C0..U+00FF (codificados em UTF-8 como 0xC3 0x80..0xBF),
+ * indexada pelo segundo byte menos 0x80. 0 indica que o caracter não é normalizado.
+ */
+static const char tabelaSemAcentos[64] = {
+    'a','a','a','a','a', 0 , 0 ,'c','e','e','e','e','i','i','i','i', // À Á Â Ã Ä Å Æ Ç È É Ê Ë Ì Í Î Ï
+     0 ,'n','o','o','o','o','o', 0 , 0 ,'u','u','u','u','y', 0 , 0 , // Ð Ñ Ò Ó Ô Õ Ö × Ø Ù Ú Û Ü Ý Þ ß
+    'a','a','a','a','a', 0 , 0 ,'c','e','e','e','e','i','i','i','i', // à á â ã ä å æ ç è é ê ë ì í î ï
+     0 ,'n','o','o','o','o','o', 0 , 0 ,'u','u','u','u','y', 0 ,'y'  // ð ñ ò ó ô õ ö ÷ ø ù ú û ü ý þ ÿ
+};
+
+/* Normaliza uma string para um buffer do chamador, removendo acentos e convertendo para minúsculas
+ *
+ * @param str      String a normalizar. Deve estar codificada em UTF-8.
+ * @param destino  Buffer onde é escrita a string normalizada
+ * @param tamanho  Tamanho do buffer destino (incluindo '\0')
+ *
+ * @return size_t  Comprimento da string normalizada, 0 se erro
+ *
+ * @note Uma única passagem pela string, sem alocar memória
+ * @note A string normalizada nunca é maior que a original, pelo que strlen(str) + 1 chega sempre
+ * @note Se o buffer for pequeno demais, a string é truncada
+ */
+size_t normalizarString(const char *str, char *destino, size_t tamanho) {
+    if (!str || !destino || tamanho == 0) return 0;
+
+    const unsigned char *s = (const unsigned char *)str;
+    size_t n = 0;
+
+    while (*s && n + 1 < tamanho) {
+        if (*s < 0x80) {
+            destino[n++] = (char)tolower(*s);
+            s++;
+        }
+        else if (*s == 0xC3 && s[1] >= 0x80 && s[1] <= 0xBF && tabelaSemAcentos[s[1] - 0x80]) {
+            destino[n++] = tabelaSemAcentos[s[1] - 0x80];
+            s += 2;
+        }
+        else if (*s == 0xC5 && s[1] == 0xB8) { // Ÿ
+            destino[n++] = 'y';
+            s += 2;
+        }
+        else {
+            // Restantes bytes não-ASCII são copiados sem alterações
+            destino[n++] = (char)*s++;
+        }
+    }
+    destino[n] = '\0';
+    return n;
+}
+
 /* Normaliza uma string removendo acentos e convertendo para minúsculas
  *
  * @param str    String a normalizar. Deve estar codificada em UTF-8.
@@ -187,59 +268,18 @@ int sim_nao(char *mensagem) {
  *         - String normalizada sem acentos e em minúsculas
  *         - NULL se str for NULL ou ocorrer erro de memória
  *         
- * @note Arrays estáticos usados para mapear caracteres acentuados para não acentuados
  * @note A string retornada deve ser libertada com free()
- * @note Suporta caracteres UTF-8 multi-byte através de strstr()
+ * @note Para evitar a alocação, usar normalizarString() com um buffer próprio
  */
 char *normString(const char *str) {
     if (!str) return NULL;
-    
-    const char *acentos[] = {"á","à","ã","â","ä","é","è","ê","ë","í","ì","î","ï",
-                            "ó","ò","õ","ô","ö","ú","ù","û","ü","ý","ÿ","ñ","ç",
-                            "Á","À","Ã","Â","Ä","É","È","Ê","Ë","Í","Ì","Î","Ï",
-                            "Ó","Ò","Õ","Ô","Ö","Ú","Ù","Û","Ü","Ý","Ÿ","Ñ","Ç"};
-    const char *sem_acentos[] = {"a","a","a","a","a","e","e","e","e","i","i","i","i",
-                                "o","o","o","o","o","u","u","u","u","y","y","n","c",
-                                "A","A","A","A","A","E","E","E","E","I","I","I","I",
-                                "O","O","O","O","O","U","U","U","U","Y","Y","N","C"};
-    const int n_chars = sizeof(acentos)/sizeof(acentos[0]);
-
-    //Duplicar string original
-    char *resultado = strdup(str);
-    if (!resultado) return NULL;
 
-    //Para cada caracter acentuado possível
-    for (int i = 0; i < n_chars; i++) {
-        //Alocar string temporária
-        char *temp = NULL;
-        //Enquanto encontrar ocorrências do acento atual
-        const char *pos = strstr(resultado, acentos[i]);
-        while (pos != NULL) {
-            int indice = pos - resultado;
-            //Realocar string com espaço para substituição
-            temp = malloc(strlen(resultado) + 1);
-            if (!temp) {
-                free(resultado);
-                return NULL;
-            }
-            //Copiar parte antes do acento
-            strncpy(temp, resultado, indice);
-            temp[indice] = '\0';
-            //Adicionar char sem acento
-            strcat(temp, sem_acentos[i]);
-            //Adicionar resto da string
-            strcat(temp, pos + strlen(acentos[i]));
-            //Atualizar resultado
-            free(resultado);
-            resultado = temp;
-            pos = strstr(resultado, acentos[i]);
-        }
-    }
+    size_t tamanho = strlen(str) + 1;
+    char *resultado = (char *)malloc(tamanho);
+    if (!resultado) return NULL;
 
-    //Converter para minúsculas
-    char *res = strlwrSafe(resultado);
-    free(resultado);
-    return res;
+    normalizarString(str, resultado, tamanho);
+    return resultado;
 }
  
 /* Converte string para minúsculas
@@ -678,6 +718,65 @@ char *converterParaData(const char *strData, Data *data) {
     return NULL;
 }
 
+/**
+ * @brief Converte e valida uma data no formato fixo DD-MM-AAAA HH:MM:SS[.sss], sem alocar memória
+ * 
+ * @param strData Source (String)
+ * @param data Destino (Data)
+ * @return int 1 se a data é válida, 0 se inválida (mesmas regras de validarData), -1 se não está no formato fixo
+ * 
+ * @note Com -1, data não é alterada e deve ser usado converterParaData (aceita outros formatos, p.e. "1-2-2024 3:4:5")
+ * @note A parte decimal dos segundos pode usar '.' ou ',' (até 6 casas), independentemente do locale
+ */
+int converterDataFixa(const char *strData, Data *data) {
+    if (!strData || !data) return -1;
+
+    // Posição dos dígitos em "DD-MM-AAAA HH:MM:SS"
+    static const unsigned char posDigitos[14] = {0, 1, 3, 4, 6, 7, 8, 9, 11, 12, 14, 15, 17, 18};
+    static const short diasPorMes[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+    const unsigned char *s = (const unsigned char *)strData;
+    if (strnlen(strData, 19) < 19) return -1;
+    if (s[2] != '-' || s[5] != '-' || s[10] != ' ' || s[13] != ':' || s[16] != ':') return -1;
+
+    unsigned d[14];
+    unsigned invalido = 0;
+    for (int i = 0; i < 14; i++) {
+        d[i] = (unsigned)s[posDigitos[i]] - '0';
+        invalido |= (d[i] > 9);
+    }
+    if (invalido) return -1;
+
+    // Parte decimal dos segundos
+    unsigned segundos = d[12] * 10 + d[13];
+    unsigned fracao = 0, escala = 1;
+    size_t i = 19;
+    if (s[i] == '.' || s[i] == ',') {
+        i++;
+        while (escala < 1000000 && (unsigned)s[i] - '0' <= 9) {
+            fracao = fracao * 10 + (s[i] - '0');
+            escala *= 10;
+            i++;
+        }
+    }
+    if (s[i] != '\0') return -1;
+
+    data->dia = (short)(d[0] * 10 + d[1]);
+    data->mes = (short)(d[2] * 10 + d[3]);
+    data->ano = (short)(d[4] * 1000 + d[5] * 100 + d[6] * 10 + d[7]);
+    data->hora = (short)(d[8] * 10 + d[9]);
+    data->min = (short)(d[10] * 10 + d[11]);
+    // Até 6 casas a divisão em double arredonda para o mesmo float que strtof
+    data->seg = (float)((double)(segundos * escala + fracao) / escala);
+
+    // Validação (como validarData)
+    if (data->ano < 1 || data->mes < 1 || data->mes > 12 || data->dia < 1 || data->hora >= 24 || data->min >= 60 || data->seg >= 60) return 0;
+    int bissexto = (data->ano % 4 == 0 && data->ano % 100 != 0) || (data->ano % 400 == 0);
+    if (data->dia > diasPorMes[data->mes - 1] + (data->mes == 2 && bissexto)) return 0;
+    // Não pode ser futura
+    return compararDatas(*data, DATA_ATUAL) <= 0;
+}
+
 /**
  * @brief Calcula o tempo entre duas datas em minutos
  * 
@@ -721,6 +820,29 @@ float calcularIntervaloTempo(Data *data1, Data *data2) {
     return (float)(diff_secs / 60.0);
 }
 
+/**
+ * @brief Calcula os minutos de uma data desde 01-01-1970, sem fuso horário
+ * 
+ * @param data Data (validada)
+ * @return double Minutos
+ * 
+ * @note Não usa mktime, por isso é muito mais rápido do que calcularIntervaloTempo, mas ignora as mudanças de hora:
+ *       serve para comparar intervalos com limites largos (p.e. o tempo máximo de uma viagem)
+ */
+double minutosDesdeEpoca(const Data *data) {
+    if (!data) return 0;
+
+    // Dias desde 01-01-1970 no calendário gregoriano, com o ano a começar em março (fevereiro fica no fim)
+    int ano = data->ano - (data->mes <= 2);
+    int era = (ano >= 0 ? ano : ano - 399) / 400;
+    int anoEra = ano - era * 400;
+    int diaAno = (153 * (data->mes + (data->mes > 2 ? -3 : 9)) + 2) / 5 + data->dia - 1;
+    int diaEra = anoEra * 365 + anoEra / 4 - anoEra / 100 + diaAno;
+    long dias = (long)era * 146097 + diaEra - 719468;
+
+    return dias * 1440.0 + data->hora * 60 + data->min + data->seg / 60.0;
+}
+
 /**
  * @brief Devolve o hash de uma string
  * 
@@ -100,6 +100,40 @@ int validarMatricula(const char *matricula)
     return 0;
 }
 
+/**
+ * @brief Codifica uma matrícula num inteiro
+ * 
+ * @param matricula Matrícula
+ * @return uint32_t Código da matrícula ou 0 se inválida
+ * 
+ * @note Os hífens são ignorados e as letras convertidas para maiúsculas ("aa-00-bb" e "AA-00-BB" têm o mesmo código)
+ * @note Cada caracter é um dígito de base 37 (algarismos 1-10, letras 11-36): 37^6 cabe em 32 bits
+ * @note A ordem dos códigos é a mesma da comparação sem distinção de maiúsculas/minúsculas das matrículas
+ */
+uint32_t codificarMatricula(const char *matricula) {
+    if (!matricula || !validarMatricula(matricula)) return 0;
+
+    uint32_t codigo = 0;
+    for (int i = 0; i < MAX_MATRICULA; i++) {
+        unsigned char c = (unsigned char)matricula[i];
+        if (c == '-') continue;
+
+        if (c >= '0' && c <= '9') {
+            codigo = codigo * 37 + (c - '0' + 1);
+        }
+        else if (c >= 'a' && c <= 'z') {
+            codigo = codigo * 37 + (c - 'a' + 11);
+        }
+        else if (c >= 'A' && c <= 'Z') {
+            codigo = codigo * 37 + (c - 'A' + 11);
+        }
+        else {
+            return 0; // Letras fora do ASCII
+        }
+    }
+    return codigo;
+}
+
 /**
  * @brief Valida a marca do veículo
  * 
@@ -0,0 +1,238 @@
+/* Testes das estruturas e da leitura dos .txt: correr a partir da raiz do repositório (usa os ficheiros em Dados/).
+   Devolve 0 se todos os testes passarem */
+
+#include "structsGenericas.h"
+#include "validacoes.h"
+#include "bdados.h"
+#include "dados.h"
+#include "registoLogs.h"
+#include "uteis.h"
+
+#define PASSAGENS_TESTE "testes_passagens.txt"
+#define LOGS_TESTE "testes_logs.txt"
+
+static int falhas = 0;
+
+// Regista uma falha (com o ficheiro e a linha) sem interromper os restantes testes
+#define VERIFICAR(condicao) \
+    do { \
+        if (!(condicao)) { \
+            printf("\tFALHOU (%s:%d): %s\n", __FILE__, __LINE__, #condicao); \
+            falhas++; \
+        } \
+    } while (0)
+
+// Funções do dicionário de teste: os elementos são ints e a chave é o próprio valor (inline)
+
+static void *criarChaveInt(void *obj) {
+    return obj;
+}
+
+static int hashChaveInt(void *chave) {
+    return (int)((unsigned int)*(int *)chave & 0x7fffffff);
+}
+
+static int compChaveInt(void *chave, void *chave2) {
+    return *(int *)chave != *(int *)chave2;
+}
+
+/**
+ * @brief Inserção, remoção e crescimento de um dicionário, com chaves únicas e com listas por chave
+ */
+static void testarDict() {
+    printf("Dicionário: inserir, remover e crescer\n");
+
+    int n = 20000;
+    int *valores = (int *)malloc(n * sizeof(int));
+    Dict *unico = criarDict(DICT_CHAVE_UNICA, sizeof(int));
+    VERIFICAR(valores && unico);
+    if (!valores || !unico) return;
+
+    int capacidadeInicial = unico->capacidade;
+    int inseridos = 0;
+    for (int i = 0; i < n; i++) {
+        valores[i] = i * 7919; // Chaves espalhadas, com colisões na tabela
+        inseridos += appendToDict(unico, &valores[i], compChaveInt, criarChaveInt, hashChaveInt, NULL, NULL);
+    }
+    VERIFICAR(inseridos == n);
+    VERIFICAR(unico->nelDict == n);
+    VERIFICAR(unico->capacidade > capacidadeInicial);
+    VERIFICAR(!appendToDict(unico, &valores[0], compChaveInt, criarChaveInt, hashChaveInt, NULL, NULL)); // Repetida
+
+    // Remover as chaves pares: as ímpares continuam a ser encontradas (o deslocamento para trás não parte as sondagens)
+    for (int i = 0; i < n; i += 2) {
+        VERIFICAR(removeFromDict(unico, &valores[i], compChaveInt, criarChaveInt, hashChaveInt, NULL));
+    }
+    VERIFICAR(!removeFromDict(unico, &valores[0], compChaveInt, criarChaveInt, hashChaveInt, NULL)); // Já removida
+    VERIFICAR(unico->nelDict == n / 2);
+    int errados = 0;
+    for (int i = 0; i < n; i++) {
+        void *obj = searchDict(unico, &valores[i], compChaveInt, compChaveInt, hashChaveInt);
+        if ((i % 2 == 0) != (obj == NULL)) errados++;
+    }
+    VERIFICAR(errados == 0);
+
+    // Voltar a inserir as removidas
+    for (int i = 0; i < n; i += 2) {
+        VERIFICAR(appendToDict(unico, &valores[i], compChaveInt, criarChaveInt, hashChaveInt, NULL, NULL));
+    }
+    VERIFICAR(unico->nelDict == n);
+    freeDict(unico, NULL, NULL);
+
+    // Com listas: a chave só desaparece quando a lista fica vazia
+    Dict *multiplo = criarDict(DICT_MULTIPLO, sizeof(int));
+    VERIFICAR(multiplo != NULL);
+    if (multiplo) {
+        int a = 5, b = 5;
+        VERIFICAR(appendToDict(multiplo, &a, compChaveInt, criarChaveInt, hashChaveInt, NULL, NULL));
+        VERIFICAR(appendToDict(multiplo, &b, compChaveInt, criarChaveInt, hashChaveInt, NULL, NULL));
+        VERIFICAR(multiplo->nelDict == 1);
+        Lista *li = obterListaDoDict(multiplo, &a, compChaveInt, hashChaveInt);
+        VERIFICAR(li && li->nel == 2);
+        VERIFICAR(removeFromDict(multiplo, &a, compChaveInt, criarChaveInt, hashChaveInt, NULL));
+        VERIFICAR(multiplo->nelDict == 1);
+        VERIFICAR(removeFromDict(multiplo, &b, compChaveInt, criarChaveInt, hashChaveInt, NULL));
+        VERIFICAR(multiplo->nelDict == 0);
+        VERIFICAR(obterListaDoDict(multiplo, &a, compChaveInt, hashChaveInt) == NULL);
+        freeDict(multiplo, NULL, NULL);
+    }
+    free(valores);
+}
+
+/**
+ * @brief Ordem de um ranking numérico com empates, sem limite e com Top-K
+ */
+static void testarRankingEmpates() {
+    printf("Ranking: ordem decrescente, empates pela ordem de inserção\n");
+
+    // Pontuações e a ordem esperada dos índices (os empates ficam pela ordem em que foram inseridos)
+    int pontos[] = {10, 30, 20, 30, 10, 30, -5, 20};
+    int esperado[] = {1, 3, 5, 2, 7, 0, 4, 6};
+    int n = (int)(sizeof(pontos) / sizeof(pontos[0]));
+    int ids[8];
+
+    RankingNumerico *r = criarRankingNumerico(RANKING_INT);
+    VERIFICAR(r != NULL);
+    if (!r) return;
+    for (int i = 0; i < n; i++) {
+        ids[i] = i;
+        VERIFICAR(addToRankingInt(r, &ids[i], pontos[i]));
+    }
+    VERIFICAR(ordenarRankingNumerico(r));
+    VERIFICAR(r->nel == n);
+    for (int i = 0; i < n && i < r->nel; i++) {
+        VERIFICAR(*(int *)r->entradas[i].mainInfo == esperado[i]);
+    }
+    freeRankingNumerico(r);
+
+    // Top-3: as mesmas três primeiras posições
+    r = criarRankingTopK(RANKING_INT, 3, NULL, NULL);
+    VERIFICAR(r != NULL);
+    if (!r) return;
+    for (int i = 0; i < n; i++) {
+        VERIFICAR(addToRankingInt(r, &ids[i], pontos[i]));
+    }
+    VERIFICAR(ordenarRankingNumerico(r));
+    VERIFICAR(r->nel == 3);
+    for (int i = 0; i < 3 && i < r->nel; i++) {
+        VERIFICAR(*(int *)r->entradas[i].mainInfo == esperado[i]);
+    }
+    freeRankingNumerico(r);
+}
+
+/**
+ * @brief Codificação das matrículas
+ */
+static void testarCodificarMatricula() {
+    printf("Matrículas: codificação\n");
+
+    VERIFICAR(codificarMatricula("AA-00-BB") != 0);
+    VERIFICAR(codificarMatricula("aa-00-bb") == codificarMatricula("AA-00-BB")); // Sem distinção de maiúsculas
+    VERIFICAR(codificarMatricula("AA-00-BB") != codificarMatricula("AA-00-BC"));
+    VERIFICAR(codificarMatricula("00-AA-00") != codificarMatricula("AA-00-00"));
+    // A ordem dos códigos é a ordem das matrículas
+    VERIFICAR(codificarMatricula("00-00-AA") < codificarMatricula("00-00-AB"));
+    VERIFICAR(codificarMatricula("09-ZZ-99") < codificarMatricula("10-AA-00"));
+    VERIFICAR(codificarMatricula("99-99-ZZ") < codificarMatricula("AA-00-00"));
+}
+
+/**
+ * @brief Acrescenta texto a um ficheiro
+ *
+ * @param nome Nome do ficheiro
+ * @param texto Texto
+ * @param modo "w" ou "a"
+ */
+static void escreverFicheiro(const char *nome, const char *texto, const char *modo) {
+    FILE *file = fopen(nome, modo);
+    if (!file) return;
+    fputs(texto, file);
+    fclose(file);
+}
+
+/**
+ * @brief A última linha das passagens, ainda sem '\n', só é lida quando fica completa
+ */
+static void testarRetomaLinhaParcial() {
+    printf("Passagens: retomar a partir de uma linha incompleta\n");
+
+    const char *primeira = "1\t2202\t26-04-2020 10:00:00.000\t0\n";
+    escreverFicheiro(PASSAGENS_TESTE, primeira, "w");
+    escreverFicheiro(PASSAGENS_TESTE, "2\t2202\t26-04-2020 10:10", "a"); // A ser escrita
+
+    Bdados *bd = (Bdados *)malloc(sizeof(Bdados));
+    VERIFICAR(bd != NULL);
+    if (!bd) return;
+    inicializarBD(bd);
+    int carregou = carregarDadosTxt(bd, "Dados/donos.txt", "Dados/carros.txt", "Dados/sensores.txt", "Dados/distancias.txt", PASSAGENS_TESTE, LOGS_TESTE);
+    VERIFICAR(carregou);
+    if (!carregou) {
+        remove(PASSAGENS_TESTE);
+        return;
+    }
+
+    // Só a linha completa foi lida, a entrada fica à espera da saída
+    VERIFICAR(bd->viagens->nel == 0);
+    VERIFICAR(bd->seguimento != NULL);
+    if (bd->seguimento) {
+        VERIFICAR(bd->seguimento->posicao == (long)strlen(primeira));
+        VERIFICAR(bd->seguimento->nLinhas == 1);
+    }
+
+    FILE *ficheiroLogs = fopen(LOGS_TESTE, "a");
+    RegistoLogs *logs = ficheiroLogs ? criarRegistoLogs(ficheiroLogs, 0, 0) : NULL;
+
+    // Ainda incompleta: nada de novo
+    VERIFICAR(lerNovasPassagens(bd->seguimento, bd, logs) == 0);
+
+    // Completa: forma a viagem com a entrada guardada
+    escreverFicheiro(PASSAGENS_TESTE, ":00.000\t1\n", "a");
+    int lidas = lerNovasPassagens(bd->seguimento, bd, logs);
+    VERIFICAR(lidas == 1);
+    VERIFICAR(bd->viagens->nel == 1);
+    if (bd->seguimento) {
+        VERIFICAR(bd->seguimento->nLinhas == 2);
+    }
+
+    fecharRegistoLogs(logs);
+    if (ficheiroLogs) fclose(ficheiroLogs);
+    freeTudo(bd);
+    remove(PASSAGENS_TESTE);
+    remove(LOGS_TESTE);
+}
+
+int main() {
+    data_atual();
+
+    testarDict();
+    testarRankingEmpates();
+    testarCodificarMatricula();
+    testarRetomaLinhaParcial();
+
+    if (falhas) {
+        printf("\n%d verificação(ões) falharam\n", falhas);
+        return EXIT_FAILURE;
+    }
+    printf("\nTodos os testes passaram\n");
+    return EXIT_SUCCESS;
+}